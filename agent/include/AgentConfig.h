@@ -0,0 +1,89 @@
+#ifndef AGENT_CONFIG_H
+#define AGENT_CONFIG_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <cstdint>
+#include "AnomalyDetector.h"
+#include "PortBitmap.h"
+
+struct SinkRoute {
+    std::string sink;
+    uint32_t types;         // Mask from EventSink::parseTypes
+    int stats_interval;     // Seconds, 0 = every cycle
+};
+
+// Everything the agent can change without a restart. Instances are never
+// modified once published; a reload builds a new one.
+struct AgentConfig {
+    uint64_t version = 0;               // 0 = built-in defaults
+    DetectorThresholds thresholds;
+    int monitor_interval_ms = 1000;
+    bool process_io_uring = false;      // Batched /proc/<pid>/stat reads
+    size_t thread_top_processes = 0;    // Busiest processes broken down by thread, 0 = off
+    size_t thread_budget = 256;         // Threads read per scan across them
+    double cpu_budget_percent = 1.0;    // Of one core, 0 = unlimited
+    long memory_budget_mb = 50;         // 0 = unlimited
+    std::vector<int> cpu_affinity;      // Empty = not pinned; applied at startup only
+    int nice_level = 0;                 // Applied at startup only
+    std::vector<SinkRoute> routes;
+    std::vector<std::string> known_processes;   // Sorted and unique
+    std::vector<std::string> watch_processes;   // Sorted and unique
+    PortBitmap suspicious_ports;
+
+    AgentConfig();
+
+    const SinkRoute* route(const std::string& sink) const;
+
+    // Parses a "key = value" file over the defaults. On any error the
+    // message names the line and false is returned.
+    static bool parse(const std::string& path, AgentConfig& config, std::string& error);
+};
+
+// Owns the current AgentConfig and swaps in a new one on SIGHUP. The
+// parse happens on a side thread; the collection loop only does an atomic
+// load per cycle. The loop is the only reader, so configurations it has
+// moved past are freed when it calls reclaim().
+class ConfigManager {
+private:
+    std::string path;
+    std::atomic<const AgentConfig*> active;
+    std::atomic<uint64_t> next_version;
+    std::atomic<uint64_t> failed_reloads;
+
+    std::mutex retired_mutex;
+    std::vector<const AgentConfig*> retired;
+    std::atomic<bool> has_retired;
+
+    std::thread watcher;
+    std::atomic<bool> stopping;
+
+    bool reload();
+    void watch();
+
+public:
+    explicit ConfigManager(const std::string& path);
+    ~ConfigManager();
+
+    // Must run before any other thread starts, so that SIGHUP is only
+    // ever taken by the watcher
+    static void blockReloadSignal();
+
+    // Synchronous first load; a missing file leaves the defaults in place
+    bool load();
+
+    bool start();
+    void stop();
+
+    // Valid until the next reclaim() by the same thread
+    const AgentConfig& current() const;
+    void reclaim();
+
+    uint64_t failedReloads() const;
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef ALERT_MANAGER_H
+#define ALERT_MANAGER_H
+
+#include <vector>
+#include <unordered_map>
+#include <string>
+#include <ctime>
+
+class StateWriter;
+class StateReader;
+
+struct AnomalyAlert {
+    std::string type;
+    std::string severity;
+    std::string message;
+    std::string details;
+    std::string timestamp;
+    std::string entity;           // What the alert is about (pid, port, "system", ...)
+    int pid = 0;                  // Process the alert is about, 0 if none
+    std::string state = "OPEN";   // OPEN, ONGOING or RESOLVED once tracked
+    int occurrences = 1;          // Observations aggregated into this notification
+};
+
+struct AlertPolicy {
+    int renotify_interval;  // Seconds between ONGOING notifications, 0 = never
+    int resolve_after;      // Seconds without an observation before RESOLVED
+    int max_per_minute;     // Notifications per type per minute, 0 = unlimited
+};
+
+// Deduplicates alerts by (type, entity) and tracks each through an
+// open -> ongoing -> resolved lifecycle. Detectors report every condition
+// they see each cycle; only lifecycle transitions come back out.
+class AlertManager {
+private:
+    struct TrackedAlert {
+        AnomalyAlert alert;
+        time_t first_seen;
+        time_t last_seen;
+        time_t last_notified;   // 0 until the OPEN notification goes out
+        int occurrences;        // Observations since the alert opened
+        int unreported;         // Observations since the last notification
+        bool observed_this_cycle;
+    };
+
+    struct RateWindow {
+        time_t window_start;
+        int sent;
+        int suppressed;
+    };
+
+    std::unordered_map<std::string, TrackedAlert> tracked;
+    std::unordered_map<std::string, AlertPolicy> policies;
+    std::unordered_map<std::string, RateWindow> rate_windows;
+    AlertPolicy default_policy;
+    long total_suppressed;
+
+    static std::string makeKey(const std::string& type, const std::string& entity);
+    const AlertPolicy& policyFor(const std::string& type) const;
+    bool allowNotification(const std::string& type, time_t now);
+    AnomalyAlert makeNotification(const TrackedAlert& entry, const std::string& state, time_t now) const;
+
+public:
+    AlertManager();
+    ~AlertManager();
+
+    void observe(const AnomalyAlert& alert, time_t now);
+    std::vector<AnomalyAlert> collectTransitions(time_t now);
+
+    bool isActive(const std::string& type, const std::string& entity) const;
+    size_t activeCount() const;
+    long suppressedCount() const;
+
+    void setPolicy(const std::string& type, const AlertPolicy& policy);
+    void setDefaultPolicy(const AlertPolicy& policy);
+
+    // Checkpoint of the tracked alerts for warm restarts; times are wall
+    // clock, so alerts that went quiet during the downtime resolve normally
+    void saveState(StateWriter& out) const;
+    bool loadState(StateReader& in);
+};
+
+#endif
@@ -6,13 +6,41 @@
 #include <string>
 #include "ProcessMonitor.h"
 #include "NetworkMonitor.h"
+#include "SocketStatsCollector.h"
+#include "InterfaceMonitor.h"
+#include "DiskMonitor.h"
+#include "CgroupMonitor.h"
+#include "ProcessTree.h"
+#include "PortBitmap.h"
+#include "PatternMatcher.h"
+#include "AlertManager.h"
+#include "ProcessBaselines.h"
+#include "FrequencySketch.h"
+#include "RateCounter.h"
 
-struct AnomalyAlert {
-    std::string type;
-    std::string severity;
-    std::string message;
-    std::string details;
-    std::string timestamp;
+class StateWriter;
+class StateReader;
+
+// Detection thresholds, replaceable at runtime without losing baselines
+struct DetectorThresholds {
+    double high_cpu_threshold = 80.0;
+    long high_memory_threshold = 1024 * 1024; // 1GB in KB
+    int max_new_processes_per_minute = 10;
+    int max_new_connections_per_minute = 50;
+    unsigned int max_retransmits_per_socket = 50; // Per collection interval
+    unsigned int max_retransmits_total = 500;
+    double interface_saturation_threshold = 90.0; // % of link speed
+    double max_interface_drops_per_second = 100.0;
+    double disk_full_threshold = 90.0;      // % of space or inodes used
+    double io_saturation_threshold = 90.0;  // % of time the device was busy
+    double cgroup_memory_threshold = 90.0;  // % of memory.max
+    double cgroup_throttle_threshold = 25.0; // % of the interval throttled
+    double high_thread_cpu_threshold = 90.0; // % of one CPU
+    double hysteresis_ratio = 0.9;
+    double deviation_threshold = 4.0;
+    double max_process_io_rate = 50.0 * 1024 * 1024;
+    double max_run_delay_ms = 500.0;
+    uint32_t rare_process_threshold = 5;
 };
 
 class AnomalyDetector {
@@ -22,24 +50,58 @@ private:
     long high_memory_threshold;
     int max_new_processes_per_minute;
     int max_new_connections_per_minute;
+    unsigned int max_retransmits_per_socket; // Per collection interval
+    unsigned int max_retransmits_total;
+    double interface_saturation_threshold; // % of link speed
+    double max_interface_drops_per_second;
+    double disk_full_threshold;     // % of space or inodes used
+    double io_saturation_threshold; // % of time the device was busy
+    double cgroup_memory_threshold; // % of memory.max
+    double cgroup_throttle_threshold; // % of the interval throttled
+    double high_thread_cpu_threshold; // % of one CPU
+    double hysteresis_ratio; // Open alerts clear only below threshold * ratio
+    double deviation_threshold; // Standard deviations above a process baseline
+    double max_process_io_rate; // Bytes per second, read + write
+    double max_run_delay_ms;    // Run-queue wait per second of wall time
     
     // Historical data for baseline comparison
     std::vector<double> cpu_history;
     std::vector<long> memory_history;
-    std::unordered_map<std::string, int> known_processes;
+    ProcessBaselines process_baselines;
+    FrequencySketch process_frequency; // Recent sightings per process name
+    std::vector<std::string> whitelisted_processes; // Sorted, from loadKnownProcesses
+    uint32_t rare_process_threshold; // Names seen this often or less are unknown
+    uint64_t sketch_aging_cycles;
+    uint64_t learning_cycles;
     std::unordered_map<int, int> port_usage_history;
     
-    // Counters for rate-based detection
-    int new_processes_count;
-    int new_connections_count;
-    time_t last_reset_time;
+    // Precompiled lookup tables
+    PortBitmap suspicious_ports;
+    PatternMatcher system_process_patterns;
+    
+    // Deduplication and lifecycle tracking of raised alerts
+    AlertManager alert_manager;
+    
+    // Rolling one-minute counters for rate-based detection
+    SlidingWindowCounter process_spawn_rate;
+    SlidingWindowCounter connection_rate;
+    KeyedRateCounter spawns_per_parent;
+    KeyedRateCounter connections_per_remote;
+    static constexpr size_t MAX_HOT_ENTITIES = 64;
+    static constexpr size_t MAX_LINEAGE_DEPTH = 6; // Ancestors searched for a server process
+    std::vector<std::string> hot_parents;   // Entities currently over their rate limit
+    std::vector<std::string> hot_remotes;
     
-    bool isUnknownProcess(const ProcessInfo& process);
+    bool isUnknownProcess(const ProcessInfo& process, uint32_t sightings);
     bool isSuspiciousPort(int port);
     bool isRapidMemoryIncrease(long current_memory);
     bool isRapidCpuSpike(double current_cpu);
-    void updateBaselines(const std::vector<ProcessInfo>& processes);
-    void resetCounters();
+    void updateBaselines();
+    bool exceeds(double value, double threshold, const std::string& type, const std::string& entity) const;
+    bool isCpuDeviation(const BaselineDeviation& baseline, double cpu_usage, const std::string& entity) const;
+    bool isMemoryDeviation(const BaselineDeviation& baseline, long memory_usage, const std::string& entity) const;
+    static void markHot(std::vector<std::string>& hot, const std::string& key);
+    void trackAlerts(const std::vector<AnomalyAlert>& alerts);
 
 public:
     AnomalyDetector();
@@ -48,9 +110,47 @@ public:
     std::vector<AnomalyAlert> checkProcessAnomalies(const std::vector<ProcessInfo>& processes);
     std::vector<AnomalyAlert> checkNetworkAnomalies(const std::vector<NetworkConnection>& connections);
     std::vector<AnomalyAlert> checkSystemAnomalies(double cpu_usage, long memory_usage);
+    std::vector<AnomalyAlert> checkSocketAnomalies(const std::vector<SocketStats>& sockets);
+    std::vector<AnomalyAlert> checkInterfaceAnomalies(const std::vector<InterfaceStats>& interfaces);
+    std::vector<AnomalyAlert> checkDiskAnomalies(const std::vector<DiskDeviceStats>& devices,
+                                                 const std::vector<MountUsage>& mounts);
+    std::vector<AnomalyAlert> checkCgroupAnomalies(const std::vector<CgroupStats>& cgroups);
+    
+    // A single thread pinning a core, which a process-wide average hides
+    std::vector<AnomalyAlert> checkThreadAnomalies(const std::vector<ThreadInfo>& threads);
+    
+    // New shells whose ancestry includes a network-facing server process
+    std::vector<AnomalyAlert> checkProcessLineage(const std::vector<ProcessInfo>& new_processes,
+                                                  const ProcessTree& tree);
+    
+    // Rate checks fed with this cycle's deltas, not the full current lists
+    std::vector<AnomalyAlert> checkProcessCreationRate(const std::vector<ProcessInfo>& new_processes);
+    std::vector<AnomalyAlert> checkConnectionRate(const std::vector<NetworkConnection>& new_connections);
+    
+    // Lifecycle transitions (OPEN/ONGOING/RESOLVED) since the last call;
+    // call once per cycle after all checks have run
+    std::vector<AnomalyAlert> collectAlertTransitions();
+    void setAlertPolicy(const std::string& type, const AlertPolicy& policy);
+    long suppressedAlerts() const;     // Observations held back by rate limits
     
     void updateConfiguration(double cpu_thresh, long mem_thresh, int proc_rate, int conn_rate);
+    void updateConfiguration(const DetectorThresholds& thresholds);
     void loadKnownProcesses(const std::string& whitelist_file);
+    bool loadSuspiciousPorts(const std::string& port_file);
+    
+    // Replace the lists outright; names must be sorted and unique
+    void setKnownProcesses(const std::vector<std::string>& names);
+    void setSuspiciousPorts(const PortBitmap& ports);
+    
+    static const PortBitmap& defaultSuspiciousPorts();
+    
+    // Append a whitelist file's names to names, keeping it sorted and unique
+    static bool readKnownProcesses(const std::string& whitelist_file, std::vector<std::string>& names);
+    
+    // Checkpoint of everything learned (history, baselines, sightings,
+    // tracked alerts) for warm restarts; thresholds come from the config
+    void saveState(StateWriter& out) const;
+    bool loadState(StateReader& in);
 };
 
 #endif
\ No newline at end of file
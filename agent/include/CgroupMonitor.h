@@ -0,0 +1,77 @@
+#ifndef CGROUP_MONITOR_H
+#define CGROUP_MONITOR_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <chrono>
+#include "ProcessMonitor.h"
+
+struct CgroupStats {
+    std::string path;               // Relative to the cgroup2 mount, e.g. "/system.slice/docker-<id>.scope"
+    std::string container_id;       // Empty when the path doesn't name a container
+    double cpu_usage;               // % of one CPU over the last interval
+    double throttled_percent;       // % of the interval spent throttled by cpu.max
+    uint64_t memory_current;        // Bytes
+    uint64_t memory_limit;          // Bytes, 0 when unlimited
+    uint64_t memory_anon;
+    uint64_t memory_file;
+    double io_read_bytes_rate;
+    double io_write_bytes_rate;
+    uint64_t pids_current;
+
+    // Filled by attributeProcesses from a ProcessMonitor snapshot
+    int process_count;
+    std::string top_process;        // Busiest member by CPU
+};
+
+// Per-cgroup resource usage from the cgroup v2 hierarchy. Directory fds are
+// kept open between cycles so each cycle is a handful of openat() reads per
+// group; the tree is only re-walked when inotify reports a cgroup being
+// created or removed.
+class CgroupMonitor {
+private:
+    static constexpr int MAX_DEPTH = 6;
+    static constexpr size_t MAX_GROUPS = 512;   // Each holds a directory fd
+
+    struct CgroupEntry {
+        std::string path;
+        std::string container_id;
+        int dir_fd;
+        uint64_t usage_usec;
+        uint64_t throttled_usec;
+        uint64_t io_read_bytes;
+        uint64_t io_write_bytes;
+        bool has_previous;
+    };
+
+    std::string mount_point;
+    std::vector<CgroupEntry> groups;
+    int inotify_fd;
+    bool needs_walk;
+    bool truncated;         // The last walk stopped at MAX_GROUPS
+    bool limit_reported;
+    std::vector<char> read_buffer;
+    std::chrono::steady_clock::time_point last_collection;
+
+    static std::string findMountPoint();
+    bool hierarchyChanged();
+    void walk();
+    void walkDirectory(int dir_fd, const std::string& path, int depth, std::vector<CgroupEntry>& found);
+    void closeGroups(std::vector<CgroupEntry>& entries);
+
+public:
+    CgroupMonitor();
+    ~CgroupMonitor();
+
+    // Fill stats for every non-root cgroup; false without a cgroup2 mount
+    bool collect(std::vector<CgroupStats>& stats);
+
+    // Count snapshot processes per cgroup using ProcessInfo::cgroup
+    static void attributeProcesses(const std::vector<ProcessInfo>& processes, std::vector<CgroupStats>& stats);
+
+    // Container id from a docker/containerd/cri-o/podman scope name, else empty
+    static std::string containerId(const std::string& path);
+};
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef DISK_MONITOR_H
+#define DISK_MONITOR_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <chrono>
+
+struct DiskDeviceStats {
+    std::string name;
+    double read_iops;
+    double write_iops;
+    double read_bytes_rate;
+    double write_bytes_rate;
+    double utilization;     // % of the interval the device was busy
+    double await_ms;        // Mean time per completed I/O, queueing included
+    unsigned long ios_in_progress;
+};
+
+struct MountUsage {
+    std::string mount_point;
+    std::string device;
+    std::string fs_type;
+    uint64_t total_bytes;
+    uint64_t used_bytes;
+    uint64_t available_bytes;
+    double usage_percent;
+    uint64_t total_inodes;
+    uint64_t used_inodes;
+    double inode_usage_percent;
+};
+
+// Block device I/O from /proc/diskstats and per-filesystem space and inode
+// usage via statvfs. The mount list comes from /proc/self/mountinfo and is
+// cached until the kernel signals a change on it, so steady-state cycles
+// only pay for one statvfs per real filesystem.
+class DiskMonitor {
+private:
+    static constexpr size_t NAME_SIZE = 32;
+
+    // Raw /proc/diskstats counters for delta computation
+    struct DeviceCounters {
+        char name[NAME_SIZE];
+        uint64_t reads;
+        uint64_t read_sectors;
+        uint64_t read_ms;
+        uint64_t writes;
+        uint64_t write_sectors;
+        uint64_t write_ms;
+        uint64_t io_ticks;
+        bool tracked;   // Whole disk rather than a partition or loop device
+        bool seen;
+    };
+
+    struct MountEntry {
+        std::string mount_point;
+        std::string device;
+        std::string fs_type;
+    };
+
+    std::vector<char> read_buffer;
+    std::vector<DeviceCounters> device_counters;
+    std::vector<MountEntry> mounts;
+    int mountinfo_fd;
+    bool mounts_valid;
+    std::chrono::steady_clock::time_point last_collection;
+    bool has_previous;
+
+    bool mountsChanged();
+    void loadMounts();
+    static bool isTrackedDevice(const char* name, size_t length);
+
+public:
+    DiskMonitor();
+    ~DiskMonitor();
+
+    bool collectDevices(std::vector<DiskDeviceStats>& devices);
+    bool collectMounts(std::vector<MountUsage>& usage);
+};
+
+#endif
@@ -6,6 +6,9 @@
 #include <sqlite3.h>
 #include "ProcessMonitor.h"
 #include "NetworkMonitor.h"
+#include "InterfaceMonitor.h"
+#include "CgroupMonitor.h"
+#include "EventTime.h"
 
 enum class LogLevel {
     INFO,
@@ -19,7 +22,11 @@ enum class EventType {
     PROCESS_TERMINATED,
     NETWORK_CONNECTION,
     ANOMALY_DETECTED,
-    SYSTEM_STATS
+    SYSTEM_STATS,
+    INTERFACE_STATS,
+    PROCESS_IO,
+    CGROUP_STATS,
+    THREAD_STATS
 };
 
 struct SystemStats {
@@ -37,19 +44,34 @@ private:
     std::string db_path;
     std::string json_path;
     
+    // Rows carry the observation time, in UTC like SQLite's CURRENT_TIMESTAMP
+    TimestampFormatter row_formatter;
+    TimestampFormatter json_formatter;
+    char row_time[TimestampFormatter::BUFFER_SIZE];
+    
     bool initializeDatabase();
-    void logToJson(const std::string& event_type, const std::string& data);
+    void logToJson(const std::string& event_type, const std::string& data, int64_t time_ns);
+    const char* formatRowTime(int64_t time_ns);
     std::string getCurrentTimestamp();
 
 public:
     EventLogger(const std::string& db_file, const std::string& json_file);
     ~EventLogger();
     
-    void logProcess(const ProcessInfo& process);
-    void logNetworkConnection(const NetworkConnection& connection);
+    // time_ns is the event's EventClock time
+    void logProcess(const ProcessInfo& process, int64_t time_ns);
+    void logProcessIo(const ProcessInfo& process, int64_t time_ns);
+    void logNetworkConnection(const NetworkConnection& connection, int64_t time_ns);
     void logAlert(const std::string& type, const std::string& severity, 
-                  const std::string& message, const std::string& details);
-    void logSystemStats(const SystemStats& stats);
+                  const std::string& message, const std::string& details, int64_t time_ns);
+    void logSystemStats(const SystemStats& stats, int64_t time_ns);
+    void logInterfaceStats(const InterfaceStats& stats, int64_t time_ns);
+    void logCgroupStats(const CgroupStats& stats, int64_t time_ns);
+    void logThreadStats(const ThreadInfo& thread, int64_t time_ns);
+    
+    // Group the inserts between these into one transaction
+    void beginBatch();
+    void commitBatch();
     
     // Utility functions
     SystemStats getSystemStats();
@@ -0,0 +1,55 @@
+#ifndef EVENT_PUBLISHER_H
+#define EVENT_PUBLISHER_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Streams agent events to local subscribers (the API server) over a Unix
+// socket. Each event is one frame: a 4-byte big-endian length followed by a
+// JSON object {"type":...,"time_ns":...,"data":...}. Events are batched per
+// cycle and every batch ends with a "cycle" frame. Subscribers that fall
+// behind lose whole batches rather than stalling the agent; the loss is
+// reported to them in a "dropped" frame once they catch up.
+class EventPublisher {
+private:
+    static constexpr size_t MAX_SUBSCRIBERS = 16;
+    static constexpr size_t MAX_BUFFERED_BYTES = 1024 * 1024;  // Unsent data per subscriber
+
+    struct Subscriber {
+        int fd;
+        std::string pending;
+        size_t sent;                // Bytes of pending already written
+        uint64_t dropped_events;    // Totals since the subscriber connected
+        uint64_t dropped_batches;
+        bool report_drops;          // A "dropped" frame is owed
+    };
+
+    std::string socket_path;
+    int listen_fd;
+    std::vector<Subscriber> subscribers;
+    std::string batch;
+    size_t batch_events;
+    uint64_t sequence;
+
+    void appendFrame(std::string& out, const std::string& type, const std::string& data, int64_t time_ns);
+    void acceptSubscribers();
+    bool writePending(Subscriber& subscriber);  // False once the subscriber is gone
+
+public:
+    EventPublisher();
+    ~EventPublisher();
+
+    bool listen(const std::string& path);
+
+    // Queue one event for this cycle's batch; data is a JSON object and
+    // time_ns the event's EventClock time
+    void publish(const std::string& type, const std::string& data, int64_t time_ns);
+
+    // Hand this cycle's batch to every subscriber; call once per cycle
+    void flush();
+
+    size_t subscriberCount() const;
+};
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef EVENT_ROUTER_H
+#define EVENT_ROUTER_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include "EventSink.h"
+
+struct SinkStatus {
+    std::string name;
+    uint64_t delivered;     // Events handed to the sink
+    uint64_t dropped;       // Events discarded because its queue was full
+    size_t queued;
+};
+
+// Fans each cycle's events out to the registered sinks. Every sink has its
+// own bounded queue and worker thread: collection only ever appends to the
+// queues, and a sink that cannot keep up loses events from its own queue
+// without delaying the other sinks or the next cycle.
+class EventRouter {
+private:
+    static constexpr size_t MAX_QUEUED_EVENTS = 10000;  // Per sink
+
+    struct Route {
+        std::unique_ptr<EventSink> sink;
+        uint32_t types;
+        int stats_interval;         // Seconds between stats deliveries, 0 = every cycle
+        std::chrono::steady_clock::time_point last_stats;
+        bool stats_sent;
+
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::vector<std::shared_ptr<const AgentEvent>> queue;
+        size_t cycles;              // Flushes the worker hasn't picked up
+        bool stopping;
+        std::atomic<uint64_t> delivered;
+        std::atomic<uint64_t> dropped;
+        std::thread worker;
+    };
+
+    std::vector<std::unique_ptr<Route>> routes;
+    std::vector<std::shared_ptr<const AgentEvent>> batch;
+
+    static void run(Route& route);
+
+public:
+    EventRouter();
+    ~EventRouter();
+
+    // types is a mask from EventSink::parseTypes; stats events reach the
+    // sink at most once per stats_interval seconds
+    void addSink(std::unique_ptr<EventSink> sink, uint32_t types, int stats_interval);
+
+    // Change a sink's routing by name; false if there is no such sink
+    bool setRoute(const std::string& name, uint32_t types, int stats_interval);
+
+    void publish(AgentEvent event);
+
+    // Hand one event to the sinks' queues right away instead of with the
+    // cycle's flush(). Safe from any thread, for events that shouldn't wait
+    // out the collection interval; not for stats.
+    void deliver(AgentEvent event);
+
+    // Hand this cycle's events to the sinks' queues; call once per cycle
+    void flush();
+
+    // Deliver what is still queued and stop the workers
+    void stop();
+
+    std::vector<SinkStatus> status();
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef EVENT_SINK_H
+#define EVENT_SINK_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include "ProcessMonitor.h"
+#include "NetworkMonitor.h"
+#include "InterfaceMonitor.h"
+#include "CgroupMonitor.h"
+#include "AlertManager.h"
+#include "EventLogger.h"
+
+// One observation from a collection cycle. Only the member matching type
+// is meaningful.
+struct AgentEvent {
+    EventType type;
+    int64_t time_ns = 0;                // EventClock time, stamped when published
+    ProcessInfo process{};              // PROCESS_STARTED, PROCESS_IO
+    int pid = 0;                        // PROCESS_TERMINATED
+    NetworkConnection connection{};     // NETWORK_CONNECTION
+    AnomalyAlert alert{};               // ANOMALY_DETECTED
+    SystemStats system{};               // SYSTEM_STATS
+    InterfaceStats interface_stats{};   // INTERFACE_STATS
+    CgroupStats cgroup{};               // CGROUP_STATS
+    ThreadInfo thread{};                // THREAD_STATS
+};
+
+// An output for agent events. EventRouter calls write() from the sink's own
+// thread with everything queued since the previous call, so a sink that
+// falls behind simply receives larger batches.
+class EventSink {
+public:
+    static constexpr int TYPE_COUNT = 9;
+
+    virtual ~EventSink() {}
+
+    virtual const char* name() const = 0;
+    virtual void write(const std::vector<std::shared_ptr<const AgentEvent>>& batch) = 0;
+
+    // Wire name, e.g. "process_started"
+    static const char* typeName(EventType type);
+    static uint32_t typeBit(EventType type);
+
+    // Periodic measurements, as opposed to discrete events
+    static bool isStats(EventType type);
+
+    // Comma-separated type names, or "all", into a mask. False with the
+    // first unknown name in unknown; types is then left untouched
+    static bool parseTypes(const std::string& list, uint32_t& types, std::string& unknown);
+
+    // The event's payload as a JSON object
+    static std::string toJson(const AgentEvent& event);
+    static std::string jsonQuote(const std::string& value);
+};
+
+#endif
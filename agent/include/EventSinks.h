@@ -0,0 +1,76 @@
+#ifndef EVENT_SINKS_H
+#define EVENT_SINKS_H
+
+#include <string>
+#include <fstream>
+#include <atomic>
+#include "EventSink.h"
+#include "EventLogger.h"
+#include "EventTime.h"
+#include "EventPublisher.h"
+#include "MetricsServer.h"
+
+// SQLite tables through EventLogger, one transaction per batch
+class DatabaseSink : public EventSink {
+private:
+    EventLogger& logger;
+
+public:
+    explicit DatabaseSink(EventLogger& logger);
+
+    const char* name() const override;
+    void write(const std::vector<std::shared_ptr<const AgentEvent>>& batch) override;
+};
+
+// One {"timestamp","time_ns","type","data"} object per line
+class JsonLinesSink : public EventSink {
+private:
+    std::ofstream output;
+    TimestampFormatter formatter;
+    std::string lines;
+
+public:
+    explicit JsonLinesSink(const std::string& path);
+
+    const char* name() const override;
+    void write(const std::vector<std::shared_ptr<const AgentEvent>>& batch) override;
+};
+
+// Human-readable lines on stdout, flushed once per batch
+class ConsoleSink : public EventSink {
+public:
+    const char* name() const override;
+    void write(const std::vector<std::shared_ptr<const AgentEvent>>& batch) override;
+};
+
+// Live stream for the API server (see EventPublisher)
+class SocketSink : public EventSink {
+private:
+    EventPublisher publisher;
+
+public:
+    explicit SocketSink(const std::string& path);
+
+    const char* name() const override;
+    void write(const std::vector<std::shared_ptr<const AgentEvent>>& batch) override;
+};
+
+// Event and alert counters for the metrics endpoint
+class MetricsSink : public EventSink {
+private:
+    std::atomic<uint64_t> events[TYPE_COUNT];
+    std::atomic<uint64_t> info_alerts;
+    std::atomic<uint64_t> warning_alerts;
+    std::atomic<uint64_t> critical_alerts;
+
+public:
+    MetricsSink();
+
+    const char* name() const override;
+    void write(const std::vector<std::shared_ptr<const AgentEvent>>& batch) override;
+
+    // Append the counters to a snapshot being rendered
+    void render(MetricsWriter& writer) const;
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef EVENT_TIME_H
+#define EVENT_TIME_H
+
+#include <string>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+// Event times: wall-clock epoch nanoseconds that never run backwards. A
+// clock stepped back (NTP, manual change) holds the last value, advancing a
+// nanosecond per call, until wall time catches up, so events from one run
+// always sort in observation order.
+class EventClock {
+private:
+    static std::atomic<int64_t> last_time;
+
+public:
+    static int64_t now();
+};
+
+// "YYYY-MM-DD HH:MM:SS" with optional milliseconds, written into the
+// caller's buffer. The date and time are converted once per second and
+// reused, so formatting a batch costs a copy per event. Not shared between
+// threads; each thread or sink keeps its own.
+class TimestampFormatter {
+private:
+    static constexpr size_t PREFIX_SIZE = 19;
+
+    bool utc;
+    int64_t cached_second;
+    char prefix[PREFIX_SIZE + 1];
+
+public:
+    static constexpr size_t BUFFER_SIZE = 24;   // Fits the milliseconds and the NUL
+
+    explicit TimestampFormatter(bool utc = false);
+
+    // NUL-terminated; returns the length
+    size_t format(int64_t epoch_ns, char* buffer, bool milliseconds = false);
+    std::string format(int64_t epoch_ns, bool milliseconds = false);
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef FREQUENCY_SKETCH_H
+#define FREQUENCY_SKETCH_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+class StateWriter;
+class StateReader;
+
+// Count-min sketch with conservative update and periodic aging. Memory is
+// fixed at construction (width * depth 16-bit counters) regardless of how
+// many distinct keys are seen; estimates never undercount.
+class FrequencySketch {
+private:
+    std::vector<uint16_t> counters;
+    size_t width;   // Power of two
+    size_t depth;
+
+    static uint64_t hashKey(const std::string& key);
+    size_t slot(size_t row, uint64_t hash) const;
+
+public:
+    explicit FrequencySketch(size_t min_width = 2048, size_t rows = 4);
+    ~FrequencySketch();
+
+    // Count one sighting of key and return its estimated frequency
+    uint32_t add(const std::string& key);
+    uint32_t estimate(const std::string& key) const;
+
+    // Halve every counter so old activity fades out
+    void age();
+    void clear();
+    size_t memoryBytes() const;
+
+    // Checkpoint for warm restarts; a sketch of other dimensions is rejected
+    void saveState(StateWriter& out) const;
+    bool loadState(StateReader& in);
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef INTERFACE_MONITOR_H
+#define INTERFACE_MONITOR_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <chrono>
+
+struct InterfaceStats {
+    std::string name;
+    uint64_t rx_bytes;
+    uint64_t rx_packets;
+    uint64_t rx_errors;
+    uint64_t rx_drops;
+    uint64_t tx_bytes;
+    uint64_t tx_packets;
+    uint64_t tx_errors;
+    uint64_t tx_drops;
+
+    // Per-second rates over the last interval
+    double rx_bytes_rate;
+    double tx_bytes_rate;
+    double rx_packets_rate;
+    double tx_packets_rate;
+    double errors_rate;
+    double drops_rate;
+
+    long link_speed_mbps;   // -1 when the driver does not report it
+    double utilization;     // Busier direction as % of link speed, -1 if unknown
+};
+
+// Host network interface counters from /proc/net/dev. The file is read into
+// a reused buffer and parsed in place, and results are written into the
+// caller's vector, so steady-state collection does not allocate.
+class InterfaceMonitor {
+private:
+    static constexpr size_t COUNTER_COUNT = 8;
+    static constexpr size_t NAME_SIZE = 16;
+
+    struct InterfaceState {
+        char name[NAME_SIZE];
+        uint64_t counters[COUNTER_COUNT];
+        long link_speed_mbps;
+        bool seen;  // Present in the latest collection
+    };
+
+    std::vector<char> read_buffer;
+    std::vector<InterfaceState> states;
+    std::chrono::steady_clock::time_point last_collection;
+    bool has_previous;
+
+    InterfaceState* findState(const char* name, size_t length);
+    static long readLinkSpeed(const char* name);
+    static uint64_t counterDelta(uint64_t current, uint64_t previous);
+
+public:
+    InterfaceMonitor();
+    ~InterfaceMonitor();
+
+    // Fill interfaces with current counters and rates; false if unavailable
+    bool collect(std::vector<InterfaceStats>& interfaces);
+};
+
+#endif
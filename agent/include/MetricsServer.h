@@ -0,0 +1,91 @@
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+
+// Builds one Prometheus text exposition (format 0.0.4)
+class MetricsWriter {
+private:
+    std::string body;
+    std::string family;     // Metric currently being written
+
+public:
+    MetricsWriter();
+    ~MetricsWriter();
+
+    // Start a metric family; type is "gauge" or "counter"
+    void metric(const std::string& name, const std::string& type, const std::string& help);
+
+    // One sample of the current family; labels as joined by label()
+    void sample(double value, const std::string& labels = "");
+
+    // name="value" with the value escaped, appended to labels with a comma
+    static std::string label(const std::string& labels, const std::string& name, const std::string& value);
+
+    std::string take();
+};
+
+// Serves the latest exposition over HTTP on its own thread. The body is
+// rendered once per collection cycle and handed over with publish(); each
+// scrape only pins a reference to it, so serving never touches /proc or
+// SQLite and doesn't block the collection loop.
+class MetricsServer {
+private:
+    static constexpr size_t MAX_CONNECTIONS = 64;
+    static constexpr size_t MAX_REQUEST_SIZE = 8192;
+    static constexpr int IDLE_TIMEOUT_MS = 5000;
+
+    struct Connection {
+        int fd;
+        std::string request;
+        std::string header;
+        std::shared_ptr<const std::string> body;    // Keeps the served snapshot alive
+        size_t sent;
+        bool responding;
+        std::chrono::steady_clock::time_point opened;
+    };
+
+    std::vector<int> listen_fds;
+    std::string unix_path;
+    int epoll_fd;
+    int wake_fd;
+    std::thread worker;
+    std::mutex snapshot_mutex;
+    std::shared_ptr<const std::string> snapshot;
+    std::unordered_map<int, Connection> connections;
+    std::atomic<uint64_t> scrapes;
+
+    void run();
+    void acceptConnections(int listen_fd);
+    void readRequest(Connection& connection);
+    void prepareResponse(Connection& connection);
+    bool writeResponse(Connection& connection);    // True once fully sent
+    void closeConnection(int fd);
+    void closeIdleConnections();
+
+public:
+    MetricsServer();
+    ~MetricsServer();
+
+    bool listenTcp(const std::string& address, int port);
+    bool listenUnix(const std::string& path);
+
+    // Start serving on the listeners opened so far
+    bool start();
+    void stop();
+
+    // Replace the body served to subsequent scrapes
+    void publish(std::string body);
+
+    uint64_t scrapeCount() const;
+};
+
+#endif
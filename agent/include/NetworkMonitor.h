@@ -3,7 +3,9 @@
 
 #include <vector>
 #include <string>
-#include <unordered_set>
+
+class StateWriter;
+class StateReader;
 
 struct NetworkConnection {
     std::string local_ip;
@@ -18,22 +20,36 @@ struct NetworkConnection {
 
 class NetworkMonitor {
 private:
-    std::unordered_set<std::string> previous_connections;
+    // The latest scan, shared by the new/update calls of one cycle, with its
+    // connection keys in the same order, and the sorted keys of the last
+    // committed scan. All are refilled in place, so entries keep their
+    // string capacity and a steady-state scan allocates almost nothing.
+    std::vector<NetworkConnection> current_connections;
+    std::vector<std::string> current_keys;
+    std::vector<std::string> previous_keys;
+    bool snapshot_pending;
+    std::vector<char> read_buffer;
     
-    std::vector<NetworkConnection> parseTcpConnections();
-    std::vector<NetworkConnection> parseUdpConnections();
-    std::string getConnectionKey(const NetworkConnection& conn);
+    void scanConnections();
+    void parseTcpConnections(std::vector<NetworkConnection>& connections, size_t& count);
+    void parseUdpConnections(std::vector<NetworkConnection>& connections, size_t& count);
+    static void getConnectionKey(const NetworkConnection& conn, std::string& key);
     std::string getProcessNameByPid(int pid);
 
 public:
     NetworkMonitor();
     ~NetworkMonitor();
     
-    std::vector<NetworkConnection> getCurrentConnections();
+    // Valid until the next scan
+    const std::vector<NetworkConnection>& getCurrentConnections();
     std::vector<NetworkConnection> getNewConnections();
     std::vector<NetworkConnection> getListeningPorts();
     void updateConnectionList();
     
+    // Checkpoint of the known connection set for warm restarts
+    void saveState(StateWriter& out) const;
+    bool loadState(StateReader& in);
+    
     // Utility functions
     static std::string ipToString(unsigned long ip);
     std::vector<int> getOpenPorts();
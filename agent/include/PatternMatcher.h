@@ -0,0 +1,33 @@
+#ifndef PATTERN_MATCHER_H
+#define PATTERN_MATCHER_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Aho-Corasick automaton for substring matching against a fixed pattern set.
+// Patterns are compiled once into a dense DFA over the bytes that actually
+// occur in them, so a name is matched in a single pass with one table
+// lookup per byte.
+class PatternMatcher {
+private:
+    std::vector<std::string> patterns;
+    std::vector<int32_t> transitions; // state * alphabet_size + byte class
+    std::vector<uint8_t> accepting;
+    uint8_t byte_class[256];
+    int alphabet_size;
+    bool built;
+
+public:
+    PatternMatcher();
+
+    void addPattern(const std::string& pattern);
+    void build();
+    void clear();
+
+    // True if any pattern occurs as a substring of text.
+    bool matchesAny(const std::string& text) const;
+    size_t patternCount() const;
+};
+
+#endif
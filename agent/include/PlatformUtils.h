@@ -1,7 +1,10 @@
 #ifndef PLATFORM_UTILS_H
+#define PLATFORM_UTILS_H
 
 #include <string>
 #include <vector>
+#include <cstdint>
+#include <cstddef>
 
 // Platform detection
 #ifdef _WIN32
@@ -38,6 +41,7 @@
 
 namespace PlatformUtils {
     std::string getCurrentTimestamp();
+    std::string formatTimestamp(time_t time);
     void sleepMs(int milliseconds);
     bool createDirectory(const std::string& path);
     std::string getExecutablePath();
@@ -46,6 +50,33 @@ namespace PlatformUtils {
     double getCpuUsage();
     long getMemoryUsage();
     double getLoadAverage();
+    double getDiskUsage(const std::string& path);
+    
+    // Read a whole (proc) file into buffer, growing it only when needed and
+    // NUL-terminating the contents. Returns false if the file can't be read.
+    bool readFileInto(const char* path, std::vector<char>& buffer);
+#ifndef PLATFORM_WINDOWS
+    // Same, relative to an open directory (e.g. a cgroup kept open between cycles)
+    bool readFileAt(int dir_fd, const char* name, std::vector<char>& buffer);
+#endif
+    
+    // Value after the first line starting with key ("VmRSS:", "usage_usec "), 0 if absent
+    unsigned long long findField(const std::vector<char>& buffer, const char* key);
+    
+    // 64-bit FNV-1a, for table keys and checksums; not for anything adversarial
+    inline uint64_t fnv1a(const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+    
+    inline uint64_t fnv1a(const std::string& text) {
+        return fnv1a(text.data(), text.size());
+    }
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,73 @@
+#ifndef PORT_BITMAP_H
+#define PORT_BITMAP_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <initializer_list>
+
+// Fixed 65536-bit set of TCP/UDP ports. Lookups are a shift and a mask,
+// and default sets can be built entirely at compile time.
+class PortBitmap {
+private:
+    static constexpr size_t PORT_COUNT = 65536;
+    static constexpr size_t WORD_COUNT = PORT_COUNT / 64;
+
+    uint64_t words[WORD_COUNT];
+
+public:
+    constexpr PortBitmap() : words{} {}
+
+    constexpr PortBitmap(std::initializer_list<int> ports) : words{} {
+        for (int port : ports) {
+            set(port);
+        }
+    }
+
+    constexpr void set(int port) {
+        if (static_cast<unsigned>(port) < PORT_COUNT) {
+            words[port >> 6] |= uint64_t(1) << (port & 63);
+        }
+    }
+
+    // Clamped to valid ports, so an oversized range can't run away
+    constexpr void setRange(int first, int last) {
+        if (first < 0) {
+            first = 0;
+        }
+        if (last > static_cast<int>(PORT_COUNT) - 1) {
+            last = static_cast<int>(PORT_COUNT) - 1;
+        }
+        for (int port = first; port <= last; port++) {
+            set(port);
+        }
+    }
+
+    constexpr void clear(int port) {
+        if (static_cast<unsigned>(port) < PORT_COUNT) {
+            words[port >> 6] &= ~(uint64_t(1) << (port & 63));
+        }
+    }
+
+    constexpr bool contains(int port) const {
+        return static_cast<unsigned>(port) < PORT_COUNT &&
+               ((words[port >> 6] >> (port & 63)) & 1) != 0;
+    }
+
+    void reset();
+    size_t count() const;
+    void merge(const PortBitmap& other);
+
+    // Adds ports from a comma or space separated list of ports and
+    // "first-last" ranges. Entries that are not a port 0-65535 or an
+    // ascending range of them are skipped; false is returned with the first
+    // such entry in bad_entry.
+    bool addList(const std::string& list, std::string* bad_entry = nullptr);
+
+    // Loads ports from a text file: one port or "first-last" range per line,
+    // '#' starts a comment. Returns false (leaving the set untouched) if the
+    // file cannot be read or has a malformed entry.
+    bool loadFromFile(const std::string& path);
+};
+
+#endif
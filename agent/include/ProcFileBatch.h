@@ -0,0 +1,69 @@
+#ifndef PROC_FILE_BATCH_H
+#define PROC_FILE_BATCH_H
+
+#include <vector>
+#include <string>
+#include <cstddef>
+
+// Reads the same small file (e.g. "stat") for a window of pids. With the
+// io_uring backend the whole window costs a few io_uring_enter calls
+// instead of an open, read and close per pid: one batch of openat, then one
+// batch of read -> close chains (hard-linked, so the close runs even when
+// the read fails), each submitted at once and reaped as it completes.
+// Without io_uring, or once it fails, the same calls go through plain
+// system calls. The root directory is opened once and pids are resolved
+// relative to it, which also lets a fake procfs stand in.
+class ProcFileBatch {
+private:
+    static constexpr size_t SLOT_SIZE = 1024;   // Larger files are truncated
+
+    int root_fd;
+    int ring_fd;
+    void* sq_ring;
+    size_t sq_ring_size;
+    void* cq_ring;
+    size_t cq_ring_size;
+    void* sqes;
+    size_t sqes_size;
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    void* cqes;
+
+    std::vector<int> pids;          // Of the last read, in the order given
+    std::vector<char> slots;        // SLOT_SIZE bytes per pid, NUL-terminated
+    std::vector<int> sizes;         // Bytes read, -1 if unreadable
+    std::vector<int> fds;
+    std::vector<char> paths;        // "<pid>/<name>", alive until the openat completes
+
+    bool setupRing();
+    void closeRing();
+    unsigned submit(unsigned count, unsigned tail);
+    bool waitCompletion(unsigned remaining, unsigned long long& user_data, int& result);
+    bool readRing(const char* name);
+    void readSync(const char* name);
+
+public:
+    static constexpr size_t WINDOW = 256;       // Pids per read() call
+
+    explicit ProcFileBatch(const std::string& root = "/proc");
+    ~ProcFileBatch();
+
+    // False when io_uring is unavailable (old kernel, seccomp, disabled
+    // by sysctl); reads then keep using plain system calls
+    bool enableRing(bool enabled);
+    bool ringEnabled() const;
+
+    // Read <root>/<pid>/<name> for up to WINDOW pids, sorted ascending
+    void read(const std::vector<int>& window, const char* name);
+
+    // The file from the last read; false if the pid wasn't in it or the
+    // file couldn't be read (the process exited)
+    bool find(int pid, const char*& data, size_t& size) const;
+};
+
+#endif
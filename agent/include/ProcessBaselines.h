@@ -0,0 +1,79 @@
+#ifndef PROCESS_BASELINES_H
+#define PROCESS_BASELINES_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+class StateWriter;
+class StateReader;
+
+// Result of feeding one sample into a process-name baseline
+struct BaselineDeviation {
+    bool established;   // Enough samples to trust the baseline
+    double cpu_mean;
+    double cpu_score;   // Standard deviations above the mean
+    double memory_mean;
+    double memory_score;
+};
+
+// Per-process-name EWMA mean/variance of CPU and RSS, held in a fixed-size
+// set-associative table. Names hash to a set of SET_WAYS slots; a miss
+// evicts the least recently used slot, preferring entries still in warm-up,
+// so a storm of short-lived random names cannot flush established baselines
+// and memory never grows past the configured capacity.
+//
+// A name takes one sample per cycle, from its busiest instance, so thirty
+// worker processes count as one observation and not thirty.
+class ProcessBaselines {
+private:
+    static constexpr size_t SET_WAYS = 8;
+
+    struct Entry {
+        uint64_t key;       // Name hash, 0 = empty slot
+        uint64_t last_used; // Cycle counter for LRU
+        uint32_t samples;
+        double cpu_mean;
+        double cpu_var;
+        double memory_mean;
+        double memory_var;
+        uint64_t pending_cycle; // Cycle of the sample not yet folded in, 0 = none
+        double pending_cpu;
+        double pending_memory;
+    };
+
+    std::vector<Entry> entries;
+    size_t set_count;
+    uint64_t cycle;
+    double alpha;
+    uint32_t warmup_samples;
+    uint64_t evictions;
+
+    static uint64_t hashName(const std::string& name);
+    bool evictsBefore(const Entry& a, const Entry& b) const;
+    Entry& findOrInsert(uint64_t key);
+    void fold(Entry& entry) const;
+    static double score(double value, double mean, double var, double min_stddev);
+
+public:
+    explicit ProcessBaselines(size_t capacity = 4096, double smoothing = 0.05, uint32_t warmup = 30);
+    ~ProcessBaselines();
+
+    // Advance the LRU clock; call once per collection cycle
+    void beginCycle();
+
+    // Score a sample against the baseline for name. Measured samples count
+    // towards the name's sample for this cycle, which is folded in on the
+    // name's first update of a later cycle.
+    BaselineDeviation update(const std::string& name, double cpu_usage, double memory_kb, bool measured);
+
+    size_t capacity() const;
+    size_t size() const;
+    uint64_t evictionCount() const;
+
+    // Checkpoint for warm restarts; a table of another capacity is rejected
+    void saveState(StateWriter& out) const;
+    bool loadState(StateReader& in);
+};
+
+#endif
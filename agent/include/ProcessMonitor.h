@@ -4,6 +4,12 @@
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <cstdint>
+#include <chrono>
+#include "ProcFileBatch.h"
+
+class StateWriter;
+class StateReader;
 
 struct ProcessInfo {
     int pid;
@@ -14,30 +20,195 @@ struct ProcessInfo {
     std::string state;
     int parent_pid;
     std::string start_time;
+    unsigned long long start_ticks = 0;   // Clock ticks after boot; 0 where unavailable
+    bool has_cpu_usage = false;   // False on a process's first scan, where cpu_usage is a placeholder 0
+
+    // Read once per process instance
+    std::string executable;
+    int uid = -1;
+    std::string cgroup;           // cgroup v2 path, empty if not in a unified hierarchy
+
+    // Hot processes only (top consumers, flagged, or in uninterruptible
+    // wait); refreshed every few scans
+    bool has_details = false;
+    long resident_kb = 0;
+    long swap_kb = 0;
+    long pss_kb = 0;              // Proportional set size from smaps_rollup
+    int thread_count = 0;
+    int fd_count = -1;            // -1 when the fd table is not readable
+
+    // Hot processes only, sampled every scan
+    bool has_io_stats = false;
+    unsigned long long read_bytes = 0;    // Cumulative storage I/O
+    unsigned long long write_bytes = 0;
+    double read_bytes_rate = 0.0;
+    double write_bytes_rate = 0.0;
+    double run_delay_ms = 0.0;    // Main thread's run-queue wait per second
+};
+
+// One thread of a busy process, in the thread-level view
+struct ThreadInfo {
+    int pid = 0;
+    int tid = 0;
+    std::string name;             // The thread's own name, e.g. from pthread_setname_np
+    std::string process_name;
+    std::string state;
+    double cpu_usage = 0.0;       // % of one CPU, so a spinning thread reads about 100
 };
 
 class ProcessMonitor {
 private:
-    std::unordered_map<int, ProcessInfo> previous_processes;
+    // A pid alone is ambiguous once recycled; with the start time it names
+    // exactly one process instance
+    struct ProcessKey {
+        int pid;
+        unsigned long long start_ticks;
+
+        bool operator==(const ProcessKey& other) const {
+            return pid == other.pid && start_ticks == other.start_ticks;
+        }
+
+        bool operator<(const ProcessKey& other) const {
+            return pid != other.pid ? pid < other.pid : start_ticks < other.start_ticks;
+        }
+    };
+
+    struct ProcessKeyHash {
+        size_t operator()(const ProcessKey& key) const {
+            return std::hash<unsigned long long>()((static_cast<unsigned long long>(key.pid) << 40) ^ key.start_ticks);
+        }
+    };
+
+    // Per-process state kept between scans
+    struct ProcessCacheEntry {
+        unsigned long long cpu_time = 0;
+        unsigned long long total_cpu_time = 0;  // System-wide CPU time when cpu_time was read
+        bool has_cpu_sample = false;
+        bool identity_loaded = false;
+        std::string name;             // Changes on exec, which invalidates the identity
+        std::string start_time;
+        std::string command;
+        std::string executable;
+        int uid = -1;
+        std::string cgroup;
+        int open_alerts = 0;          // Announced and not yet resolved; hot while above 0
+        bool hot = false;
+        uint64_t details_scan = 0;    // Scan that last read the details, 0 = never
+        ProcessInfo details;          // Only the hot-process fields are meaningful
+        unsigned long long run_delay_ns = 0;
+        std::chrono::steady_clock::time_point activity_time;
+        uint64_t activity_scan = 0;   // Scan of the last io/schedstat sample
+        size_t thread_offset = 0;     // Where the next scan resumes in a thread list over budget
+        uint64_t last_seen_scan = 0;
+    };
+
+    static constexpr size_t DETAIL_TOP_N = 10;        // Per ranking (CPU and memory)
+    static constexpr size_t MAX_HOT_PROCESSES = 32;
+    static constexpr uint64_t DETAIL_INTERVAL = 10;   // Scans between re-ranking and detail refreshes
+    static constexpr uint64_t THREAD_CACHE_SCANS = 16; // Least scans a thread's counters outlive its last sample
+
+    // CPU counters of the thread-level view, keyed by (tid, start ticks)
+    struct ThreadCacheEntry {
+        unsigned long long cpu_time = 0;
+        std::chrono::steady_clock::time_point sample_time;
+        uint64_t last_seen_scan = 0;
+        uint64_t keep_until_scan = 0; // Past the thread's next turn in the rotation
+    };
+
+    // Sorted keys of the last committed scan and of the latest one
+    std::vector<ProcessKey> previous_keys;
+    std::vector<ProcessKey> current_keys;
     std::unordered_map<int, unsigned long long> previous_cpu_times;
     unsigned long long previous_total_cpu_time;
-    
-    ProcessInfo parseProcessInfo(int pid);
+    std::unordered_map<ProcessKey, ProcessCacheEntry, ProcessKeyHash> process_cache;
+    long long boot_time;      // Epoch seconds, for converting start ticks
+    long clock_ticks;         // Ticks per second
+    unsigned long long scan_total_cpu_time;
+    uint64_t scan_count;
+    bool details_enabled;
+    unsigned int sample_stride;
+    std::vector<char> read_buffer;
+
+    // The latest scan, shared by the new/terminated/update calls of one cycle.
+    // Double-buffered and sorted by pid: each scan refills the older buffer in
+    // place, so entries keep their string capacity and a steady-state scan
+    // allocates almost nothing.
+    std::vector<ProcessInfo> current_snapshot;
+    std::vector<ProcessInfo> previous_snapshot;
+    bool snapshot_pending;
+    std::vector<int> pid_buffer;
+    std::vector<size_t> hot_order;
+
+    // Stat files of the next window of pids, read ahead in one batch
+    ProcFileBatch stat_reads;
+    std::vector<int> batch_pids;
+    bool batched_reads;
+    bool io_uring_requested;
+
+    size_t thread_top_n;          // 0 = thread-level view off
+    size_t thread_budget;         // Thread stat files read per scan
+    std::vector<ThreadInfo> thread_snapshot;
+    std::unordered_map<ProcessKey, ThreadCacheEntry, ProcessKeyHash> thread_cache;
+    std::vector<int> tid_buffer;
+
+    void parseProcessInfo(int pid, ProcessInfo& info);
     unsigned long long getTotalCpuTime();
     unsigned long long getProcessCpuTime(int pid);
     double calculateCpuUsage(int pid, unsigned long long current_cpu_time);
+    void scanProcesses();
+    static ProcessKey keyOf(const ProcessInfo& info);
+    bool readProcessStat(int pid, ProcessInfo& info, unsigned long long& cpu_time);
+    void readStatWindow(size_t first);
+    void loadIdentity(const ProcessInfo& info, ProcessCacheEntry& entry);
+    void loadDetails(int pid, ProcessCacheEntry& entry);
+    void sampleActivity(int pid, ProcessCacheEntry& entry, std::chrono::steady_clock::time_point now);
+    void refreshHotProcesses();
+    void scanThreads();
+    void listThreads(int pid);
+    static bool readThreadStat(int pid, int tid, ThreadInfo& thread, unsigned long long& cpu_time,
+                               unsigned long long& start_ticks);
 
 public:
     ProcessMonitor();
     ~ProcessMonitor();
-    
-    std::vector<ProcessInfo> getCurrentProcesses();
+
+    // Valid until the next scan
+    const std::vector<ProcessInfo>& getCurrentProcesses();
     std::vector<ProcessInfo> getNewProcesses();
     std::vector<int> getTerminatedProcesses();
     void updateProcessList();
-    
+
+    // Collect detailed stats for this process on the next scans, e.g. once
+    // it has raised an alert, until as many of its alerts have resolved
+    void flagProcess(int pid);
+    void unflagProcess(int pid);
+
+    // Load shedding for the agent's own budget: skip the hot-process
+    // details, and re-read only one in stride known processes per scan
+    // (new processes are always read; the rest keep their last values)
+    void setDetailsEnabled(bool enabled);
+    void setSampleStride(unsigned int stride);
+
+    // Read the per-pid stat files through io_uring, a window at a time;
+    // stays on plain reads where the ring can't be set up
+    void setIoUringReads(bool enabled);
+
+    // Thread-level view of the top_processes busiest processes, reading at
+    // most max_threads thread stat files per scan; a process with more
+    // threads than its share is covered over several scans. 0 turns it off.
+    // Shed along with the hot-process details.
+    void setThreadMonitoring(size_t top_processes, size_t max_threads);
+
+    // Threads from the latest scan; valid until the next scan
+    const std::vector<ThreadInfo>& getThreads() const;
+
+    // Checkpoint of the known processes and their CPU counters for warm
+    // restarts. Ignored after a reboot, when pids and counters restart.
+    void saveState(StateWriter& out) const;
+    bool loadState(StateReader& in);
+
     // Utility functions
-    static std::vector<int> getAllPids();
+    static void getAllPids(std::vector<int>& pids);
     static long getSystemMemoryTotal();
     static long getSystemMemoryUsed();
 };
@@ -0,0 +1,62 @@
+#ifndef PROCESS_TREE_H
+#define PROCESS_TREE_H
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include "ProcessMonitor.h"
+
+struct ProcessTreeNode {
+    int pid;
+    int parent_pid;         // 0 while the parent is unknown (e.g. just exited)
+    std::string name;
+    double cpu_usage;
+    long memory_usage;
+    std::vector<int> children;
+};
+
+struct ProcessTreeTotals {
+    int pid;
+    std::string name;
+    double cpu_usage;       // Sum over the subtree
+    long memory_usage;      // KB, sum over the subtree
+    int process_count;
+};
+
+// Parent -> children index over the live processes. It is maintained from
+// each cycle's snapshot diff (started and exited processes) rather than
+// rebuilt, so ancestry lookups cost O(depth) and subtree totals only visit
+// the subtree.
+class ProcessTree {
+private:
+    static constexpr size_t MAX_DEPTH = 64; // Guards against ppid loops
+
+    std::unordered_map<int, ProcessTreeNode> nodes;
+
+    void link(int pid, int parent_pid);
+    void unlink(int pid, int parent_pid);
+
+public:
+    ProcessTree();
+    ~ProcessTree();
+
+    // Apply one cycle: remove exited pids, insert started processes, then
+    // refresh metrics and reparenting from the full current list
+    void update(const std::vector<ProcessInfo>& current,
+                const std::vector<ProcessInfo>& started,
+                const std::vector<int>& exited);
+
+    const ProcessTreeNode* find(int pid) const;
+
+    // Nearest first, excluding pid itself; stops after max_depth levels
+    std::vector<const ProcessTreeNode*> ancestors(int pid, size_t max_depth = MAX_DEPTH) const;
+
+    ProcessTreeTotals subtreeTotals(int pid) const;
+
+    // Children of root_pid ordered by subtree CPU, e.g. services under init
+    std::vector<ProcessTreeTotals> largestSubtrees(int root_pid, size_t count) const;
+
+    size_t size() const;
+};
+
+#endif
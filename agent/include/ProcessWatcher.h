@@ -0,0 +1,72 @@
+#ifndef PROCESS_WATCHER_H
+#define PROCESS_WATCHER_H
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include "ProcessMonitor.h"
+#include "AlertManager.h"
+#include "EventRouter.h"
+
+// Reports the exit of a short list of critical processes as it happens,
+// rather than on the next scan. Every process with a watched name is held
+// through a pidfd that a worker thread waits on with epoll; the exit goes
+// straight to the sinks as a WATCHED_PROCESS_EXITED alert carrying the exit
+// status. When a process of that name shows up again the watch re-attaches
+// and the alert resolves. Kernels without pidfd_open (before 5.3) fall back
+// to re-checking the watched pids in /proc every POLL_INTERVAL_MS.
+class ProcessWatcher {
+private:
+    static constexpr size_t MAX_WATCHED = 64;
+    static constexpr int POLL_INTERVAL_MS = 250;
+
+    struct Watch {
+        int pid;
+        unsigned long long start_ticks;
+        std::string name;
+        int fd;                     // pidfd, -1 when polling /proc
+    };
+
+    EventRouter& router;
+    bool pidfd_supported;
+    int epoll_fd;
+    int wake_fd;
+    std::atomic<bool> stopping;
+    std::thread worker;
+
+    // Shared with the worker
+    std::mutex mutex;
+    std::vector<std::string> names;         // Sorted
+    std::vector<Watch> watches;
+    std::vector<Watch> exited;              // Reported; zombies linger in scans until reaped
+    std::vector<std::string> exited_names;  // Not back yet
+    bool limit_reported;
+
+    void run();
+    bool attach(const ProcessInfo& process);
+    void release(Watch& watch);
+    AnomalyAlert exitAlert(const Watch& watch, int status) const;
+
+    static bool readStat(int pid, unsigned long long& start_ticks, bool& zombie, int& exit_code);
+    static int exitStatus(const Watch& watch);
+    static std::string describeStatus(int status);
+
+public:
+    explicit ProcessWatcher(EventRouter& router);
+    ~ProcessWatcher();
+
+    // Process names as in /proc/<pid>/stat; watches on names no longer
+    // listed are dropped
+    void setWatchList(const std::vector<std::string>& names);
+
+    // Attach to the watched processes in the latest scan: at startup, and
+    // again each time one restarts
+    void update(const std::vector<ProcessInfo>& processes);
+
+    bool start();
+    void stop();
+};
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef RATE_COUNTER_H
+#define RATE_COUNTER_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Rolling event count over the last WINDOW_SECONDS seconds, kept as a ring
+// of per-second buckets. Times are caller-supplied monotonic seconds.
+class SlidingWindowCounter {
+public:
+    static constexpr int WINDOW_SECONDS = 60;
+
+private:
+    uint32_t buckets[WINDOW_SECONDS];
+    int64_t head_second;    // Second held by the newest bucket
+    uint64_t window_total;
+
+    void advance(int64_t now);
+
+public:
+    SlidingWindowCounter();
+
+    void add(int64_t now, uint32_t count = 1);
+    uint64_t total(int64_t now);
+    void clear();
+};
+
+// Sliding-window counters for many entities (parent pids, remote IPs, ...)
+// in a fixed number of slots. Keys hash into small sets; a new key replaces
+// the slot with the lowest current rate, so memory stays constant while
+// the busiest entities keep their counts.
+class KeyedRateCounter {
+private:
+    static constexpr size_t SET_WAYS = 4;
+
+    struct Slot {
+        uint64_t key;   // Key hash, 0 = empty
+        SlidingWindowCounter counter;
+    };
+
+    std::vector<Slot> slots;
+    size_t set_count;
+
+    static uint64_t hashKey(const std::string& key);
+
+public:
+    explicit KeyedRateCounter(size_t capacity = 256);
+
+    // Count events for key and return its total over the window
+    uint64_t add(const std::string& key, int64_t now, uint32_t count = 1);
+    uint64_t total(const std::string& key, int64_t now);
+    size_t capacity() const;
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef RESOURCE_GOVERNOR_H
+#define RESOURCE_GOVERNOR_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include "AlertManager.h"
+
+// Keeps the agent inside its own CPU and memory budget. Each cycle it
+// measures the agent's CPU time and RSS; sustained overruns step the
+// degradation level up, sustained headroom steps it back down. Levels are
+// cumulative, in this order:
+//   1  collection interval doubled
+//   2  hot-process details (smaps, fds, io, schedstat, threads) no longer collected
+//   3  only a quarter of known processes re-read per scan
+//   4  console sink disabled
+class ResourceGovernor {
+private:
+    static constexpr int MAX_LEVEL = 4;
+    static constexpr int OVER_BUDGET_CYCLES = 5;    // Consecutive cycles over budget before degrading
+    static constexpr int UNDER_BUDGET_CYCLES = 30;  // Consecutive cycles under half the budget before restoring
+    static constexpr unsigned int SAMPLE_STRIDE = 4;
+
+    double cpu_budget;          // % of one core, 0 = unlimited
+    long memory_budget_kb;      // 0 = unlimited
+    int current_level;
+    int over_cycles;
+    int under_cycles;
+    uint64_t degradations[MAX_LEVEL + 1];   // Times each level was entered from below
+
+    double cpu_percent;
+    long rss_kb;
+    unsigned long long last_cpu_us;
+    std::chrono::steady_clock::time_point last_time;
+    bool has_sample;
+    AnomalyAlert last_transition;
+
+    static unsigned long long readCpuTimeUs();
+    static long readRssKb();
+
+public:
+    ResourceGovernor();
+    ~ResourceGovernor();
+
+    void setBudget(double cpu_percent, long memory_mb);
+
+    // Measure the agent's own cost since the previous call and adjust the
+    // level; true when it changed, with the change in transitionAlert()
+    bool update();
+
+    int level() const;
+    static const char* levelName(int level);
+    const AnomalyAlert& transitionAlert() const;
+
+    // What the current level allows
+    int intervalMs(int configured_ms) const;
+    bool detailsEnabled() const;
+    unsigned int sampleStride() const;
+    bool consoleEnabled() const;
+
+    double cpuPercent() const;
+    long rssKb() const;
+    uint64_t degradationCount(int level) const;
+
+    // Startup placement; threads created afterwards inherit both
+    static bool parseCpuList(const std::string& list, std::vector<int>& cpus);
+    static bool pinToCpus(const std::vector<int>& cpus);
+    static bool setNiceLevel(int nice_level);
+};
+
+#endif
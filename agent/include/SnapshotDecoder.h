@@ -0,0 +1,73 @@
+#ifndef SNAPSHOT_DECODER_H
+#define SNAPSHOT_DECODER_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include <istream>
+#include <cstdint>
+#include "ProcessMonitor.h"
+#include "NetworkMonitor.h"
+#include "SnapshotFormat.h"
+
+// Reference reader for the snapshot stream written by SnapshotEncoder.
+// Applies keyframes and deltas to its own copy of the tables; a consumer
+// feeds it every message in order and reads the tables after each one.
+class SnapshotDecoder {
+private:
+    struct ProcessRecord {
+        uint64_t start_ticks;
+        int parent_pid;
+        uint32_t name;
+        uint32_t command;
+        uint32_t state;
+        int64_t cpu;            // Hundredths of a percent
+        int64_t memory_kb;
+        int64_t uid;
+    };
+
+    struct ConnectionRecord {
+        uint32_t protocol;
+        uint32_t local_ip;
+        int local_port;
+        uint32_t remote_ip;
+        int remote_port;
+        uint32_t state;
+        int64_t pid;
+        uint32_t process_name;
+    };
+
+    std::vector<std::string> strings;
+    std::map<int, ProcessRecord> process_table;
+    std::map<std::string, ConnectionRecord> connection_table;  // Keyed by the encoded key bytes
+    uint64_t last_sequence;
+    uint64_t last_timestamp;
+    bool synchronized;      // A keyframe has been applied and no message was missed
+
+    bool decodeProcesses(const char*& position, const char* end);
+    bool decodeConnections(const char*& position, const char* end);
+    bool readKey(const char*& position, const char* end, std::string& key, ConnectionRecord& record) const;
+    bool readString(const char*& position, const char* end, uint32_t& id) const;
+
+public:
+    SnapshotDecoder();
+    ~SnapshotDecoder();
+
+    // Apply one message body. False if it is malformed or a delta arrives
+    // without its predecessor; the decoder then waits for the next keyframe.
+    bool decode(const std::string& message);
+
+    std::vector<ProcessInfo> processes() const;
+    std::vector<NetworkConnection> connections() const;
+    uint64_t sequence() const;
+    uint64_t timestamp() const;     // Epoch milliseconds of the last message
+    bool isSynchronized() const;
+
+    // Stream file helpers: the magic header, then one message per call.
+    // readMessage is false at the end of the stream and on a truncated
+    // message or a length over SnapshotFormat::MAX_MESSAGE_SIZE.
+    static bool readHeader(std::istream& input);
+    static bool readMessage(std::istream& input, std::string& message);
+};
+
+#endif
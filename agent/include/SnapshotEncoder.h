@@ -0,0 +1,87 @@
+#ifndef SNAPSHOT_ENCODER_H
+#define SNAPSHOT_ENCODER_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include <unordered_map>
+#include "ProcessMonitor.h"
+#include "NetworkMonitor.h"
+#include "SnapshotFormat.h"
+
+// Encodes each cycle's process and connection tables as a keyframe or a
+// delta against the previous cycle (see SnapshotFormat.h), so a steady host
+// costs a few hundred bytes per cycle instead of the full lists.
+class SnapshotEncoder {
+private:
+    static constexpr uint64_t KEYFRAME_INTERVAL = 600;      // Messages between keyframes
+    static constexpr size_t MAX_DICTIONARY = 65536;         // Strings before forcing a keyframe
+    static constexpr size_t MAX_FILE_BYTES = 64 * 1024 * 1024;
+
+    struct ProcessRecord {
+        int pid;
+        uint64_t start_ticks;
+        int parent_pid;
+        uint32_t name;
+        uint32_t command;
+        uint32_t state;
+        int64_t cpu;            // Hundredths of a percent
+        int64_t memory_kb;
+        int64_t uid;
+    };
+
+    struct ConnectionRecord {
+        uint32_t protocol;
+        uint32_t local_ip;
+        int local_port;
+        uint32_t remote_ip;
+        int remote_port;
+        uint32_t state;
+        int64_t pid;
+        uint32_t process_name;
+        bool seen;
+    };
+
+    std::unordered_map<std::string, uint32_t> dictionary;
+    std::string dictionary_additions;   // Strings first used in the message being built
+    uint32_t dictionary_added;
+    std::vector<ProcessRecord> previous_processes;  // Sorted by pid
+    std::unordered_map<std::string, ConnectionRecord> previous_connections;
+    std::vector<ProcessRecord> current_records;
+    std::string section;
+    uint64_t sequence;
+    uint64_t messages_since_keyframe;
+    bool keyframe_requested;
+
+    std::ofstream stream;
+    std::string stream_path;
+    size_t stream_bytes;
+    uint64_t total_bytes;
+
+    uint32_t intern(const std::string& text);
+    void encodeProcesses(const std::vector<ProcessInfo>& processes, bool keyframe, std::string& out);
+    void encodeConnections(const std::vector<NetworkConnection>& connections, bool keyframe, std::string& out);
+    static void putConnectionKey(std::string& out, const ConnectionRecord& record);
+    bool openStream();
+
+public:
+    SnapshotEncoder();
+    ~SnapshotEncoder();
+
+    // Encode one cycle into out (the message body, without its length prefix)
+    void encode(const std::vector<ProcessInfo>& processes, const std::vector<NetworkConnection>& connections,
+                uint64_t timestamp_ms, std::string& out);
+
+    // Make the next message a keyframe, e.g. when a new consumer attaches
+    void requestKeyframe();
+
+    // Append each cycle to a stream file, rotating it to path.1 when full
+    bool open(const std::string& path);
+    bool write(const std::vector<ProcessInfo>& processes, const std::vector<NetworkConnection>& connections);
+
+    // Stream bytes written since startup, across rotations
+    uint64_t bytesWritten() const;
+};
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef SNAPSHOT_FORMAT_H
+#define SNAPSHOT_FORMAT_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// Wire format of the process/connection snapshot stream.
+//
+// A stream file starts with MAGIC and holds length-prefixed messages
+// (varint length, then body). Each body is:
+//   type (1 byte), varint sequence, varint epoch ms,
+//   dictionary additions: varint count, then varint length + bytes each,
+//   processes: removed, added and changed sections,
+//   connections: removed, added and changed sections.
+// A keyframe resets the string dictionary and lists every entry as added;
+// a delta only carries what differs from the previous message and must
+// follow it directly (sequence + 1). Integers are LEB128 varints, signed
+// ones zigzag-encoded, strings are dictionary ids, and process sections are
+// sorted by pid with each pid stored as the gap from the one before.
+//
+// Process, added:   pid gap, start ticks, parent pid, name, command, state,
+//                   cpu (hundredths of %), memory KB, uid (signed)
+// Process, changed: pid gap, field mask, then the masked fields in bit
+//                   order; cpu and memory as signed deltas
+// Process, removed: pid gap
+// Connection key:   protocol, local ip, local port, remote ip, remote port
+// Connection, added:   key, state, pid (signed), process name
+// Connection, changed: key, field mask, masked fields in bit order
+// Connection, removed: key
+namespace SnapshotFormat {
+    const char MAGIC[] = "STSNAP1\n";
+    const size_t MAGIC_SIZE = 8;
+
+    const uint8_t KEYFRAME = 1;
+    const uint8_t DELTA = 2;
+
+    // Far above any real keyframe; a longer length prefix means corruption
+    const size_t MAX_MESSAGE_SIZE = 64 * 1024 * 1024;
+
+    // Bits of a changed process record
+    const uint8_t PROCESS_PARENT = 1;
+    const uint8_t PROCESS_NAME = 2;
+    const uint8_t PROCESS_COMMAND = 4;
+    const uint8_t PROCESS_STATE = 8;
+    const uint8_t PROCESS_CPU = 16;
+    const uint8_t PROCESS_MEMORY = 32;
+    const uint8_t PROCESS_UID = 64;
+
+    // Bits of a changed connection record
+    const uint8_t CONNECTION_STATE = 1;
+    const uint8_t CONNECTION_PID = 2;
+    const uint8_t CONNECTION_PROCESS = 4;
+
+    inline void putVarint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out += static_cast<char>((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    inline void putSigned(std::string& out, int64_t value) {
+        putVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    // Advances position; false on truncated or overlong input
+    inline bool getVarint(const char*& position, const char* end, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && position < end; shift += 7) {
+            uint8_t byte = static_cast<uint8_t>(*position++);
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline bool getSigned(const char*& position, const char* end, int64_t& value) {
+        uint64_t raw;
+        if (!getVarint(position, end, raw)) {
+            return false;
+        }
+        value = static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+        return true;
+    }
+}
+
+#endif
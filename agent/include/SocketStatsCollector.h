@@ -0,0 +1,66 @@
+#ifndef SOCKET_STATS_COLLECTOR_H
+#define SOCKET_STATS_COLLECTOR_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <chrono>
+
+struct SocketStats {
+    uint64_t cookie;        // Kernel socket cookie, unique for the socket's lifetime
+    std::string local_ip;
+    int local_port;
+    std::string remote_ip;
+    int remote_port;
+    std::string state;
+    unsigned int inode;
+    unsigned int uid;
+    uint64_t bytes_acked;       // Cumulative bytes sent and acknowledged
+    uint64_t bytes_received;
+    double send_rate;           // Bytes per second over the last interval
+    double receive_rate;
+    unsigned int rtt_us;
+    unsigned int rtt_var_us;
+    unsigned int snd_cwnd;
+    unsigned int total_retrans;
+    unsigned int retrans_delta; // Retransmits during the last interval
+};
+
+// Per-connection TCP metrics (throughput, RTT, retransmits, cwnd) pulled
+// from the kernel's tcp_info via NETLINK_SOCK_DIAG, without packet capture.
+// Previous counters are kept in a compact open-addressed table keyed by
+// socket cookie and rebuilt every cycle, so closed sockets drop out without
+// tombstones. Linux only; other platforms return no sockets.
+class SocketStatsCollector {
+private:
+    struct CounterEntry {
+        uint64_t cookie;    // 0 = empty slot
+        uint64_t bytes_acked;
+        uint64_t bytes_received;
+        uint32_t total_retrans;
+    };
+
+    int netlink_fd;
+    std::vector<char> receive_buffer;
+    std::vector<CounterEntry> previous_counters;
+    std::vector<CounterEntry> current_counters;
+    std::chrono::steady_clock::time_point last_collection;
+    bool has_previous;
+
+    bool openSocket();
+    bool dumpFamily(int family, std::vector<SocketStats>& sockets);
+    static void insertCounters(std::vector<CounterEntry>& table, const CounterEntry& entry);
+    static const CounterEntry* findCounters(const std::vector<CounterEntry>& table, uint64_t cookie);
+
+public:
+    SocketStatsCollector();
+    ~SocketStatsCollector();
+
+    // Dump all non-listening TCP sockets and compute per-interval rates
+    std::vector<SocketStats> collect();
+
+    // Sockets ordered by send + receive rate, highest first
+    static std::vector<SocketStats> topTalkers(const std::vector<SocketStats>& sockets, size_t count);
+};
+
+#endif
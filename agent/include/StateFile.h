@@ -0,0 +1,86 @@
+#ifndef STATE_FILE_H
+#define STATE_FILE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Append-only encoder for one component's checkpoint section
+class StateWriter {
+private:
+    std::string buffer;
+
+public:
+    void putVarint(uint64_t value);
+    void putSigned(int64_t value);
+    void putDouble(double value);
+    void putString(const std::string& value);
+
+    const std::string& data() const;
+};
+
+// Bounds-checked decoder over a section of the mapped file. Reads past the
+// end return zeros and clear ok(), so loaders check once at the end.
+class StateReader {
+private:
+    const char* position;
+    const char* end;
+    bool valid;
+
+public:
+    StateReader();
+    StateReader(const char* data, size_t size);
+
+    uint64_t getVarint();
+    int64_t getSigned();
+    double getDouble();
+    std::string getString();
+
+    bool ok() const;
+    bool atEnd() const;
+};
+
+// Checkpoint of the agent's learned state, so a restart resumes instead of
+// re-learning. Layout: magic, save time, then tagged length-prefixed
+// sections, then an FNV-1a checksum of everything before it. Sections with
+// unknown tags are skipped, so components can be added without a version
+// bump. The file is written to a temporary name and renamed into place.
+class StateFile {
+private:
+    static const char MAGIC[];
+    static const size_t MAGIC_SIZE = 8;
+
+    struct Section {
+        uint32_t tag;
+        const char* data;
+        size_t size;
+    };
+
+    const char* mapped;
+    size_t mapped_size;
+    std::string contents;           // Used where mmap is unavailable
+    std::vector<Section> sections;
+    int64_t saved_at;
+
+    static uint64_t checksum(const char* data, size_t size);
+
+public:
+    static const uint32_t PROCESS_MONITOR = 1;
+    static const uint32_t NETWORK_MONITOR = 2;
+    static const uint32_t ANOMALY_DETECTOR = 3;
+
+    StateFile();
+    ~StateFile();
+
+    // Map and validate a checkpoint; false if missing or damaged
+    bool open(const std::string& path);
+    void close();
+
+    bool section(uint32_t tag, StateReader& reader) const;
+    int64_t savedAt() const;   // Epoch seconds
+
+    static bool save(const std::string& path, const std::vector<std::pair<uint32_t, std::string>>& sections);
+};
+
+#endif
@@ -0,0 +1,346 @@
+#include "../include/AgentConfig.h"
+#include "../include/EventSink.h"
+#include "../include/ResourceGovernor.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#ifndef PLATFORM_WINDOWS
+    #include <signal.h>
+    #include <pthread.h>
+#endif
+
+// Rejects negatives and trailing garbage; unsigned types would otherwise
+// wrap "-1" silently
+template <typename T>
+static bool parseValue(const std::string& text, T& value) {
+    if (text.empty() || text[0] == '-') {
+        return false;
+    }
+    std::istringstream in(text);
+    T parsed;
+    if (!(in >> parsed) || !(in >> std::ws).eof()) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+static std::string trim(const std::string& text) {
+    size_t start = text.find_first_not_of(" \t\r");
+    if (start == std::string::npos) {
+        return "";
+    }
+    return text.substr(start, text.find_last_not_of(" \t\r") - start + 1);
+}
+
+// Comma-separated names merged into a sorted, unique list
+static void addNames(const std::string& value, std::vector<std::string>& names) {
+    std::stringstream list(value);
+    std::string name;
+    while (std::getline(list, name, ',')) {
+        name = trim(name);
+        if (!name.empty()) {
+            names.push_back(name);
+        }
+    }
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+}
+
+static bool parseThreshold(const std::string& key, const std::string& value, DetectorThresholds& t, bool& valid) {
+    if (key == "high_cpu_threshold") {
+        valid = parseValue(value, t.high_cpu_threshold);
+    } else if (key == "high_memory_threshold") {
+        valid = parseValue(value, t.high_memory_threshold);
+    } else if (key == "max_new_processes_per_minute") {
+        valid = parseValue(value, t.max_new_processes_per_minute);
+    } else if (key == "max_new_connections_per_minute") {
+        valid = parseValue(value, t.max_new_connections_per_minute);
+    } else if (key == "max_retransmits_per_socket") {
+        valid = parseValue(value, t.max_retransmits_per_socket);
+    } else if (key == "max_retransmits_total") {
+        valid = parseValue(value, t.max_retransmits_total);
+    } else if (key == "interface_saturation_threshold") {
+        valid = parseValue(value, t.interface_saturation_threshold);
+    } else if (key == "max_interface_drops_per_second") {
+        valid = parseValue(value, t.max_interface_drops_per_second);
+    } else if (key == "disk_full_threshold") {
+        valid = parseValue(value, t.disk_full_threshold);
+    } else if (key == "io_saturation_threshold") {
+        valid = parseValue(value, t.io_saturation_threshold);
+    } else if (key == "cgroup_memory_threshold") {
+        valid = parseValue(value, t.cgroup_memory_threshold);
+    } else if (key == "cgroup_throttle_threshold") {
+        valid = parseValue(value, t.cgroup_throttle_threshold);
+    } else if (key == "high_thread_cpu_threshold") {
+        valid = parseValue(value, t.high_thread_cpu_threshold);
+    } else if (key == "hysteresis_ratio") {
+        valid = parseValue(value, t.hysteresis_ratio) && t.hysteresis_ratio <= 1.0;
+    } else if (key == "deviation_threshold") {
+        valid = parseValue(value, t.deviation_threshold);
+    } else if (key == "max_process_io_rate") {
+        valid = parseValue(value, t.max_process_io_rate);
+    } else if (key == "max_run_delay_ms") {
+        valid = parseValue(value, t.max_run_delay_ms);
+    } else if (key == "rare_process_threshold") {
+        valid = parseValue(value, t.rare_process_threshold);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+AgentConfig::AgentConfig() : suspicious_ports(AnomalyDetector::defaultSuspiciousPorts()) {
+    // Stored sinks keep stats every 10 seconds; live consumers get every cycle
+    uint32_t stored_events = 0;
+    uint32_t console_events = 0;
+    uint32_t all_events = 0;
+    std::string unknown;
+    EventSink::parseTypes("process_started,connection,alert,system_stats,interface_stats,process_io,cgroup_stats,thread_stats",
+                          stored_events, unknown);
+    EventSink::parseTypes("process_started,process_exited,connection,alert,system_stats", console_events, unknown);
+    EventSink::parseTypes("all", all_events, unknown);
+    routes.push_back({"database", stored_events, 10});
+    routes.push_back({"json", stored_events, 10});
+    routes.push_back({"console", console_events, 10});
+    routes.push_back({"socket", all_events, 0});
+    routes.push_back({"metrics", all_events, 0});
+}
+
+const SinkRoute* AgentConfig::route(const std::string& sink) const {
+    for (const auto& route : routes) {
+        if (route.sink == sink) {
+            return &route;
+        }
+    }
+    return nullptr;
+}
+
+bool AgentConfig::parse(const std::string& path, AgentConfig& config, std::string& error) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    bool ports_replaced = false; // The first port setting replaces the defaults
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        line = trim(line);
+        if (line.empty()) {
+            continue;
+        }
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            error = path + ":" + std::to_string(line_number) + ": expected key = value";
+            return false;
+        }
+        std::string key = trim(line.substr(0, equals));
+        std::string value = trim(line.substr(equals + 1));
+        bool valid = true;
+
+        if (key == "monitor_interval_ms") {
+            valid = parseValue(value, config.monitor_interval_ms) &&
+                    config.monitor_interval_ms >= 100 && config.monitor_interval_ms <= 60000;
+        } else if (key == "process_io_uring") {
+            valid = parseValue(value, config.process_io_uring);
+        } else if (key == "thread_top_processes") {
+            valid = parseValue(value, config.thread_top_processes);
+        } else if (key == "thread_budget") {
+            valid = parseValue(value, config.thread_budget) && config.thread_budget >= 1;
+        } else if (key == "cpu_budget_percent") {
+            valid = parseValue(value, config.cpu_budget_percent);
+        } else if (key == "memory_budget_mb") {
+            valid = parseValue(value, config.memory_budget_mb);
+        } else if (key == "cpu_affinity") {
+            config.cpu_affinity.clear();
+            valid = ResourceGovernor::parseCpuList(value, config.cpu_affinity);
+        } else if (key == "nice_level") {
+            valid = parseValue(value, config.nice_level) && config.nice_level <= 19;
+        } else if (key.compare(0, 5, "sink.") == 0) {
+            std::string sink = key.substr(5);
+            bool interval = false;
+            size_t dot = sink.find('.');
+            if (dot != std::string::npos) {
+                interval = sink.substr(dot + 1) == "stats_interval";
+                valid = interval;
+                sink.erase(dot);
+            }
+            SinkRoute* route = nullptr;
+            for (auto& candidate : config.routes) {
+                if (candidate.sink == sink) {
+                    route = &candidate;
+                }
+            }
+            if (route == nullptr) {
+                error = path + ":" + std::to_string(line_number) + ": unknown sink '" + sink + "'";
+                return false;
+            }
+            if (interval) {
+                valid = parseValue(value, route->stats_interval);
+            } else if (valid) {
+                std::string unknown;
+                if (!EventSink::parseTypes(value, route->types, unknown)) {
+                    error = path + ":" + std::to_string(line_number) + ": unknown event type '" + unknown + "'";
+                    return false;
+                }
+            }
+        } else if (key == "known_processes") {
+            addNames(value, config.known_processes);
+        } else if (key == "watch_processes") {
+            addNames(value, config.watch_processes);
+        } else if (key == "known_processes_file") {
+            valid = AnomalyDetector::readKnownProcesses(value, config.known_processes);
+        } else if (key == "suspicious_ports" || key == "suspicious_ports_file") {
+            if (!ports_replaced) {
+                config.suspicious_ports.reset();
+                ports_replaced = true;
+            }
+            if (key == "suspicious_ports") {
+                std::string bad_entry;
+                if (!config.suspicious_ports.addList(value, &bad_entry)) {
+                    error = path + ":" + std::to_string(line_number) + ": invalid port entry '" + bad_entry + "'";
+                    return false;
+                }
+            } else {
+                PortBitmap loaded;
+                valid = loaded.loadFromFile(value);
+                config.suspicious_ports.merge(loaded);
+            }
+        } else if (!parseThreshold(key, value, config.thresholds, valid)) {
+            error = path + ":" + std::to_string(line_number) + ": unknown setting '" + key + "'";
+            return false;
+        }
+
+        if (!valid) {
+            error = path + ":" + std::to_string(line_number) + ": invalid value for " + key + ": '" + value + "'";
+            return false;
+        }
+    }
+    return true;
+}
+
+ConfigManager::ConfigManager(const std::string& path)
+    : path(path), active(new AgentConfig()), next_version(1), failed_reloads(0),
+      has_retired(false), stopping(false) {
+}
+
+ConfigManager::~ConfigManager() {
+    stop();
+    reclaim();
+    delete active.load();
+}
+
+void ConfigManager::blockReloadSignal() {
+#ifndef PLATFORM_WINDOWS
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+#endif
+}
+
+bool ConfigManager::load() {
+    std::ifstream probe(path);
+    if (!probe.is_open()) {
+        std::cout << "No configuration file at " << path << ", using defaults" << std::endl;
+        return true;
+    }
+    return reload();
+}
+
+bool ConfigManager::reload() {
+    std::unique_ptr<AgentConfig> config(new AgentConfig());
+    std::string error;
+    if (!AgentConfig::parse(path, *config, error)) {
+        failed_reloads.fetch_add(1, std::memory_order_relaxed);
+        std::cerr << "Configuration not applied, keeping the previous one: " << error << std::endl;
+        return false;
+    }
+    config->version = next_version.fetch_add(1, std::memory_order_relaxed);
+    uint64_t version = config->version;
+
+    // The loop may still be reading the old one; it is freed on reclaim()
+    const AgentConfig* previous = active.exchange(config.release(), std::memory_order_acq_rel);
+    {
+        std::lock_guard<std::mutex> lock(retired_mutex);
+        retired.push_back(previous);
+    }
+    has_retired.store(true, std::memory_order_release);
+
+    std::cout << "Loaded configuration " << path << " (version " << version << ")" << std::endl;
+    return true;
+}
+
+bool ConfigManager::start() {
+#ifdef PLATFORM_WINDOWS
+    return false; // No SIGHUP; the file is read once at startup
+#else
+    if (watcher.joinable()) {
+        return true;
+    }
+    stopping.store(false);
+    watcher = std::thread(&ConfigManager::watch, this);
+    return true;
+#endif
+}
+
+void ConfigManager::watch() {
+#ifndef PLATFORM_WINDOWS
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGHUP);
+
+    while (true) {
+        int signal_number = 0;
+        if (sigwait(&signals, &signal_number) != 0) {
+            continue;
+        }
+        if (stopping.load()) {
+            return;
+        }
+        reload();
+    }
+#endif
+}
+
+void ConfigManager::stop() {
+#ifndef PLATFORM_WINDOWS
+    if (!watcher.joinable()) {
+        return;
+    }
+    stopping.store(true);
+    pthread_kill(watcher.native_handle(), SIGHUP); // Wakes sigwait
+    watcher.join();
+#endif
+}
+
+const AgentConfig& ConfigManager::current() const {
+    return *active.load(std::memory_order_acquire);
+}
+
+void ConfigManager::reclaim() {
+    if (!has_retired.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(retired_mutex);
+    has_retired.store(false, std::memory_order_relaxed);
+    for (const AgentConfig* config : retired) {
+        delete config;
+    }
+    retired.clear();
+}
+
+uint64_t ConfigManager::failedReloads() const {
+    return failed_reloads.load(std::memory_order_relaxed);
+}
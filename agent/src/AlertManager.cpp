@@ -0,0 +1,206 @@
+#include "../include/AlertManager.h"
+#include "../include/StateFile.h"
+
+AlertManager::AlertManager() : total_suppressed(0) {
+    // Resolve after a few quiet seconds, re-notify every 5 minutes
+    default_policy.renotify_interval = 300;
+    default_policy.resolve_after = 5;
+    default_policy.max_per_minute = 30;
+}
+
+AlertManager::~AlertManager() {
+    // Cleanup if needed
+}
+
+std::string AlertManager::makeKey(const std::string& type, const std::string& entity) {
+    return type + '\x1f' + entity;
+}
+
+const AlertPolicy& AlertManager::policyFor(const std::string& type) const {
+    auto it = policies.find(type);
+    return it != policies.end() ? it->second : default_policy;
+}
+
+bool AlertManager::allowNotification(const std::string& type, time_t now) {
+    const AlertPolicy& policy = policyFor(type);
+    if (policy.max_per_minute <= 0) {
+        return true;
+    }
+
+    RateWindow& window = rate_windows[type];
+    if (now - window.window_start >= 60) {
+        window.window_start = now;
+        window.sent = 0;
+        window.suppressed = 0;
+    }
+
+    if (window.sent >= policy.max_per_minute) {
+        window.suppressed++;
+        total_suppressed++;
+        return false;
+    }
+
+    window.sent++;
+    return true;
+}
+
+AnomalyAlert AlertManager::makeNotification(const TrackedAlert& entry, const std::string& state, time_t now) const {
+    AnomalyAlert notification = entry.alert;
+    notification.state = state;
+    notification.occurrences = entry.occurrences;
+
+    if (state != "OPEN") {
+        notification.details += ", State: " + state +
+                                ", Occurrences: " + std::to_string(entry.occurrences) +
+                                ", Duration: " + std::to_string(now - entry.first_seen) + "s";
+    }
+    if (state == "RESOLVED") {
+        notification.severity = "INFO";
+        notification.message = "Resolved: " + notification.message;
+    }
+
+    return notification;
+}
+
+void AlertManager::observe(const AnomalyAlert& alert, time_t now) {
+    std::string key = makeKey(alert.type, alert.entity);
+    auto it = tracked.find(key);
+
+    if (it == tracked.end()) {
+        TrackedAlert entry;
+        entry.alert = alert;
+        entry.first_seen = now;
+        entry.last_seen = now;
+        entry.last_notified = 0;
+        entry.occurrences = 1;
+        entry.unreported = 1;
+        entry.observed_this_cycle = true;
+        tracked.emplace(std::move(key), std::move(entry));
+        return;
+    }
+
+    // Keep the latest message and details, aggregate the count
+    TrackedAlert& entry = it->second;
+    entry.alert.message = alert.message;
+    entry.alert.details = alert.details;
+    entry.alert.severity = alert.severity;
+    entry.last_seen = now;
+    entry.occurrences++;
+    entry.unreported++;
+    entry.observed_this_cycle = true;
+}
+
+std::vector<AnomalyAlert> AlertManager::collectTransitions(time_t now) {
+    std::vector<AnomalyAlert> transitions;
+
+    for (auto it = tracked.begin(); it != tracked.end(); ) {
+        TrackedAlert& entry = it->second;
+        const AlertPolicy& policy = policyFor(entry.alert.type);
+
+        if (!entry.observed_this_cycle && now - entry.last_seen >= policy.resolve_after) {
+            // Alerts that were never announced are dropped silently
+            if (entry.last_notified != 0) {
+                transitions.push_back(makeNotification(entry, "RESOLVED", now));
+            }
+            it = tracked.erase(it);
+            continue;
+        }
+
+        if (entry.last_notified == 0) {
+            if (allowNotification(entry.alert.type, now)) {
+                transitions.push_back(makeNotification(entry, "OPEN", now));
+                entry.last_notified = now;
+                entry.unreported = 0;
+            }
+        } else if (policy.renotify_interval > 0 && entry.unreported > 0 &&
+                   now - entry.last_notified >= policy.renotify_interval) {
+            if (allowNotification(entry.alert.type, now)) {
+                transitions.push_back(makeNotification(entry, "ONGOING", now));
+                entry.last_notified = now;
+                entry.unreported = 0;
+            }
+        }
+
+        entry.observed_this_cycle = false;
+        ++it;
+    }
+
+    return transitions;
+}
+
+bool AlertManager::isActive(const std::string& type, const std::string& entity) const {
+    return tracked.find(makeKey(type, entity)) != tracked.end();
+}
+
+size_t AlertManager::activeCount() const {
+    return tracked.size();
+}
+
+long AlertManager::suppressedCount() const {
+    return total_suppressed;
+}
+
+void AlertManager::setPolicy(const std::string& type, const AlertPolicy& policy) {
+    policies[type] = policy;
+}
+
+void AlertManager::setDefaultPolicy(const AlertPolicy& policy) {
+    default_policy = policy;
+}
+
+void AlertManager::saveState(StateWriter& out) const {
+    out.putSigned(total_suppressed);
+    out.putVarint(tracked.size());
+    for (const auto& pair : tracked) {
+        const TrackedAlert& entry = pair.second;
+        out.putString(pair.first);
+        out.putString(entry.alert.type);
+        out.putString(entry.alert.severity);
+        out.putString(entry.alert.message);
+        out.putString(entry.alert.details);
+        out.putString(entry.alert.timestamp);
+        out.putString(entry.alert.entity);
+        out.putSigned(entry.alert.pid);
+        out.putString(entry.alert.state);
+        out.putSigned(entry.alert.occurrences);
+        out.putSigned(entry.first_seen);
+        out.putSigned(entry.last_seen);
+        out.putSigned(entry.last_notified);
+        out.putSigned(entry.occurrences);
+        out.putSigned(entry.unreported);
+    }
+}
+
+bool AlertManager::loadState(StateReader& in) {
+    long suppressed = static_cast<long>(in.getSigned());
+    uint64_t count = in.getVarint();
+
+    std::unordered_map<std::string, TrackedAlert> loaded;
+    for (uint64_t n = 0; n < count && in.ok(); n++) {
+        std::string key = in.getString();
+        TrackedAlert entry;
+        entry.alert.type = in.getString();
+        entry.alert.severity = in.getString();
+        entry.alert.message = in.getString();
+        entry.alert.details = in.getString();
+        entry.alert.timestamp = in.getString();
+        entry.alert.entity = in.getString();
+        entry.alert.pid = static_cast<int>(in.getSigned());
+        entry.alert.state = in.getString();
+        entry.alert.occurrences = static_cast<int>(in.getSigned());
+        entry.first_seen = static_cast<time_t>(in.getSigned());
+        entry.last_seen = static_cast<time_t>(in.getSigned());
+        entry.last_notified = static_cast<time_t>(in.getSigned());
+        entry.occurrences = static_cast<int>(in.getSigned());
+        entry.unreported = static_cast<int>(in.getSigned());
+        entry.observed_this_cycle = false;
+        loaded[key] = entry;
+    }
+    if (!in.ok()) {
+        return false;
+    }
+
+    tracked.swap(loaded);
+    total_suppressed = suppressed;
+    return true;
+}
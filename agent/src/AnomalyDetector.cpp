@@ -1,53 +1,96 @@
 #include "../include/AnomalyDetector.h"
+#include "../include/StateFile.h"
 #include <algorithm>
+#include <cstring>
 #include <numeric>
 #include <ctime>
+#include <chrono>
 #include <fstream>
 #include <sstream>
 
+// Unusual or suspicious ports, built at compile time
+static constexpr PortBitmap default_suspicious_ports = {
+    4444, 5555, 6666, 7777, 8888, 9999, // Common backdoor ports
+    1234, 12345, 54321, // Simple sequential ports often used by malware
+    31337, 1337, // Leet speak ports
+    6667, 6668, 6669, // IRC ports sometimes used by botnets
+    8080, 9000, 9001 // Alternative HTTP ports that might be suspicious
+};
+
+// Substrings of common system process names
+static const char* const common_process_patterns[] = {
+    "init", "kthreadd", "ksoftirqd", "systemd", "bash", "sh", "ssh", "sshd",
+    "dbus", "networkd", "resolved", "cron", "rsyslog", "kernel", "migration"
+};
+
+// A shell below one of these is how a web or database exploit usually shows up
+static const char* const shell_processes[] = {
+    "sh", "bash", "dash", "zsh", "ksh", "ash", "fish", "pwsh", "powershell.exe", "cmd.exe"
+};
+
+static const char* const server_processes[] = {
+    "nginx", "httpd", "apache2", "php-fpm", "lighttpd", "caddy", "gunicorn", "uwsgi",
+    "java", "node", "mysqld", "mariadbd", "postgres", "redis-server", "mongod"
+};
+
+// With allow_suffix, versioned names such as php-fpm8.2 match "php-fpm"
+static bool nameIn(const std::string& name, const char* const* names, size_t count, bool allow_suffix) {
+    for (size_t i = 0; i < count; i++) {
+        size_t length = std::strlen(names[i]);
+        if (name.compare(0, length, names[i]) == 0 && (allow_suffix || name.size() == length)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int64_t monotonicSeconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 AnomalyDetector::AnomalyDetector() 
-    : high_cpu_threshold(80.0), high_memory_threshold(1024 * 1024), // 1GB in KB
-      max_new_processes_per_minute(10), max_new_connections_per_minute(50),
-      new_processes_count(0), new_connections_count(0), last_reset_time(time(nullptr)) {
+    : sketch_aging_cycles(3600), learning_cycles(0),
+      suspicious_ports(default_suspicious_ports) {
     
     // Initialize with reasonable defaults
+    updateConfiguration(DetectorThresholds());
     cpu_history.reserve(100);
     memory_history.reserve(100);
+    
+    for (const char* pattern : common_process_patterns) {
+        system_process_patterns.addPattern(pattern);
+    }
+    system_process_patterns.build();
+    
+    // One-off findings are reported once and never re-notified
+    AlertPolicy once_policy = {0, 60, 30};
+    alert_manager.setPolicy("UNKNOWN_PROCESS", once_policy);
+    alert_manager.setPolicy("EXTERNAL_CONNECTION", once_policy);
+    alert_manager.setPolicy("SUSPICIOUS_PORT", once_policy);
 }
 
 AnomalyDetector::~AnomalyDetector() {
     // Cleanup if needed
 }
 
-bool AnomalyDetector::isUnknownProcess(const ProcessInfo& process) {
-    // Check if this is a known process based on common system processes
-    std::vector<std::string> common_processes = {
-        "init", "kthreadd", "ksoftirqd", "systemd", "bash", "sh", "ssh", "sshd",
-        "dbus", "networkd", "resolved", "cron", "rsyslog", "kernel", "migration"
-    };
+bool AnomalyDetector::isUnknownProcess(const ProcessInfo& process, uint32_t sightings) {
+    // Names seen often enough recently are part of the normal workload
+    if (sightings > rare_process_threshold) {
+        return false;
+    }
     
-    // Check if process name contains any known patterns
-    for (const auto& known : common_processes) {
-        if (process.name.find(known) != std::string::npos) {
-            return false;
-        }
+    // Check if process name contains any common system process pattern
+    if (system_process_patterns.matchesAny(process.name)) {
+        return false;
     }
     
-    // Check against our learned known processes
-    return known_processes.find(process.name) == known_processes.end();
+    // Check against the configured whitelist
+    return !std::binary_search(whitelisted_processes.begin(), whitelisted_processes.end(), process.name);
 }
 
 bool AnomalyDetector::isSuspiciousPort(int port) {
-    // Check for unusual or suspicious ports
-    std::vector<int> suspicious_ports = {
-        4444, 5555, 6666, 7777, 8888, 9999, // Common backdoor ports
-        1234, 12345, 54321, // Simple sequential ports often used by malware
-        31337, 1337, // Leet speak ports
-        6667, 6668, 6669, // IRC ports sometimes used by botnets
-        8080, 8888, 9000, 9001 // Alternative HTTP ports that might be suspicious
-    };
-    
-    return std::find(suspicious_ports.begin(), suspicious_ports.end(), port) != suspicious_ports.end();
+    return suspicious_ports.contains(port);
 }
 
 bool AnomalyDetector::isRapidMemoryIncrease(long current_memory) {
@@ -92,42 +135,92 @@ bool AnomalyDetector::isRapidCpuSpike(double current_cpu) {
     return is_rapid_spike;
 }
 
-void AnomalyDetector::updateBaselines(const std::vector<ProcessInfo>& processes) {
-    // Update known processes
-    for (const auto& process : processes) {
-        known_processes[process.name]++;
+void AnomalyDetector::updateBaselines() {
+    // Periodically halve sighting counts so names that stop running become rare again
+    if (++learning_cycles % sketch_aging_cycles == 0) {
+        process_frequency.age();
+    }
+}
+
+bool AnomalyDetector::exceeds(double value, double threshold, const std::string& type, const std::string& entity) const {
+    if (value > threshold) {
+        return true;
+    }
+    // An open alert stays open until the value drops clearly below the threshold
+    return value > threshold * hysteresis_ratio && alert_manager.isActive(type, entity);
+}
+
+bool AnomalyDetector::isCpuDeviation(const BaselineDeviation& baseline, double cpu_usage, const std::string& entity) const {
+    if (!baseline.established) {
+        return false;
+    }
+    // Require an absolute jump too, so near-constant processes don't alert on noise
+    double threshold = deviation_threshold;
+    if (alert_manager.isActive("PROCESS_CPU_DEVIATION", entity)) {
+        threshold /= 2.0;
+    }
+    return baseline.cpu_score > threshold && cpu_usage - baseline.cpu_mean > 10.0;
+}
+
+bool AnomalyDetector::isMemoryDeviation(const BaselineDeviation& baseline, long memory_usage, const std::string& entity) const {
+    if (!baseline.established) {
+        return false;
+    }
+    double threshold = deviation_threshold;
+    if (alert_manager.isActive("PROCESS_MEMORY_DEVIATION", entity)) {
+        threshold /= 2.0;
+    }
+    double min_increase = std::max(50.0 * 1024, baseline.memory_mean * 0.2); // 50MB or 20%
+    return baseline.memory_score > threshold && memory_usage - baseline.memory_mean > min_increase;
+}
+
+void AnomalyDetector::markHot(std::vector<std::string>& hot, const std::string& key) {
+    // Bounded so an entity storm cannot grow the list
+    if (hot.size() < MAX_HOT_ENTITIES && std::find(hot.begin(), hot.end(), key) == hot.end()) {
+        hot.push_back(key);
     }
 }
 
-void AnomalyDetector::resetCounters() {
-    time_t current_time = time(nullptr);
-    if (current_time - last_reset_time >= 60) { // Reset every minute
-        new_processes_count = 0;
-        new_connections_count = 0;
-        last_reset_time = current_time;
+void AnomalyDetector::trackAlerts(const std::vector<AnomalyAlert>& alerts) {
+    time_t now = time(nullptr);
+    for (const auto& alert : alerts) {
+        alert_manager.observe(alert, now);
     }
 }
 
 std::vector<AnomalyAlert> AnomalyDetector::checkProcessAnomalies(const std::vector<ProcessInfo>& processes) {
     std::vector<AnomalyAlert> alerts;
-    resetCounters();
+    process_baselines.beginCycle();
     
     for (const auto& process : processes) {
+        std::string entity = process.name + "/" + std::to_string(process.pid);
+        uint32_t sightings = process_frequency.add(process.name);
+        BaselineDeviation baseline = process_baselines.update(process.name, process.cpu_usage, process.memory_usage,
+                                                                 process.has_cpu_usage);
+        
+        // Processes that normally run hot are judged by deviation, not static thresholds
+        bool habitual_cpu = baseline.established && baseline.cpu_mean > high_cpu_threshold * hysteresis_ratio;
+        bool habitual_memory = baseline.established && baseline.memory_mean > high_memory_threshold * hysteresis_ratio;
+        
         // Check for high CPU usage
-        if (process.cpu_usage > high_cpu_threshold) {
+        if (!habitual_cpu && exceeds(process.cpu_usage, high_cpu_threshold, "HIGH_CPU", entity)) {
             AnomalyAlert alert;
             alert.type = "HIGH_CPU";
+            alert.entity = entity;
+            alert.pid = process.pid;
             alert.severity = "WARNING";
             alert.message = "Process " + process.name + " using excessive CPU";
             alert.details = "PID: " + std::to_string(process.pid) + ", CPU: " + std::to_string(process.cpu_usage) + "%";
-            alert.timestamp = ""; // Will be set by logger
+            alert.timestamp = ""; // Events carry the observation time (AgentEvent::time_ns)
             alerts.push_back(alert);
         }
         
         // Check for high memory usage
-        if (process.memory_usage > high_memory_threshold) {
+        if (!habitual_memory && exceeds(process.memory_usage, high_memory_threshold, "HIGH_MEMORY", entity)) {
             AnomalyAlert alert;
             alert.type = "HIGH_MEMORY";
+            alert.entity = entity;
+            alert.pid = process.pid;
             alert.severity = "WARNING";
             alert.message = "Process " + process.name + " using excessive memory";
             alert.details = "PID: " + std::to_string(process.pid) + ", Memory: " + std::to_string(process.memory_usage) + " KB";
@@ -135,21 +228,87 @@ std::vector<AnomalyAlert> AnomalyDetector::checkProcessAnomalies(const std::vect
             alerts.push_back(alert);
         }
         
-        // Check for unknown processes
-        if (isUnknownProcess(process)) {
+        // Check for deviation from this process name's own baseline
+        if (isCpuDeviation(baseline, process.cpu_usage, entity)) {
+            AnomalyAlert alert;
+            alert.type = "PROCESS_CPU_DEVIATION";
+            alert.entity = entity;
+            alert.pid = process.pid;
+            alert.severity = "WARNING";
+            alert.message = "Process " + process.name + " CPU far above its baseline";
+            alert.details = "PID: " + std::to_string(process.pid) + ", CPU: " + std::to_string(process.cpu_usage) +
+                           "%, Baseline: " + std::to_string(baseline.cpu_mean) + "%";
+            alert.timestamp = "";
+            alerts.push_back(alert);
+        }
+        
+        if (isMemoryDeviation(baseline, process.memory_usage, entity)) {
+            AnomalyAlert alert;
+            alert.type = "PROCESS_MEMORY_DEVIATION";
+            alert.entity = entity;
+            alert.pid = process.pid;
+            alert.severity = "WARNING";
+            alert.message = "Process " + process.name + " memory far above its baseline";
+            alert.details = "PID: " + std::to_string(process.pid) + ", Memory: " + std::to_string(process.memory_usage) +
+                           " KB, Baseline: " + std::to_string(static_cast<long>(baseline.memory_mean)) + " KB";
+            alert.timestamp = "";
+            alerts.push_back(alert);
+        }
+        
+        // Check for processes hammering storage or starved of CPU; only the
+        // hot processes the monitor samples carry these figures
+        if (process.has_io_stats) {
+            double io_rate = process.read_bytes_rate + process.write_bytes_rate;
+            if (exceeds(io_rate, max_process_io_rate, "HIGH_DISK_IO", entity)) {
+                AnomalyAlert alert;
+                alert.type = "HIGH_DISK_IO";
+                alert.entity = entity;
+                alert.pid = process.pid;
+                alert.severity = "WARNING";
+                alert.message = "Process " + process.name + " generating heavy disk I/O";
+                alert.details = "PID: " + std::to_string(process.pid) + ", Read: " + 
+                               std::to_string(static_cast<long>(process.read_bytes_rate)) + " B/s, Write: " + 
+                               std::to_string(static_cast<long>(process.write_bytes_rate)) + " B/s";
+                alert.timestamp = "";
+                alerts.push_back(alert);
+            }
+            
+            if (exceeds(process.run_delay_ms, max_run_delay_ms, "RUN_QUEUE_DELAY", entity)) {
+                AnomalyAlert alert;
+                alert.type = "RUN_QUEUE_DELAY";
+                alert.entity = entity;
+                alert.pid = process.pid;
+                alert.severity = "WARNING";
+                alert.message = "Process " + process.name + " waiting on the CPU run queue";
+                alert.details = "PID: " + std::to_string(process.pid) + ", Run delay: " + 
+                               std::to_string(process.run_delay_ms) + " ms/s, CPU: " + 
+                               std::to_string(process.cpu_usage) + "%";
+                alert.timestamp = "";
+                alerts.push_back(alert);
+            }
+        }
+        
+        // Check for unknown processes. A reported one stays open while it
+        // runs, even once its name has been seen often enough to count as
+        // familiar; only its exit resolves the alert
+        if (isUnknownProcess(process, sightings) || alert_manager.isActive("UNKNOWN_PROCESS", process.name)) {
             AnomalyAlert alert;
             alert.type = "UNKNOWN_PROCESS";
+            alert.entity = process.name;
+            alert.pid = process.pid;
             alert.severity = "INFO";
             alert.message = "Unknown process detected: " + process.name;
-            alert.details = "PID: " + std::to_string(process.pid) + ", Command: " + process.command;
+            alert.details = "PID: " + std::to_string(process.pid) + ", Command: " + process.command +
+                           ", Sightings: " + std::to_string(sightings);
             alert.timestamp = "";
             alerts.push_back(alert);
         }
     }
     
     // Update baselines for learning
-    updateBaselines(processes);
+    updateBaselines();
     
+    trackAlerts(alerts);
     return alerts;
 }
 
@@ -161,6 +320,7 @@ std::vector<AnomalyAlert> AnomalyDetector::checkNetworkAnomalies(const std::vect
         if (isSuspiciousPort(connection.local_port)) {
             AnomalyAlert alert;
             alert.type = "SUSPICIOUS_PORT";
+            alert.entity = connection.protocol + ":" + std::to_string(connection.local_port);
             alert.severity = "WARNING";
             alert.message = "Suspicious port detected: " + std::to_string(connection.local_port);
             alert.details = "Protocol: " + connection.protocol + ", State: " + connection.state;
@@ -171,6 +331,7 @@ std::vector<AnomalyAlert> AnomalyDetector::checkNetworkAnomalies(const std::vect
         if (isSuspiciousPort(connection.remote_port)) {
             AnomalyAlert alert;
             alert.type = "SUSPICIOUS_PORT";
+            alert.entity = connection.protocol + ":" + connection.remote_ip + ":" + std::to_string(connection.remote_port);
             alert.severity = "WARNING";
             alert.message = "Connection to suspicious port: " + std::to_string(connection.remote_port);
             alert.details = "Remote IP: " + connection.remote_ip + ", Protocol: " + connection.protocol;
@@ -186,6 +347,8 @@ std::vector<AnomalyAlert> AnomalyDetector::checkNetworkAnomalies(const std::vect
             
             AnomalyAlert alert;
             alert.type = "EXTERNAL_CONNECTION";
+            alert.entity = connection.local_ip + ":" + std::to_string(connection.local_port) +
+                           "->" + connection.remote_ip + ":" + std::to_string(connection.remote_port);
             alert.severity = "INFO";
             alert.message = "External connection detected";
             alert.details = "Local: " + connection.local_ip + ":" + std::to_string(connection.local_port) + 
@@ -195,19 +358,332 @@ std::vector<AnomalyAlert> AnomalyDetector::checkNetworkAnomalies(const std::vect
         }
     }
     
-    new_connections_count += connections.size();
+    trackAlerts(alerts);
+    return alerts;
+}
+
+std::vector<AnomalyAlert> AnomalyDetector::checkProcessCreationRate(const std::vector<ProcessInfo>& new_processes) {
+    std::vector<AnomalyAlert> alerts;
+    int64_t now = monotonicSeconds();
+    
+    process_spawn_rate.add(now, static_cast<uint32_t>(new_processes.size()));
+    uint64_t spawned = process_spawn_rate.total(now);
+    
+    if (spawned > static_cast<uint64_t>(max_new_processes_per_minute)) {
+        AnomalyAlert alert;
+        alert.type = "RAPID_PROCESS_CREATION";
+        alert.entity = "system";
+        alert.severity = "WARNING";
+        alert.message = "Rapid process creation detected";
+        alert.details = "Count: " + std::to_string(spawned) + " processes in the last minute";
+        alert.timestamp = "";
+        alerts.push_back(alert);
+    }
+    
+    // Attribute spawns to their parent so a single forking process stands out
+    for (const auto& process : new_processes) {
+        std::string parent = std::to_string(process.parent_pid);
+        uint64_t children = spawns_per_parent.add(parent, now);
+        if (children > static_cast<uint64_t>(max_new_processes_per_minute)) {
+            markHot(hot_parents, parent);
+        }
+    }
+    
+    // Hot parents are re-checked every cycle until their window drains
+    for (size_t i = 0; i < hot_parents.size(); ) {
+        const std::string& parent = hot_parents[i];
+        uint64_t children = spawns_per_parent.total(parent, now);
+        if (children <= static_cast<uint64_t>(max_new_processes_per_minute)) {
+            hot_parents.erase(hot_parents.begin() + i);
+            continue;
+        }
+        
+        AnomalyAlert alert;
+        alert.type = "RAPID_PROCESS_CREATION";
+        alert.entity = "ppid:" + parent;
+        alert.severity = "WARNING";
+        alert.message = "Process " + parent + " spawning children rapidly";
+        alert.details = "Parent PID: " + parent + ", Count: " + std::to_string(children) + " children in the last minute";
+        alert.timestamp = "";
+        alerts.push_back(alert);
+        i++;
+    }
+    
+    trackAlerts(alerts);
+    return alerts;
+}
+
+std::vector<AnomalyAlert> AnomalyDetector::checkConnectionRate(const std::vector<NetworkConnection>& new_connections) {
+    std::vector<AnomalyAlert> alerts;
+    int64_t now = monotonicSeconds();
+    
+    connection_rate.add(now, static_cast<uint32_t>(new_connections.size()));
+    uint64_t opened = connection_rate.total(now);
     
     // Check for too many new connections
-    if (new_connections_count > max_new_connections_per_minute) {
+    if (opened > static_cast<uint64_t>(max_new_connections_per_minute)) {
         AnomalyAlert alert;
         alert.type = "RAPID_CONNECTIONS";
+        alert.entity = "system";
         alert.severity = "WARNING";
         alert.message = "Rapid network connections detected";
-        alert.details = "Count: " + std::to_string(new_connections_count) + " connections in the last minute";
+        alert.details = "Count: " + std::to_string(opened) + " connections in the last minute";
+        alert.timestamp = "";
+        alerts.push_back(alert);
+    }
+    
+    for (const auto& connection : new_connections) {
+        if (connection.remote_ip == "0.0.0.0") {
+            continue; // Listening sockets have no peer
+        }
+        uint64_t count = connections_per_remote.add(connection.remote_ip, now);
+        if (count > static_cast<uint64_t>(max_new_connections_per_minute)) {
+            markHot(hot_remotes, connection.remote_ip);
+        }
+    }
+    
+    for (size_t i = 0; i < hot_remotes.size(); ) {
+        const std::string& remote_ip = hot_remotes[i];
+        uint64_t count = connections_per_remote.total(remote_ip, now);
+        if (count <= static_cast<uint64_t>(max_new_connections_per_minute)) {
+            hot_remotes.erase(hot_remotes.begin() + i);
+            continue;
+        }
+        
+        AnomalyAlert alert;
+        alert.type = "RAPID_CONNECTIONS";
+        alert.entity = remote_ip;
+        alert.severity = "WARNING";
+        alert.message = "Rapid connections to " + remote_ip;
+        alert.details = "Remote IP: " + remote_ip + ", Count: " + std::to_string(count) + " connections in the last minute";
+        alert.timestamp = "";
+        alerts.push_back(alert);
+        i++;
+    }
+    
+    trackAlerts(alerts);
+    return alerts;
+}
+
+std::vector<AnomalyAlert> AnomalyDetector::checkSocketAnomalies(const std::vector<SocketStats>& sockets) {
+    std::vector<AnomalyAlert> alerts;
+    unsigned long total_retransmits = 0;
+    
+    for (const auto& socket : sockets) {
+        total_retransmits += socket.retrans_delta;
+        
+        // Check for a single connection retransmitting heavily
+        if (socket.retrans_delta > max_retransmits_per_socket) {
+            std::string remote = socket.remote_ip + ":" + std::to_string(socket.remote_port);
+            AnomalyAlert alert;
+            alert.type = "RETRANSMIT_STORM";
+            alert.entity = socket.local_ip + ":" + std::to_string(socket.local_port) + "->" + remote;
+            alert.severity = "WARNING";
+            alert.message = "Heavy TCP retransmission to " + remote;
+            alert.details = "Retransmits: " + std::to_string(socket.retrans_delta) + 
+                           ", RTT: " + std::to_string(socket.rtt_us) + " us, CWND: " + std::to_string(socket.snd_cwnd);
+            alert.timestamp = "";
+            alerts.push_back(alert);
+        }
+    }
+    
+    // Check for host-wide retransmission storms
+    if (total_retransmits > max_retransmits_total) {
+        AnomalyAlert alert;
+        alert.type = "RETRANSMIT_STORM";
+        alert.entity = "system";
+        alert.severity = "WARNING";
+        alert.message = "TCP retransmit storm detected";
+        alert.details = "Retransmits: " + std::to_string(total_retransmits) + " across " + 
+                       std::to_string(sockets.size()) + " sockets in the last interval";
         alert.timestamp = "";
         alerts.push_back(alert);
     }
     
+    trackAlerts(alerts);
+    return alerts;
+}
+
+std::vector<AnomalyAlert> AnomalyDetector::checkInterfaceAnomalies(const std::vector<InterfaceStats>& interfaces) {
+    std::vector<AnomalyAlert> alerts;
+    
+    for (const auto& iface : interfaces) {
+        // Check for links running close to their rated speed
+        if (iface.utilization >= 0.0 &&
+            exceeds(iface.utilization, interface_saturation_threshold, "INTERFACE_SATURATION", iface.name)) {
+            AnomalyAlert alert;
+            alert.type = "INTERFACE_SATURATION";
+            alert.entity = iface.name;
+            alert.severity = "WARNING";
+            alert.message = "Network interface " + iface.name + " near saturation";
+            alert.details = "Utilization: " + std::to_string(iface.utilization) + "% of " + 
+                           std::to_string(iface.link_speed_mbps) + " Mb/s, RX: " + 
+                           std::to_string(static_cast<long>(iface.rx_bytes_rate)) + " B/s, TX: " + 
+                           std::to_string(static_cast<long>(iface.tx_bytes_rate)) + " B/s";
+            alert.timestamp = "";
+            alerts.push_back(alert);
+        }
+        
+        // Check for packet drop spikes
+        if (exceeds(iface.drops_rate, max_interface_drops_per_second, "INTERFACE_DROPS", iface.name)) {
+            AnomalyAlert alert;
+            alert.type = "INTERFACE_DROPS";
+            alert.entity = iface.name;
+            alert.severity = "WARNING";
+            alert.message = "Packet drops on network interface " + iface.name;
+            alert.details = "Drops: " + std::to_string(iface.drops_rate) + "/s, Errors: " + 
+                           std::to_string(iface.errors_rate) + "/s";
+            alert.timestamp = "";
+            alerts.push_back(alert);
+        }
+    }
+    
+    trackAlerts(alerts);
+    return alerts;
+}
+
+std::vector<AnomalyAlert> AnomalyDetector::checkDiskAnomalies(const std::vector<DiskDeviceStats>& devices,
+                                                              const std::vector<MountUsage>& mounts) {
+    std::vector<AnomalyAlert> alerts;
+    
+    for (const auto& mount : mounts) {
+        // Check for filesystems running out of space or inodes
+        double fullest = mount.usage_percent > mount.inode_usage_percent ? mount.usage_percent : mount.inode_usage_percent;
+        if (exceeds(fullest, disk_full_threshold, "DISK_FULL", mount.mount_point)) {
+            AnomalyAlert alert;
+            alert.type = "DISK_FULL";
+            alert.entity = mount.mount_point;
+            alert.severity = fullest >= 98.0 ? "CRITICAL" : "WARNING";
+            alert.message = "Filesystem " + mount.mount_point + " nearly full";
+            alert.details = "Device: " + mount.device + ", Space: " + std::to_string(mount.usage_percent) + 
+                           "% (" + std::to_string(mount.available_bytes / (1024 * 1024)) + " MB free), Inodes: " + 
+                           std::to_string(mount.inode_usage_percent) + "%";
+            alert.timestamp = "";
+            alerts.push_back(alert);
+        }
+    }
+    
+    for (const auto& device : devices) {
+        // Check for block devices busy for most of the interval
+        if (exceeds(device.utilization, io_saturation_threshold, "IO_SATURATION", device.name)) {
+            AnomalyAlert alert;
+            alert.type = "IO_SATURATION";
+            alert.entity = device.name;
+            alert.severity = "WARNING";
+            alert.message = "Block device " + device.name + " saturated";
+            alert.details = "Utilization: " + std::to_string(device.utilization) + "%, Await: " + 
+                           std::to_string(device.await_ms) + " ms, Read: " + 
+                           std::to_string(static_cast<long>(device.read_bytes_rate)) + " B/s, Write: " + 
+                           std::to_string(static_cast<long>(device.write_bytes_rate)) + " B/s";
+            alert.timestamp = "";
+            alerts.push_back(alert);
+        }
+    }
+    
+    trackAlerts(alerts);
+    return alerts;
+}
+
+std::vector<AnomalyAlert> AnomalyDetector::checkCgroupAnomalies(const std::vector<CgroupStats>& cgroups) {
+    std::vector<AnomalyAlert> alerts;
+    
+    for (const auto& group : cgroups) {
+        std::string entity = group.container_id.empty() ? group.path : group.container_id;
+        std::string label = group.container_id.empty() ? "cgroup " + group.path : 
+                            "Container " + group.container_id.substr(0, 12);
+        
+        // Check for groups about to hit their memory limit (and the OOM killer)
+        if (group.memory_limit > 0) {
+            double memory_percent = static_cast<double>(group.memory_current) / group.memory_limit * 100.0;
+            if (exceeds(memory_percent, cgroup_memory_threshold, "CGROUP_MEMORY_LIMIT", entity)) {
+                AnomalyAlert alert;
+                alert.type = "CGROUP_MEMORY_LIMIT";
+                alert.entity = entity;
+                alert.severity = "WARNING";
+                alert.message = label + " close to its memory limit";
+                alert.details = "Path: " + group.path + ", Memory: " + std::to_string(group.memory_current / 1024) + 
+                               " KB of " + std::to_string(group.memory_limit / 1024) + " KB (" + 
+                               std::to_string(memory_percent) + "%), Anon: " + std::to_string(group.memory_anon / 1024) + " KB";
+                alert.timestamp = "";
+                alerts.push_back(alert);
+            }
+        }
+        
+        // Check for groups held back by their CPU quota
+        if (exceeds(group.throttled_percent, cgroup_throttle_threshold, "CGROUP_CPU_THROTTLED", entity)) {
+            AnomalyAlert alert;
+            alert.type = "CGROUP_CPU_THROTTLED";
+            alert.entity = entity;
+            alert.severity = "WARNING";
+            alert.message = label + " throttled by its CPU quota";
+            alert.details = "Path: " + group.path + ", Throttled: " + std::to_string(group.throttled_percent) + 
+                           "% of interval, CPU: " + std::to_string(group.cpu_usage) + "%";
+            alert.timestamp = "";
+            alerts.push_back(alert);
+        }
+    }
+    
+    trackAlerts(alerts);
+    return alerts;
+}
+
+std::vector<AnomalyAlert> AnomalyDetector::checkThreadAnomalies(const std::vector<ThreadInfo>& threads) {
+    std::vector<AnomalyAlert> alerts;
+    
+    for (const auto& thread : threads) {
+        std::string entity = thread.process_name + "/" + std::to_string(thread.pid) + "/" + std::to_string(thread.tid);
+        if (exceeds(thread.cpu_usage, high_thread_cpu_threshold, "HIGH_THREAD_CPU", entity)) {
+            AnomalyAlert alert;
+            alert.type = "HIGH_THREAD_CPU";
+            alert.entity = entity;
+            alert.pid = thread.pid;
+            alert.severity = "WARNING";
+            alert.message = "Thread " + thread.name + " of process " + thread.process_name + " using excessive CPU";
+            alert.details = "PID: " + std::to_string(thread.pid) + ", TID: " + std::to_string(thread.tid) + 
+                           ", CPU: " + std::to_string(thread.cpu_usage) + "% of one CPU";
+            alert.timestamp = "";
+            alerts.push_back(alert);
+        }
+    }
+    
+    trackAlerts(alerts);
+    return alerts;
+}
+
+std::vector<AnomalyAlert> AnomalyDetector::checkProcessLineage(const std::vector<ProcessInfo>& new_processes,
+                                                               const ProcessTree& tree) {
+    std::vector<AnomalyAlert> alerts;
+    const size_t shell_count = sizeof(shell_processes) / sizeof(shell_processes[0]);
+    const size_t server_count = sizeof(server_processes) / sizeof(server_processes[0]);
+    
+    for (const auto& process : new_processes) {
+        if (!nameIn(process.name, shell_processes, shell_count, false)) {
+            continue;
+        }
+        
+        // Servers usually sit a few levels up (worker, then sh -c, then the shell)
+        std::string chain = process.name;
+        for (const ProcessTreeNode* ancestor : tree.ancestors(process.pid, MAX_LINEAGE_DEPTH)) {
+            chain += " <- " + ancestor->name + "(" + std::to_string(ancestor->pid) + ")";
+            if (!nameIn(ancestor->name, server_processes, server_count, true)) {
+                continue;
+            }
+            
+            AnomalyAlert alert;
+            alert.type = "SUSPICIOUS_PROCESS_LINEAGE";
+            alert.entity = process.name + ":" + std::to_string(process.pid);
+            alert.severity = "CRITICAL";
+            alert.message = "Shell spawned by server process: " + ancestor->name;
+            alert.details = "PID: " + std::to_string(process.pid) + ", Command: " + process.command + 
+                           ", Lineage: " + chain;
+            alert.timestamp = "";
+            alert.pid = process.pid;
+            alerts.push_back(alert);
+            break;
+        }
+    }
+    
+    trackAlerts(alerts);
     return alerts;
 }
 
@@ -218,6 +694,7 @@ std::vector<AnomalyAlert> AnomalyDetector::checkSystemAnomalies(double cpu_usage
     if (isRapidCpuSpike(cpu_usage)) {
         AnomalyAlert alert;
         alert.type = "CPU_SPIKE";
+        alert.entity = "system";
         alert.severity = "WARNING";
         alert.message = "Rapid CPU usage increase detected";
         alert.details = "Current CPU: " + std::to_string(cpu_usage) + "%";
@@ -229,6 +706,7 @@ std::vector<AnomalyAlert> AnomalyDetector::checkSystemAnomalies(double cpu_usage
     if (isRapidMemoryIncrease(memory_usage)) {
         AnomalyAlert alert;
         alert.type = "MEMORY_SPIKE";
+        alert.entity = "system";
         alert.severity = "WARNING";
         alert.message = "Rapid memory usage increase detected";
         alert.details = "Current Memory: " + std::to_string(memory_usage) + " KB";
@@ -237,9 +715,10 @@ std::vector<AnomalyAlert> AnomalyDetector::checkSystemAnomalies(double cpu_usage
     }
     
     // Check for overall high system resource usage
-    if (cpu_usage > 90.0) {
+    if (exceeds(cpu_usage, 90.0, "SYSTEM_OVERLOAD", "system")) {
         AnomalyAlert alert;
         alert.type = "SYSTEM_OVERLOAD";
+        alert.entity = "system";
         alert.severity = "CRITICAL";
         alert.message = "System CPU overload detected";
         alert.details = "CPU Usage: " + std::to_string(cpu_usage) + "%";
@@ -247,9 +726,22 @@ std::vector<AnomalyAlert> AnomalyDetector::checkSystemAnomalies(double cpu_usage
         alerts.push_back(alert);
     }
     
+    trackAlerts(alerts);
     return alerts;
 }
 
+std::vector<AnomalyAlert> AnomalyDetector::collectAlertTransitions() {
+    return alert_manager.collectTransitions(time(nullptr));
+}
+
+void AnomalyDetector::setAlertPolicy(const std::string& type, const AlertPolicy& policy) {
+    alert_manager.setPolicy(type, policy);
+}
+
+long AnomalyDetector::suppressedAlerts() const {
+    return alert_manager.suppressedCount();
+}
+
 void AnomalyDetector::updateConfiguration(double cpu_thresh, long mem_thresh, int proc_rate, int conn_rate) {
     high_cpu_threshold = cpu_thresh;
     high_memory_threshold = mem_thresh;
@@ -257,16 +749,109 @@ void AnomalyDetector::updateConfiguration(double cpu_thresh, long mem_thresh, in
     max_new_connections_per_minute = conn_rate;
 }
 
+void AnomalyDetector::updateConfiguration(const DetectorThresholds& thresholds) {
+    high_cpu_threshold = thresholds.high_cpu_threshold;
+    high_memory_threshold = thresholds.high_memory_threshold;
+    max_new_processes_per_minute = thresholds.max_new_processes_per_minute;
+    max_new_connections_per_minute = thresholds.max_new_connections_per_minute;
+    max_retransmits_per_socket = thresholds.max_retransmits_per_socket;
+    max_retransmits_total = thresholds.max_retransmits_total;
+    interface_saturation_threshold = thresholds.interface_saturation_threshold;
+    max_interface_drops_per_second = thresholds.max_interface_drops_per_second;
+    disk_full_threshold = thresholds.disk_full_threshold;
+    io_saturation_threshold = thresholds.io_saturation_threshold;
+    cgroup_memory_threshold = thresholds.cgroup_memory_threshold;
+    cgroup_throttle_threshold = thresholds.cgroup_throttle_threshold;
+    high_thread_cpu_threshold = thresholds.high_thread_cpu_threshold;
+    hysteresis_ratio = thresholds.hysteresis_ratio;
+    deviation_threshold = thresholds.deviation_threshold;
+    max_process_io_rate = thresholds.max_process_io_rate;
+    max_run_delay_ms = thresholds.max_run_delay_ms;
+    rare_process_threshold = thresholds.rare_process_threshold;
+}
+
 void AnomalyDetector::loadKnownProcesses(const std::string& whitelist_file) {
+    readKnownProcesses(whitelist_file, whitelisted_processes);
+}
+
+bool AnomalyDetector::loadSuspiciousPorts(const std::string& port_file) {
+    return suspicious_ports.loadFromFile(port_file);
+}
+
+void AnomalyDetector::setKnownProcesses(const std::vector<std::string>& names) {
+    whitelisted_processes = names;
+}
+
+void AnomalyDetector::setSuspiciousPorts(const PortBitmap& ports) {
+    suspicious_ports = ports;
+}
+
+void AnomalyDetector::saveState(StateWriter& out) const {
+    out.putVarint(learning_cycles);
+    out.putVarint(cpu_history.size());
+    for (double cpu : cpu_history) {
+        out.putDouble(cpu);
+    }
+    out.putVarint(memory_history.size());
+    for (long memory : memory_history) {
+        out.putSigned(memory);
+    }
+    process_baselines.saveState(out);
+    process_frequency.saveState(out);
+    alert_manager.saveState(out);
+}
+
+bool AnomalyDetector::loadState(StateReader& in) {
+    uint64_t cycles = in.getVarint();
+    std::vector<double> cpu;
+    for (uint64_t n = in.getVarint(); n > 0 && in.ok(); n--) {
+        cpu.push_back(in.getDouble());
+    }
+    std::vector<long> memory;
+    for (uint64_t n = in.getVarint(); n > 0 && in.ok(); n--) {
+        memory.push_back(static_cast<long>(in.getSigned()));
+    }
+    if (!in.ok()) {
+        return false;
+    }
+    
+    // Loaded into copies (which keep their sizes and policies) and swapped in
+    // together, so a damaged section leaves the detector as it was
+    ProcessBaselines baselines = process_baselines;
+    FrequencySketch frequency = process_frequency;
+    AlertManager alerts = alert_manager;
+    if (!baselines.loadState(in) || !frequency.loadState(in) || !alerts.loadState(in)) {
+        return false;
+    }
+    learning_cycles = cycles;
+    cpu_history.swap(cpu);
+    memory_history.swap(memory);
+    process_baselines = std::move(baselines);
+    process_frequency = std::move(frequency);
+    alert_manager = std::move(alerts);
+    return true;
+}
+
+const PortBitmap& AnomalyDetector::defaultSuspiciousPorts() {
+    return default_suspicious_ports;
+}
+
+bool AnomalyDetector::readKnownProcesses(const std::string& whitelist_file, std::vector<std::string>& names) {
     std::ifstream file(whitelist_file);
     if (!file.is_open()) {
-        return;
+        return false;
     }
     
     std::string line;
     while (std::getline(file, line)) {
+        line.erase(line.find_last_not_of(" \t\r") + 1);
         if (!line.empty() && line[0] != '#') { // Skip comments
-            known_processes[line] = 1;
+            names.push_back(line);
         }
     }
+    
+    // Kept sorted and unique for binary search
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    return true;
 }
\ No newline at end of file
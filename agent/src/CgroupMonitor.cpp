@@ -0,0 +1,342 @@
+#include "../include/CgroupMonitor.h"
+#include "../include/PlatformUtils.h"
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_MACOS)
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <dirent.h>
+    #include <sys/inotify.h>
+#endif
+
+CgroupMonitor::CgroupMonitor() : inotify_fd(-1), needs_walk(true), truncated(false), limit_reported(false) {
+    read_buffer.resize(4096);
+    mount_point = findMountPoint();
+}
+
+CgroupMonitor::~CgroupMonitor() {
+    closeGroups(groups);
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_MACOS)
+    if (inotify_fd >= 0) {
+        close(inotify_fd);
+    }
+#endif
+}
+
+std::string CgroupMonitor::containerId(const std::string& path) {
+    size_t slash = path.rfind('/');
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+
+    // systemd driver: docker-<id>.scope, cri-containerd-<id>.scope, crio-<id>.scope, libpod-<id>.scope;
+    // cgroupfs driver: the bare id
+    const std::string suffix = ".scope";
+    if (name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+        name.erase(name.size() - suffix.size());
+    }
+    size_t dash = name.rfind('-');
+    if (dash != std::string::npos) {
+        name.erase(0, dash + 1);
+    }
+
+    if (name.size() < 12) {
+        return "";
+    }
+    for (char c : name) {
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) {
+            return "";
+        }
+    }
+    return name;
+}
+
+void CgroupMonitor::attributeProcesses(const std::vector<ProcessInfo>& processes, std::vector<CgroupStats>& stats) {
+    std::unordered_map<std::string, size_t> index;
+    index.reserve(stats.size());
+    std::vector<double> top_cpu(stats.size(), -1.0);
+    for (size_t i = 0; i < stats.size(); i++) {
+        stats[i].process_count = 0;
+        stats[i].top_process.clear();
+        index[stats[i].path] = i;
+    }
+
+    for (const auto& process : processes) {
+        if (process.cgroup.empty()) {
+            continue;
+        }
+        auto it = index.find(process.cgroup);
+        if (it == index.end()) {
+            continue;
+        }
+        CgroupStats& group = stats[it->second];
+        group.process_count++;
+        if (process.cpu_usage > top_cpu[it->second]) {
+            top_cpu[it->second] = process.cpu_usage;
+            group.top_process = process.name;
+        }
+    }
+}
+
+#if defined(PLATFORM_WINDOWS) || defined(PLATFORM_MACOS)
+
+std::string CgroupMonitor::findMountPoint() {
+    return "";
+}
+
+bool CgroupMonitor::hierarchyChanged() {
+    return false;
+}
+
+void CgroupMonitor::walk() {
+}
+
+void CgroupMonitor::walkDirectory(int dir_fd, const std::string& path, int depth, std::vector<CgroupEntry>& found) {
+    (void)dir_fd;
+    (void)path;
+    (void)depth;
+    (void)found;
+}
+
+void CgroupMonitor::closeGroups(std::vector<CgroupEntry>& entries) {
+    entries.clear();
+}
+
+bool CgroupMonitor::collect(std::vector<CgroupStats>& stats) {
+    // cgroups are Linux-specific
+    stats.clear();
+    return false;
+}
+
+#else
+
+std::string CgroupMonitor::findMountPoint() {
+    // Hybrid hosts mount the unified hierarchy somewhere under /sys/fs/cgroup
+    std::ifstream mountinfo("/proc/self/mountinfo");
+    std::string line;
+    while (std::getline(mountinfo, line)) {
+        size_t separator = line.find(" - ");
+        if (separator == std::string::npos || line.compare(separator + 3, 8, "cgroup2 ") != 0) {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string id, parent, device, root, mount;
+        fields >> id >> parent >> device >> root >> mount;
+        return mount;
+    }
+    return "";
+}
+
+void CgroupMonitor::closeGroups(std::vector<CgroupEntry>& entries) {
+    for (auto& entry : entries) {
+        if (entry.dir_fd >= 0) {
+            close(entry.dir_fd);
+        }
+    }
+    entries.clear();
+}
+
+bool CgroupMonitor::hierarchyChanged() {
+    if (inotify_fd < 0) {
+        return true;
+    }
+
+    // Any queued event means a cgroup came or went (or the queue overflowed)
+    char events[4096];
+    bool changed = false;
+    while (read(inotify_fd, events, sizeof(events)) > 0) {
+        changed = true;
+    }
+    return changed;
+}
+
+void CgroupMonitor::walkDirectory(int dir_fd, const std::string& path, int depth, std::vector<CgroupEntry>& found) {
+    std::string full_path = mount_point + path;
+    inotify_add_watch(inotify_fd, full_path.c_str(), IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR);
+
+    // fdopendir takes ownership, so scan a duplicate and keep dir_fd for reads
+    int scan_fd = dup(dir_fd);
+    DIR* directory = scan_fd >= 0 ? fdopendir(scan_fd) : nullptr;
+    if (directory == nullptr) {
+        if (scan_fd >= 0) {
+            close(scan_fd);
+        }
+        return;
+    }
+
+    struct dirent* child;
+    while ((child = readdir(directory)) != nullptr) {
+        if (child->d_type != DT_DIR || child->d_name[0] == '.') {
+            continue;
+        }
+        if (found.size() >= MAX_GROUPS) {
+            truncated = true;
+            break;
+        }
+        int child_fd = openat(dir_fd, child->d_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (child_fd < 0) {
+            continue;
+        }
+
+        CgroupEntry entry;
+        entry.path = path + "/" + child->d_name;
+        entry.container_id = containerId(entry.path);
+        entry.dir_fd = child_fd;
+        entry.usage_usec = 0;
+        entry.throttled_usec = 0;
+        entry.io_read_bytes = 0;
+        entry.io_write_bytes = 0;
+        entry.has_previous = false;
+        found.push_back(entry);
+
+        // Not found.back().path: the recursion grows found and may move it
+        if (depth + 1 < MAX_DEPTH) {
+            walkDirectory(child_fd, entry.path, depth + 1, found);
+        }
+    }
+    closedir(directory);
+}
+
+void CgroupMonitor::walk() {
+    // A fresh inotify instance drops the watches of groups that are gone
+    if (inotify_fd >= 0) {
+        close(inotify_fd);
+    }
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    std::vector<CgroupEntry> found;
+    truncated = false;
+    int root_fd = open(mount_point.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (root_fd >= 0) {
+        walkDirectory(root_fd, "", 0, found);
+        close(root_fd);
+    }
+    if (truncated && !limit_reported) {
+        std::cerr << "More than " << MAX_GROUPS << " cgroups under " << mount_point 
+                  << "; the rest are not monitored" << std::endl;
+    }
+    limit_reported = truncated;
+
+    // Groups that survived the re-walk keep their counters
+    std::unordered_map<std::string, const CgroupEntry*> previous;
+    previous.reserve(groups.size());
+    for (const auto& entry : groups) {
+        previous[entry.path] = &entry;
+    }
+    for (auto& entry : found) {
+        auto it = previous.find(entry.path);
+        if (it != previous.end() && it->second->has_previous) {
+            entry.usage_usec = it->second->usage_usec;
+            entry.throttled_usec = it->second->throttled_usec;
+            entry.io_read_bytes = it->second->io_read_bytes;
+            entry.io_write_bytes = it->second->io_write_bytes;
+            entry.has_previous = true;
+        }
+    }
+
+    closeGroups(groups);
+    groups.swap(found);
+    needs_walk = root_fd < 0;
+}
+
+bool CgroupMonitor::collect(std::vector<CgroupStats>& stats) {
+    if (mount_point.empty()) {
+        stats.clear();
+        return false;
+    }
+    if (needs_walk || hierarchyChanged()) {
+        walk();
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    double interval = std::chrono::duration<double>(now - last_collection).count();
+    size_t count = 0;
+
+    for (auto& entry : groups) {
+        // cpu.stat exists in every v2 group; failing to read it means the group is gone
+        if (!PlatformUtils::readFileAt(entry.dir_fd, "cpu.stat", read_buffer)) {
+            needs_walk = true;
+            continue;
+        }
+        uint64_t usage_usec = PlatformUtils::findField(read_buffer, "usage_usec ");
+        uint64_t throttled_usec = PlatformUtils::findField(read_buffer, "throttled_usec ");
+
+        if (count == stats.size()) {
+            stats.emplace_back();
+        }
+        CgroupStats& group = stats[count++];
+        group.path = entry.path;
+        group.container_id = entry.container_id;
+        group.process_count = 0;
+        group.top_process.clear();
+
+        // Controller files are absent when the parent doesn't delegate them
+        group.memory_current = 0;
+        group.memory_limit = 0;
+        group.memory_anon = 0;
+        group.memory_file = 0;
+        group.pids_current = 0;
+        if (PlatformUtils::readFileAt(entry.dir_fd, "memory.current", read_buffer)) {
+            group.memory_current = std::strtoull(read_buffer.data(), nullptr, 10);
+        }
+        if (PlatformUtils::readFileAt(entry.dir_fd, "memory.max", read_buffer) && read_buffer[0] != 'm') {
+            group.memory_limit = std::strtoull(read_buffer.data(), nullptr, 10);
+        }
+        if (PlatformUtils::readFileAt(entry.dir_fd, "memory.stat", read_buffer)) {
+            group.memory_anon = PlatformUtils::findField(read_buffer, "anon ");
+            group.memory_file = PlatformUtils::findField(read_buffer, "file ");
+        }
+        if (PlatformUtils::readFileAt(entry.dir_fd, "pids.current", read_buffer)) {
+            group.pids_current = std::strtoull(read_buffer.data(), nullptr, 10);
+        }
+
+        // One line per device: "8:0 rbytes=N wbytes=N rios=N wios=N ..."
+        uint64_t io_read_bytes = 0;
+        uint64_t io_write_bytes = 0;
+        if (PlatformUtils::readFileAt(entry.dir_fd, "io.stat", read_buffer)) {
+            for (const char* field = read_buffer.data(); (field = std::strchr(field, ' ')) != nullptr; ) {
+                field++;
+                if (std::strncmp(field, "rbytes=", 7) == 0) {
+                    io_read_bytes += std::strtoull(field + 7, nullptr, 10);
+                } else if (std::strncmp(field, "wbytes=", 7) == 0) {
+                    io_write_bytes += std::strtoull(field + 7, nullptr, 10);
+                }
+            }
+        }
+
+        group.cpu_usage = 0.0;
+        group.throttled_percent = 0.0;
+        group.io_read_bytes_rate = 0.0;
+        group.io_write_bytes_rate = 0.0;
+        if (entry.has_previous && interval > 0.0) {
+            double interval_usec = interval * 1000000.0;
+            if (usage_usec >= entry.usage_usec) {
+                group.cpu_usage = (usage_usec - entry.usage_usec) / interval_usec * 100.0;
+            }
+            if (throttled_usec >= entry.throttled_usec) {
+                group.throttled_percent = (throttled_usec - entry.throttled_usec) / interval_usec * 100.0;
+            }
+            if (io_read_bytes >= entry.io_read_bytes) {
+                group.io_read_bytes_rate = (io_read_bytes - entry.io_read_bytes) / interval;
+            }
+            if (io_write_bytes >= entry.io_write_bytes) {
+                group.io_write_bytes_rate = (io_write_bytes - entry.io_write_bytes) / interval;
+            }
+        }
+
+        entry.usage_usec = usage_usec;
+        entry.throttled_usec = throttled_usec;
+        entry.io_read_bytes = io_read_bytes;
+        entry.io_write_bytes = io_write_bytes;
+        entry.has_previous = true;
+    }
+    stats.resize(count);
+
+    last_collection = now;
+    return true;
+}
+
+#endif
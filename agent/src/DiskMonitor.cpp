@@ -0,0 +1,295 @@
+#include "../include/DiskMonitor.h"
+#include "../include/PlatformUtils.h"
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <sstream>
+#include <algorithm>
+
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_MACOS)
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <unistd.h>
+    #include <sys/statvfs.h>
+#endif
+
+DiskMonitor::DiskMonitor() : mountinfo_fd(-1), mounts_valid(false), has_previous(false) {
+    read_buffer.resize(16 * 1024);
+}
+
+DiskMonitor::~DiskMonitor() {
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_MACOS)
+    if (mountinfo_fd >= 0) {
+        close(mountinfo_fd);
+    }
+#endif
+}
+
+#if defined(PLATFORM_WINDOWS) || defined(PLATFORM_MACOS)
+
+bool DiskMonitor::mountsChanged() {
+    return false;
+}
+
+void DiskMonitor::loadMounts() {
+}
+
+bool DiskMonitor::isTrackedDevice(const char* name, size_t length) {
+    (void)name;
+    (void)length;
+    return false;
+}
+
+bool DiskMonitor::collectDevices(std::vector<DiskDeviceStats>& devices) {
+    // /proc/diskstats is Linux-specific
+    devices.clear();
+    return false;
+}
+
+bool DiskMonitor::collectMounts(std::vector<MountUsage>& usage) {
+    usage.clear();
+    return false;
+}
+
+#else
+
+static std::string unescapeMountField(const std::string& field) {
+    // mountinfo encodes space, tab, newline and backslash as \ooo
+    std::string result;
+    result.reserve(field.size());
+    for (size_t i = 0; i < field.size(); i++) {
+        if (field[i] == '\\' && i + 3 < field.size()) {
+            int value = (field[i + 1] - '0') * 64 + (field[i + 2] - '0') * 8 + (field[i + 3] - '0');
+            result.push_back(static_cast<char>(value));
+            i += 3;
+        } else {
+            result.push_back(field[i]);
+        }
+    }
+    return result;
+}
+
+bool DiskMonitor::isTrackedDevice(const char* name, size_t length) {
+    // Whole disks, md and dm devices appear in /sys/block; partitions don't
+    char path[64 + NAME_SIZE];
+    std::snprintf(path, sizeof(path), "/sys/block/%.*s", static_cast<int>(length), name);
+    if (access(path, F_OK) != 0) {
+        return false;
+    }
+    return std::strncmp(name, "loop", 4) != 0 && std::strncmp(name, "ram", 3) != 0;
+}
+
+bool DiskMonitor::mountsChanged() {
+    if (mountinfo_fd < 0) {
+        mountinfo_fd = open("/proc/self/mountinfo", O_RDONLY | O_CLOEXEC);
+        return true;
+    }
+
+    // The kernel flags mountinfo with POLLPRI whenever the mount table changes
+    struct pollfd watch;
+    watch.fd = mountinfo_fd;
+    watch.events = POLLPRI;
+    watch.revents = 0;
+    return poll(&watch, 1, 0) > 0 && (watch.revents & (POLLPRI | POLLERR)) != 0;
+}
+
+void DiskMonitor::loadMounts() {
+    mounts.clear();
+    mounts_valid = false;
+    if (mountinfo_fd < 0) {
+        return;
+    }
+
+    // Re-reading through the watched fd also acknowledges the change event
+    std::string contents;
+    char chunk[4096];
+    lseek(mountinfo_fd, 0, SEEK_SET);
+    ssize_t count;
+    while ((count = read(mountinfo_fd, chunk, sizeof(chunk))) > 0) {
+        contents.append(chunk, count);
+    }
+
+    std::vector<std::string> seen_devices;
+    std::istringstream lines(contents);
+    std::string line;
+    while (std::getline(lines, line)) {
+        // id parent major:minor root mount_point options [optional...] - fs_type source super_options
+        std::istringstream fields(line);
+        std::string id, parent, device_id, root, mount_point, token, fs_type, source;
+        fields >> id >> parent >> device_id >> root >> mount_point;
+        while (fields >> token && token != "-") {
+        }
+        fields >> fs_type >> source;
+
+        // Only filesystems backed by a block device; bind mounts count once
+        if (source.compare(0, 5, "/dev/") != 0) {
+            continue;
+        }
+        if (std::find(seen_devices.begin(), seen_devices.end(), device_id) != seen_devices.end()) {
+            continue;
+        }
+        seen_devices.push_back(device_id);
+
+        MountEntry entry;
+        entry.mount_point = unescapeMountField(mount_point);
+        entry.device = unescapeMountField(source);
+        entry.fs_type = fs_type;
+        mounts.push_back(entry);
+    }
+    mounts_valid = true;
+}
+
+bool DiskMonitor::collectMounts(std::vector<MountUsage>& usage) {
+    if (mountsChanged() || !mounts_valid) {
+        loadMounts();
+    }
+
+    size_t count = 0;
+    for (const auto& mount : mounts) {
+        struct statvfs fs;
+        if (statvfs(mount.mount_point.c_str(), &fs) != 0 || fs.f_blocks == 0) {
+            continue;
+        }
+
+        if (count == usage.size()) {
+            usage.emplace_back();
+        }
+        MountUsage& entry = usage[count++];
+        entry.mount_point = mount.mount_point;
+        entry.device = mount.device;
+        entry.fs_type = mount.fs_type;
+        entry.total_bytes = static_cast<uint64_t>(fs.f_blocks) * fs.f_frsize;
+        entry.used_bytes = static_cast<uint64_t>(fs.f_blocks - fs.f_bfree) * fs.f_frsize;
+        entry.available_bytes = static_cast<uint64_t>(fs.f_bavail) * fs.f_frsize;
+
+        // Same formula as df: used / (used + available to unprivileged users)
+        uint64_t usable = entry.used_bytes + entry.available_bytes;
+        entry.usage_percent = usable > 0 ? static_cast<double>(entry.used_bytes) / usable * 100.0 : 0.0;
+
+        entry.total_inodes = fs.f_files;
+        entry.used_inodes = fs.f_files - fs.f_ffree;
+        entry.inode_usage_percent = fs.f_files > 0 ? static_cast<double>(entry.used_inodes) / fs.f_files * 100.0 : 0.0;
+    }
+    usage.resize(count);
+    return true;
+}
+
+bool DiskMonitor::collectDevices(std::vector<DiskDeviceStats>& devices) {
+    if (!PlatformUtils::readFileInto("/proc/diskstats", read_buffer)) {
+        devices.clear();
+        return false;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    double interval = std::chrono::duration<double>(now - last_collection).count();
+    bool have_rates = has_previous && interval > 0.0;
+
+    for (auto& counters : device_counters) {
+        counters.seen = false;
+    }
+
+    size_t count = 0;
+    const char* cursor = read_buffer.data();
+    while (*cursor) {
+        // major minor name reads merged sectors ms writes merged sectors ms in_flight io_ticks ...
+        char* end;
+        std::strtoul(cursor, &end, 10);
+        std::strtoul(end, &end, 10);
+        cursor = end;
+        while (*cursor == ' ') {
+            cursor++;
+        }
+        const char* name = cursor;
+        while (*cursor && *cursor != ' ' && *cursor != '\n') {
+            cursor++;
+        }
+        size_t name_length = cursor - name;
+
+        uint64_t fields[10] = {0};
+        for (int i = 0; i < 10 && *cursor && *cursor != '\n'; i++) {
+            fields[i] = std::strtoull(cursor, &end, 10);
+            cursor = end;
+        }
+        while (*cursor && *cursor != '\n') {
+            cursor++;
+        }
+        if (*cursor == '\n') {
+            cursor++;
+        }
+        if (name_length == 0 || name_length >= NAME_SIZE) {
+            continue;
+        }
+
+        DeviceCounters* previous = nullptr;
+        for (auto& counters : device_counters) {
+            if (std::strncmp(counters.name, name, name_length) == 0 && counters.name[name_length] == '\0') {
+                previous = &counters;
+                break;
+            }
+        }
+
+        DeviceCounters current;
+        std::memcpy(current.name, name, name_length);
+        current.name[name_length] = '\0';
+        current.reads = fields[0];
+        current.read_sectors = fields[2];
+        current.read_ms = fields[3];
+        current.writes = fields[4];
+        current.write_sectors = fields[6];
+        current.write_ms = fields[7];
+        current.io_ticks = fields[9];
+        current.seen = true;
+        unsigned long in_progress = fields[8];
+
+        if (previous == nullptr) {
+            // Partitions and loop devices are classified once, then remembered
+            current.tracked = isTrackedDevice(name, name_length);
+            device_counters.push_back(current);
+            continue;
+        }
+        current.tracked = previous->tracked;
+        if (!current.tracked) {
+            previous->seen = true;
+            continue;
+        }
+
+        if (have_rates) {
+            // Counters only wrap on 32-bit kernels; treat going backwards as a reset
+            auto delta = [](uint64_t now_value, uint64_t then_value) {
+                return now_value >= then_value ? now_value - then_value : now_value;
+            };
+            uint64_t reads = delta(current.reads, previous->reads);
+            uint64_t writes = delta(current.writes, previous->writes);
+            uint64_t busy_ms = delta(current.read_ms, previous->read_ms) + delta(current.write_ms, previous->write_ms);
+
+            if (count == devices.size()) {
+                devices.emplace_back();
+            }
+            DiskDeviceStats& stats = devices[count++];
+            stats.name.assign(name, name_length);
+            stats.read_iops = reads / interval;
+            stats.write_iops = writes / interval;
+            stats.read_bytes_rate = delta(current.read_sectors, previous->read_sectors) * 512.0 / interval;
+            stats.write_bytes_rate = delta(current.write_sectors, previous->write_sectors) * 512.0 / interval;
+            stats.utilization = std::min(100.0, delta(current.io_ticks, previous->io_ticks) / (interval * 10.0));
+            stats.await_ms = reads + writes > 0 ? static_cast<double>(busy_ms) / (reads + writes) : 0.0;
+            stats.ios_in_progress = in_progress;
+        }
+        *previous = current;
+    }
+    devices.resize(count);
+
+    // Forget devices that went away
+    for (size_t i = device_counters.size(); i-- > 0; ) {
+        if (!device_counters[i].seen) {
+            device_counters[i] = device_counters.back();
+            device_counters.pop_back();
+        }
+    }
+
+    last_collection = now;
+    has_previous = true;
+    return true;
+}
+
+#endif
@@ -7,13 +7,18 @@
 #include <fstream>
 
 EventLogger::EventLogger(const std::string& db_file, const std::string& json_file) 
-    : db(nullptr), db_path(db_file), json_path(json_file) {
-    
+    : db(nullptr), db_path(db_file), json_path(json_file), row_formatter(true) {
+    row_time[0] = '\0';
+
     if (!initializeDatabase()) {
         std::cerr << "Failed to initialize database: " << db_path << std::endl;
         return;
     }
     
+    // An empty path leaves JSON output to a separate sink
+    if (json_path.empty()) {
+        return;
+    }
     json_log.open(json_path, std::ios::app);
     if (!json_log.is_open()) {
         std::cerr << "Failed to open JSON log file: " << json_path << std::endl;
@@ -83,6 +88,63 @@ bool EventLogger::initializeDatabase() {
         )
     )";
     
+    const char* create_interface_stats_table = R"(
+        CREATE TABLE IF NOT EXISTS interface_stats (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            interface TEXT,
+            rx_bytes_rate REAL,
+            tx_bytes_rate REAL,
+            rx_packets_rate REAL,
+            tx_packets_rate REAL,
+            errors_rate REAL,
+            drops_rate REAL,
+            utilization REAL,
+            timestamp DATETIME DEFAULT CURRENT_TIMESTAMP
+        )
+    )";
+    
+    const char* create_process_io_table = R"(
+        CREATE TABLE IF NOT EXISTS process_io (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            pid INTEGER,
+            name TEXT,
+            read_bytes_rate REAL,
+            write_bytes_rate REAL,
+            run_delay_ms REAL,
+            timestamp DATETIME DEFAULT CURRENT_TIMESTAMP
+        )
+    )";
+    
+    const char* create_cgroup_stats_table = R"(
+        CREATE TABLE IF NOT EXISTS cgroup_stats (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            path TEXT,
+            container_id TEXT,
+            cpu_usage REAL,
+            throttled_percent REAL,
+            memory_current INTEGER,
+            memory_limit INTEGER,
+            io_read_bytes_rate REAL,
+            io_write_bytes_rate REAL,
+            pids_current INTEGER,
+            process_count INTEGER,
+            timestamp DATETIME DEFAULT CURRENT_TIMESTAMP
+        )
+    )";
+    
+    const char* create_thread_stats_table = R"(
+        CREATE TABLE IF NOT EXISTS thread_stats (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            pid INTEGER,
+            tid INTEGER,
+            process_name TEXT,
+            thread_name TEXT,
+            state TEXT,
+            cpu_usage REAL,
+            timestamp DATETIME DEFAULT CURRENT_TIMESTAMP
+        )
+    )";
+    
     char* err_msg = nullptr;
     
     if (sqlite3_exec(db, create_processes_table, nullptr, nullptr, &err_msg) != SQLITE_OK) {
@@ -109,6 +171,30 @@ bool EventLogger::initializeDatabase() {
         return false;
     }
     
+    if (sqlite3_exec(db, create_interface_stats_table, nullptr, nullptr, &err_msg) != SQLITE_OK) {
+        std::cerr << "SQL error: " << err_msg << std::endl;
+        sqlite3_free(err_msg);
+        return false;
+    }
+    
+    if (sqlite3_exec(db, create_process_io_table, nullptr, nullptr, &err_msg) != SQLITE_OK) {
+        std::cerr << "SQL error: " << err_msg << std::endl;
+        sqlite3_free(err_msg);
+        return false;
+    }
+    
+    if (sqlite3_exec(db, create_cgroup_stats_table, nullptr, nullptr, &err_msg) != SQLITE_OK) {
+        std::cerr << "SQL error: " << err_msg << std::endl;
+        sqlite3_free(err_msg);
+        return false;
+    }
+    
+    if (sqlite3_exec(db, create_thread_stats_table, nullptr, nullptr, &err_msg) != SQLITE_OK) {
+        std::cerr << "SQL error: " << err_msg << std::endl;
+        sqlite3_free(err_msg);
+        return false;
+    }
+    
     return true;
 }
 
@@ -116,19 +202,25 @@ std::string EventLogger::getCurrentTimestamp() {
     return PlatformUtils::getCurrentTimestamp();
 }
 
-void EventLogger::logToJson(const std::string& event_type, const std::string& data) {
+const char* EventLogger::formatRowTime(int64_t time_ns) {
+    row_formatter.format(time_ns, row_time, true);
+    return row_time;
+}
+
+void EventLogger::logToJson(const std::string& event_type, const std::string& data, int64_t time_ns) {
     if (!json_log.is_open()) return;
     
-    std::string timestamp = getCurrentTimestamp();
-    json_log << "{\"timestamp\":\"" << timestamp << "\",\"type\":\"" << event_type 
+    char timestamp[TimestampFormatter::BUFFER_SIZE];
+    json_formatter.format(time_ns, timestamp);
+    json_log << "{\"timestamp\":\"" << timestamp << "\",\"time_ns\":" << time_ns << ",\"type\":\"" << event_type 
              << "\",\"data\":" << data << "}" << std::endl;
     json_log.flush();
 }
 
-void EventLogger::logProcess(const ProcessInfo& process) {
+void EventLogger::logProcess(const ProcessInfo& process, int64_t time_ns) {
     if (!db) return;
     
-    const char* sql = "INSERT INTO processes (pid, name, cpu_usage, memory_usage) VALUES (?, ?, ?, ?)";
+    const char* sql = "INSERT INTO processes (pid, name, cpu_usage, memory_usage, timestamp) VALUES (?, ?, ?, ?, ?)";
     sqlite3_stmt* stmt;
     
     if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
@@ -136,6 +228,7 @@ void EventLogger::logProcess(const ProcessInfo& process) {
         sqlite3_bind_text(stmt, 2, process.name.c_str(), -1, SQLITE_STATIC);
         sqlite3_bind_double(stmt, 3, process.cpu_usage);
         sqlite3_bind_int64(stmt, 4, process.memory_usage);
+        sqlite3_bind_text(stmt, 5, formatRowTime(time_ns), -1, SQLITE_STATIC);
         
         sqlite3_step(stmt);
         sqlite3_finalize(stmt);
@@ -146,13 +239,40 @@ void EventLogger::logProcess(const ProcessInfo& process) {
     json_data << "{\"pid\":" << process.pid << ",\"name\":\"" << process.name 
               << "\",\"cpu_usage\":" << process.cpu_usage 
               << ",\"memory_usage\":" << process.memory_usage << "}";
-    logToJson("process", json_data.str());
+    logToJson("process", json_data.str(), time_ns);
+}
+
+void EventLogger::logProcessIo(const ProcessInfo& process, int64_t time_ns) {
+    if (!db) return;
+    
+    const char* sql = "INSERT INTO process_io (pid, name, read_bytes_rate, write_bytes_rate, run_delay_ms, timestamp) VALUES (?, ?, ?, ?, ?, ?)";
+    sqlite3_stmt* stmt;
+    
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_int(stmt, 1, process.pid);
+        sqlite3_bind_text(stmt, 2, process.name.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_double(stmt, 3, process.read_bytes_rate);
+        sqlite3_bind_double(stmt, 4, process.write_bytes_rate);
+        sqlite3_bind_double(stmt, 5, process.run_delay_ms);
+        sqlite3_bind_text(stmt, 6, formatRowTime(time_ns), -1, SQLITE_STATIC);
+        
+        sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+    }
+    
+    // Log to JSON
+    std::stringstream json_data;
+    json_data << "{\"pid\":" << process.pid << ",\"name\":\"" << process.name
+              << "\",\"read_bytes_rate\":" << process.read_bytes_rate
+              << ",\"write_bytes_rate\":" << process.write_bytes_rate
+              << ",\"run_delay_ms\":" << process.run_delay_ms << "}";
+    logToJson("process_io", json_data.str(), time_ns);
 }
 
-void EventLogger::logNetworkConnection(const NetworkConnection& connection) {
+void EventLogger::logNetworkConnection(const NetworkConnection& connection, int64_t time_ns) {
     if (!db) return;
     
-    const char* sql = "INSERT INTO network_connections (local_ip, local_port, remote_ip, remote_port, protocol, state) VALUES (?, ?, ?, ?, ?, ?)";
+    const char* sql = "INSERT INTO network_connections (local_ip, local_port, remote_ip, remote_port, protocol, state, timestamp) VALUES (?, ?, ?, ?, ?, ?, ?)";
     sqlite3_stmt* stmt;
     
     if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
@@ -162,6 +282,7 @@ void EventLogger::logNetworkConnection(const NetworkConnection& connection) {
         sqlite3_bind_int(stmt, 4, connection.remote_port);
         sqlite3_bind_text(stmt, 5, connection.protocol.c_str(), -1, SQLITE_STATIC);
         sqlite3_bind_text(stmt, 6, connection.state.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 7, formatRowTime(time_ns), -1, SQLITE_STATIC);
         
         sqlite3_step(stmt);
         sqlite3_finalize(stmt);
@@ -172,14 +293,14 @@ void EventLogger::logNetworkConnection(const NetworkConnection& connection) {
     json_data << "{\"local_ip\":\"" << connection.local_ip << "\",\"local_port\":" << connection.local_port
               << ",\"remote_ip\":\"" << connection.remote_ip << "\",\"remote_port\":" << connection.remote_port
               << ",\"protocol\":\"" << connection.protocol << "\",\"state\":\"" << connection.state << "\"}";
-    logToJson("network", json_data.str());
+    logToJson("network", json_data.str(), time_ns);
 }
 
 void EventLogger::logAlert(const std::string& type, const std::string& severity, 
-                          const std::string& message, const std::string& details) {
+                          const std::string& message, const std::string& details, int64_t time_ns) {
     if (!db) return;
     
-    const char* sql = "INSERT INTO alerts (type, severity, message, details) VALUES (?, ?, ?, ?)";
+    const char* sql = "INSERT INTO alerts (type, severity, message, details, timestamp) VALUES (?, ?, ?, ?, ?)";
     sqlite3_stmt* stmt;
     
     if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
@@ -187,6 +308,7 @@ void EventLogger::logAlert(const std::string& type, const std::string& severity,
         sqlite3_bind_text(stmt, 2, severity.c_str(), -1, SQLITE_STATIC);
         sqlite3_bind_text(stmt, 3, message.c_str(), -1, SQLITE_STATIC);
         sqlite3_bind_text(stmt, 4, details.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 5, formatRowTime(time_ns), -1, SQLITE_STATIC);
         
         sqlite3_step(stmt);
         sqlite3_finalize(stmt);
@@ -196,13 +318,13 @@ void EventLogger::logAlert(const std::string& type, const std::string& severity,
     std::stringstream json_data;
     json_data << "{\"type\":\"" << type << "\",\"severity\":\"" << severity
               << "\",\"message\":\"" << message << "\",\"details\":\"" << details << "\"}";
-    logToJson("alert", json_data.str());
+    logToJson("alert", json_data.str(), time_ns);
 }
 
-void EventLogger::logSystemStats(const SystemStats& stats) {
+void EventLogger::logSystemStats(const SystemStats& stats, int64_t time_ns) {
     if (!db) return;
     
-    const char* sql = "INSERT INTO system_stats (cpu_usage, memory_usage, disk_usage, load_average) VALUES (?, ?, ?, ?)";
+    const char* sql = "INSERT INTO system_stats (cpu_usage, memory_usage, disk_usage, load_average, timestamp) VALUES (?, ?, ?, ?, ?)";
     sqlite3_stmt* stmt;
     
     if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
@@ -210,6 +332,7 @@ void EventLogger::logSystemStats(const SystemStats& stats) {
         sqlite3_bind_double(stmt, 2, stats.memory_usage);
         sqlite3_bind_double(stmt, 3, stats.disk_usage);
         sqlite3_bind_double(stmt, 4, stats.load_average);
+        sqlite3_bind_text(stmt, 5, formatRowTime(time_ns), -1, SQLITE_STATIC);
         
         sqlite3_step(stmt);
         sqlite3_finalize(stmt);
@@ -219,7 +342,97 @@ void EventLogger::logSystemStats(const SystemStats& stats) {
     std::stringstream json_data;
     json_data << "{\"cpu_usage\":" << stats.cpu_usage << ",\"memory_usage\":" << stats.memory_usage
               << ",\"disk_usage\":" << stats.disk_usage << ",\"load_average\":" << stats.load_average << "}";
-    logToJson("system_stats", json_data.str());
+    logToJson("system_stats", json_data.str(), time_ns);
+}
+
+void EventLogger::logInterfaceStats(const InterfaceStats& stats, int64_t time_ns) {
+    if (!db) return;
+    
+    const char* sql = "INSERT INTO interface_stats (interface, rx_bytes_rate, tx_bytes_rate, rx_packets_rate, tx_packets_rate, errors_rate, drops_rate, utilization, timestamp) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)";
+    sqlite3_stmt* stmt;
+    
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, stats.name.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_double(stmt, 2, stats.rx_bytes_rate);
+        sqlite3_bind_double(stmt, 3, stats.tx_bytes_rate);
+        sqlite3_bind_double(stmt, 4, stats.rx_packets_rate);
+        sqlite3_bind_double(stmt, 5, stats.tx_packets_rate);
+        sqlite3_bind_double(stmt, 6, stats.errors_rate);
+        sqlite3_bind_double(stmt, 7, stats.drops_rate);
+        sqlite3_bind_double(stmt, 8, stats.utilization);
+        sqlite3_bind_text(stmt, 9, formatRowTime(time_ns), -1, SQLITE_STATIC);
+        
+        sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+    }
+    
+    // Log to JSON
+    std::stringstream json_data;
+    json_data << "{\"interface\":\"" << stats.name << "\",\"rx_bytes_rate\":" << stats.rx_bytes_rate
+              << ",\"tx_bytes_rate\":" << stats.tx_bytes_rate << ",\"rx_packets_rate\":" << stats.rx_packets_rate
+              << ",\"tx_packets_rate\":" << stats.tx_packets_rate << ",\"errors_rate\":" << stats.errors_rate
+              << ",\"drops_rate\":" << stats.drops_rate << ",\"utilization\":" << stats.utilization << "}";
+    logToJson("interface_stats", json_data.str(), time_ns);
+}
+
+void EventLogger::logCgroupStats(const CgroupStats& stats, int64_t time_ns) {
+    if (!db) return;
+    
+    const char* sql = "INSERT INTO cgroup_stats (path, container_id, cpu_usage, throttled_percent, memory_current, memory_limit, io_read_bytes_rate, io_write_bytes_rate, pids_current, process_count, timestamp) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
+    sqlite3_stmt* stmt;
+    
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, stats.path.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 2, stats.container_id.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_double(stmt, 3, stats.cpu_usage);
+        sqlite3_bind_double(stmt, 4, stats.throttled_percent);
+        sqlite3_bind_int64(stmt, 5, static_cast<sqlite3_int64>(stats.memory_current));
+        sqlite3_bind_int64(stmt, 6, static_cast<sqlite3_int64>(stats.memory_limit));
+        sqlite3_bind_double(stmt, 7, stats.io_read_bytes_rate);
+        sqlite3_bind_double(stmt, 8, stats.io_write_bytes_rate);
+        sqlite3_bind_int64(stmt, 9, static_cast<sqlite3_int64>(stats.pids_current));
+        sqlite3_bind_int(stmt, 10, stats.process_count);
+        sqlite3_bind_text(stmt, 11, formatRowTime(time_ns), -1, SQLITE_STATIC);
+        
+        sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+    }
+    
+    // Log to JSON
+    std::stringstream json_data;
+    json_data << "{\"path\":\"" << stats.path << "\",\"container_id\":\"" << stats.container_id
+              << "\",\"cpu_usage\":" << stats.cpu_usage << ",\"throttled_percent\":" << stats.throttled_percent
+              << ",\"memory_current\":" << stats.memory_current << ",\"memory_limit\":" << stats.memory_limit
+              << ",\"io_read_bytes_rate\":" << stats.io_read_bytes_rate << ",\"io_write_bytes_rate\":" << stats.io_write_bytes_rate
+              << ",\"pids_current\":" << stats.pids_current << ",\"process_count\":" << stats.process_count << "}";
+    logToJson("cgroup_stats", json_data.str(), time_ns);
+}
+
+void EventLogger::logThreadStats(const ThreadInfo& thread, int64_t time_ns) {
+    if (!db) return;
+    
+    const char* sql = "INSERT INTO thread_stats (pid, tid, process_name, thread_name, state, cpu_usage, timestamp) VALUES (?, ?, ?, ?, ?, ?, ?)";
+    sqlite3_stmt* stmt;
+    
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_int(stmt, 1, thread.pid);
+        sqlite3_bind_int(stmt, 2, thread.tid);
+        sqlite3_bind_text(stmt, 3, thread.process_name.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 4, thread.name.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 5, thread.state.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_double(stmt, 6, thread.cpu_usage);
+        sqlite3_bind_text(stmt, 7, formatRowTime(time_ns), -1, SQLITE_STATIC);
+        
+        sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+    }
+    
+    // Log to JSON
+    std::stringstream json_data;
+    json_data << "{\"pid\":" << thread.pid << ",\"tid\":" << thread.tid << ",\"process_name\":\"" << thread.process_name
+              << "\",\"thread_name\":\"" << thread.name << "\",\"state\":\"" << thread.state
+              << "\",\"cpu_usage\":" << thread.cpu_usage << "}";
+    logToJson("thread_stats", json_data.str(), time_ns);
 }
 
 SystemStats EventLogger::getSystemStats() {
@@ -228,11 +441,23 @@ SystemStats EventLogger::getSystemStats() {
     stats.cpu_usage = PlatformUtils::getCpuUsage();
     stats.memory_usage = (double)PlatformUtils::getMemoryUsage() / (1024 * 1024) * 100; // Convert to percentage
     stats.load_average = PlatformUtils::getLoadAverage();
-    stats.disk_usage = 50.0; // Placeholder - would need platform-specific disk usage code
+    stats.disk_usage = PlatformUtils::getDiskUsage("/");
     
     return stats;
 }
 
+void EventLogger::beginBatch() {
+    if (db) {
+        sqlite3_exec(db, "BEGIN", nullptr, nullptr, nullptr);
+    }
+}
+
+void EventLogger::commitBatch() {
+    if (db) {
+        sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr);
+    }
+}
+
 bool EventLogger::isInitialized() const {
     return db != nullptr;
 }
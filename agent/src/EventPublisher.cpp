@@ -0,0 +1,186 @@
+#include "../include/EventPublisher.h"
+#include "../include/EventTime.h"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_MACOS)
+    #include <unistd.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+#endif
+
+EventPublisher::EventPublisher() : listen_fd(-1), batch_events(0), sequence(0) {
+}
+
+void EventPublisher::appendFrame(std::string& out, const std::string& type, const std::string& data, int64_t time_ns) {
+    // Type names are fixed identifiers and need no escaping
+    std::string payload = "{\"type\":\"";
+    payload += type;
+    payload += "\",\"time_ns\":";
+    payload += std::to_string(time_ns);
+    payload += ",\"data\":";
+    payload += data;
+    payload += "}";
+
+    uint32_t length = static_cast<uint32_t>(payload.size());
+    out += static_cast<char>((length >> 24) & 0xff);
+    out += static_cast<char>((length >> 16) & 0xff);
+    out += static_cast<char>((length >> 8) & 0xff);
+    out += static_cast<char>(length & 0xff);
+    out += payload;
+}
+
+void EventPublisher::publish(const std::string& type, const std::string& data, int64_t time_ns) {
+    appendFrame(batch, type, data, time_ns);
+    batch_events++;
+}
+
+size_t EventPublisher::subscriberCount() const {
+    return subscribers.size();
+}
+
+#if defined(PLATFORM_WINDOWS) || defined(PLATFORM_MACOS)
+
+EventPublisher::~EventPublisher() {
+    // Cleanup if needed
+}
+
+bool EventPublisher::listen(const std::string& path) {
+    (void)path;
+    std::cerr << "Event streaming is not supported on this platform" << std::endl;
+    return false;
+}
+
+void EventPublisher::acceptSubscribers() {
+}
+
+bool EventPublisher::writePending(Subscriber& subscriber) {
+    (void)subscriber;
+    return false;
+}
+
+void EventPublisher::flush() {
+    batch.clear();
+    batch_events = 0;
+}
+
+#else
+
+EventPublisher::~EventPublisher() {
+    for (auto& subscriber : subscribers) {
+        close(subscriber.fd);
+    }
+    if (listen_fd >= 0) {
+        close(listen_fd);
+        unlink(socket_path.c_str());
+    }
+}
+
+bool EventPublisher::listen(const std::string& path) {
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Event socket path too long: " << path << std::endl;
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    unlink(path.c_str()); // Left behind by a previous run
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(fd, 8) < 0) {
+        std::cerr << "Failed to listen for event subscribers on " << path << ": "
+                  << std::strerror(errno) << std::endl;
+        close(fd);
+        return false;
+    }
+    listen_fd = fd;
+    socket_path = path;
+    return true;
+}
+
+void EventPublisher::acceptSubscribers() {
+    if (listen_fd < 0) {
+        return;
+    }
+    while (true) {
+        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        if (subscribers.size() >= MAX_SUBSCRIBERS) {
+            close(fd);
+            continue;
+        }
+
+        Subscriber subscriber;
+        subscriber.fd = fd;
+        subscriber.sent = 0;
+        subscriber.dropped_events = 0;
+        subscriber.dropped_batches = 0;
+        subscriber.report_drops = false;
+        subscribers.push_back(subscriber);
+    }
+}
+
+bool EventPublisher::writePending(Subscriber& subscriber) {
+    while (subscriber.sent < subscriber.pending.size()) {
+        ssize_t written = send(subscriber.fd, subscriber.pending.data() + subscriber.sent,
+                               subscriber.pending.size() - subscriber.sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (written < 0) {
+            // A full socket buffer is retried next cycle; anything else means it hung up
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        subscriber.sent += static_cast<size_t>(written);
+    }
+    subscriber.pending.clear();
+    subscriber.sent = 0;
+    return true;
+}
+
+void EventPublisher::flush() {
+    acceptSubscribers();
+
+    // Close the batch with a marker so consumers can apply it as one update
+    int64_t now = EventClock::now();
+    long long timestamp_ms = now / 1000000;
+    appendFrame(batch, "cycle", "{\"sequence\":" + std::to_string(++sequence) + ",\"events\":" +
+                std::to_string(batch_events) + ",\"timestamp_ms\":" + std::to_string(timestamp_ms) + "}", now);
+
+    for (size_t i = 0; i < subscribers.size(); ) {
+        Subscriber& subscriber = subscribers[i];
+
+        if (subscriber.pending.size() - subscriber.sent + batch.size() > MAX_BUFFERED_BYTES) {
+            subscriber.dropped_events += batch_events;
+            subscriber.dropped_batches++;
+            subscriber.report_drops = true;
+        } else {
+            if (subscriber.sent > 0) {
+                subscriber.pending.erase(0, subscriber.sent);
+                subscriber.sent = 0;
+            }
+            if (subscriber.report_drops) {
+                appendFrame(subscriber.pending, "dropped", "{\"events\":" + std::to_string(subscriber.dropped_events) +
+                            ",\"batches\":" + std::to_string(subscriber.dropped_batches) + "}", now);
+                subscriber.report_drops = false;
+            }
+            subscriber.pending += batch;
+        }
+
+        if (!writePending(subscriber)) {
+            close(subscriber.fd);
+            subscribers.erase(subscribers.begin() + i);
+            continue;
+        }
+        i++;
+    }
+
+    batch.clear();
+    batch_events = 0;
+}
+
+#endif
@@ -0,0 +1,147 @@
+#include "../include/EventRouter.h"
+#include "../include/EventTime.h"
+
+EventRouter::EventRouter() {
+}
+
+EventRouter::~EventRouter() {
+    stop();
+}
+
+void EventRouter::addSink(std::unique_ptr<EventSink> sink, uint32_t types, int stats_interval) {
+    std::unique_ptr<Route> route(new Route());
+    route->sink = std::move(sink);
+    route->types = types;
+    route->stats_interval = stats_interval;
+    route->stats_sent = false;
+    route->cycles = 0;
+    route->stopping = false;
+    route->delivered = 0;
+    route->dropped = 0;
+    route->worker = std::thread(&EventRouter::run, std::ref(*route));
+    routes.push_back(std::move(route));
+}
+
+bool EventRouter::setRoute(const std::string& name, uint32_t types, int stats_interval) {
+    for (auto& route : routes) {
+        if (name == route->sink->name()) {
+            std::lock_guard<std::mutex> lock(route->mutex);
+            route->types = types;
+            route->stats_interval = stats_interval;
+            return true;
+        }
+    }
+    return false;
+}
+
+void EventRouter::publish(AgentEvent event) {
+    // Sinks write later on their own threads; the time is when it was observed
+    if (event.time_ns == 0) {
+        event.time_ns = EventClock::now();
+    }
+    batch.push_back(std::make_shared<const AgentEvent>(std::move(event)));
+}
+
+void EventRouter::deliver(AgentEvent event) {
+    if (event.time_ns == 0) {
+        event.time_ns = EventClock::now();
+    }
+    auto shared = std::make_shared<const AgentEvent>(std::move(event));
+
+    for (auto& route : routes) {
+        std::lock_guard<std::mutex> lock(route->mutex);
+        if ((route->types & EventSink::typeBit(shared->type)) == 0) {
+            continue;
+        }
+        if (route->queue.size() >= MAX_QUEUED_EVENTS) {
+            route->dropped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        route->queue.push_back(shared);
+        route->cycles++;
+        route->ready.notify_one();
+    }
+}
+
+void EventRouter::flush() {
+    auto now = std::chrono::steady_clock::now();
+
+    for (auto& route : routes) {
+        std::lock_guard<std::mutex> lock(route->mutex);
+
+        bool stats_due = route->stats_interval <= 0 || !route->stats_sent ||
+                         now - route->last_stats >= std::chrono::seconds(route->stats_interval);
+        if (stats_due) {
+            route->last_stats = now;
+            route->stats_sent = true;
+        }
+
+        for (const auto& event : batch) {
+            if ((route->types & EventSink::typeBit(event->type)) == 0 ||
+                (!stats_due && EventSink::isStats(event->type))) {
+                continue;
+            }
+            if (route->queue.size() >= MAX_QUEUED_EVENTS) {
+                route->dropped.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            route->queue.push_back(event);
+        }
+        route->cycles++;
+        route->ready.notify_one();
+    }
+
+    batch.clear();
+}
+
+void EventRouter::run(Route& route) {
+    std::vector<std::shared_ptr<const AgentEvent>> pending;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(route.mutex);
+            route.ready.wait(lock, [&route] { return route.cycles > 0 || route.stopping; });
+            if (route.cycles == 0) {
+                return; // Stopping with nothing left to deliver
+            }
+            pending.swap(route.queue);
+            route.cycles = 0;
+        }
+
+        // Everything queued since the last write goes out as one batch
+        route.sink->write(pending);
+        route.delivered.fetch_add(pending.size(), std::memory_order_relaxed);
+        pending.clear();
+    }
+}
+
+void EventRouter::stop() {
+    for (auto& route : routes) {
+        {
+            std::lock_guard<std::mutex> lock(route->mutex);
+            route->stopping = true;
+        }
+        route->ready.notify_one();
+    }
+    for (auto& route : routes) {
+        if (route->worker.joinable()) {
+            route->worker.join();
+        }
+    }
+}
+
+std::vector<SinkStatus> EventRouter::status() {
+    std::vector<SinkStatus> result;
+    for (auto& route : routes) {
+        SinkStatus status;
+        status.name = route->sink->name();
+        status.delivered = route->delivered.load(std::memory_order_relaxed);
+        status.dropped = route->dropped.load(std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(route->mutex);
+            status.queued = route->queue.size();
+        }
+        result.push_back(status);
+    }
+    return result;
+}
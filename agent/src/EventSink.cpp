@@ -0,0 +1,138 @@
+#include "../include/EventSink.h"
+#include <sstream>
+#include <cstdio>
+
+const char* EventSink::typeName(EventType type) {
+    switch (type) {
+        case EventType::PROCESS_STARTED: return "process_started";
+        case EventType::PROCESS_TERMINATED: return "process_exited";
+        case EventType::NETWORK_CONNECTION: return "connection";
+        case EventType::ANOMALY_DETECTED: return "alert";
+        case EventType::SYSTEM_STATS: return "system_stats";
+        case EventType::INTERFACE_STATS: return "interface_stats";
+        case EventType::PROCESS_IO: return "process_io";
+        case EventType::CGROUP_STATS: return "cgroup_stats";
+        case EventType::THREAD_STATS: return "thread_stats";
+    }
+    return "unknown";
+}
+
+uint32_t EventSink::typeBit(EventType type) {
+    return 1u << static_cast<int>(type);
+}
+
+bool EventSink::isStats(EventType type) {
+    return type == EventType::SYSTEM_STATS || type == EventType::INTERFACE_STATS ||
+           type == EventType::PROCESS_IO || type == EventType::CGROUP_STATS || type == EventType::THREAD_STATS;
+}
+
+bool EventSink::parseTypes(const std::string& list, uint32_t& types, std::string& unknown) {
+    uint32_t parsed = 0;
+    std::stringstream names(list);
+    std::string name;
+
+    while (std::getline(names, name, ',')) {
+        size_t start = name.find_first_not_of(" \t");
+        size_t end = name.find_last_not_of(" \t");
+        if (start == std::string::npos) {
+            continue;
+        }
+        name = name.substr(start, end - start + 1);
+        if (name == "all") {
+            parsed = (1u << TYPE_COUNT) - 1;
+            continue;
+        }
+
+        bool known = false;
+        for (int i = 0; i < TYPE_COUNT; i++) {
+            if (name == typeName(static_cast<EventType>(i))) {
+                parsed |= typeBit(static_cast<EventType>(i));
+                known = true;
+            }
+        }
+        if (!known) {
+            unknown = name;
+            return false;
+        }
+    }
+    types = parsed;
+    return true;
+}
+
+std::string EventSink::jsonQuote(const std::string& value) {
+    std::string result = "\"";
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+            result += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+            result += escaped;
+        } else {
+            result += c;
+        }
+    }
+    result += "\"";
+    return result;
+}
+
+std::string EventSink::toJson(const AgentEvent& event) {
+    std::ostringstream data;
+
+    switch (event.type) {
+        case EventType::PROCESS_STARTED:
+            data << "{\"pid\":" << event.process.pid << ",\"parent_pid\":" << event.process.parent_pid
+                 << ",\"name\":" << jsonQuote(event.process.name) << ",\"command\":" << jsonQuote(event.process.command)
+                 << ",\"cpu_usage\":" << event.process.cpu_usage << ",\"memory_usage\":" << event.process.memory_usage << "}";
+            break;
+        case EventType::PROCESS_TERMINATED:
+            data << "{\"pid\":" << event.pid << "}";
+            break;
+        case EventType::NETWORK_CONNECTION:
+            data << "{\"local_ip\":" << jsonQuote(event.connection.local_ip) << ",\"local_port\":" << event.connection.local_port
+                 << ",\"remote_ip\":" << jsonQuote(event.connection.remote_ip) << ",\"remote_port\":" << event.connection.remote_port
+                 << ",\"protocol\":" << jsonQuote(event.connection.protocol) << ",\"state\":" << jsonQuote(event.connection.state)
+                 << ",\"pid\":" << event.connection.pid << "}";
+            break;
+        case EventType::ANOMALY_DETECTED:
+            data << "{\"type\":" << jsonQuote(event.alert.type) << ",\"severity\":" << jsonQuote(event.alert.severity)
+                 << ",\"state\":" << jsonQuote(event.alert.state) << ",\"message\":" << jsonQuote(event.alert.message)
+                 << ",\"details\":" << jsonQuote(event.alert.details) << ",\"entity\":" << jsonQuote(event.alert.entity)
+                 << ",\"occurrences\":" << event.alert.occurrences << "}";
+            break;
+        case EventType::SYSTEM_STATS:
+            data << "{\"cpu_usage\":" << event.system.cpu_usage << ",\"memory_usage\":" << event.system.memory_usage
+                 << ",\"disk_usage\":" << event.system.disk_usage << ",\"load_average\":" << event.system.load_average << "}";
+            break;
+        case EventType::INTERFACE_STATS:
+            data << "{\"interface\":" << jsonQuote(event.interface_stats.name)
+                 << ",\"rx_bytes_rate\":" << event.interface_stats.rx_bytes_rate
+                 << ",\"tx_bytes_rate\":" << event.interface_stats.tx_bytes_rate
+                 << ",\"rx_packets_rate\":" << event.interface_stats.rx_packets_rate
+                 << ",\"tx_packets_rate\":" << event.interface_stats.tx_packets_rate
+                 << ",\"errors_rate\":" << event.interface_stats.errors_rate
+                 << ",\"drops_rate\":" << event.interface_stats.drops_rate
+                 << ",\"utilization\":" << event.interface_stats.utilization << "}";
+            break;
+        case EventType::PROCESS_IO:
+            data << "{\"pid\":" << event.process.pid << ",\"name\":" << jsonQuote(event.process.name)
+                 << ",\"read_bytes_rate\":" << event.process.read_bytes_rate
+                 << ",\"write_bytes_rate\":" << event.process.write_bytes_rate
+                 << ",\"run_delay_ms\":" << event.process.run_delay_ms << "}";
+            break;
+        case EventType::CGROUP_STATS:
+            data << "{\"path\":" << jsonQuote(event.cgroup.path) << ",\"container_id\":" << jsonQuote(event.cgroup.container_id)
+                 << ",\"cpu_usage\":" << event.cgroup.cpu_usage << ",\"throttled_percent\":" << event.cgroup.throttled_percent
+                 << ",\"memory_current\":" << event.cgroup.memory_current << ",\"memory_limit\":" << event.cgroup.memory_limit
+                 << ",\"pids_current\":" << event.cgroup.pids_current << ",\"process_count\":" << event.cgroup.process_count << "}";
+            break;
+        case EventType::THREAD_STATS:
+            data << "{\"pid\":" << event.thread.pid << ",\"tid\":" << event.thread.tid
+                 << ",\"process_name\":" << jsonQuote(event.thread.process_name)
+                 << ",\"thread_name\":" << jsonQuote(event.thread.name) << ",\"state\":" << jsonQuote(event.thread.state)
+                 << ",\"cpu_usage\":" << event.thread.cpu_usage << "}";
+            break;
+    }
+    return data.str();
+}
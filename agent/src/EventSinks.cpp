@@ -0,0 +1,183 @@
+#include "../include/EventSinks.h"
+#include <iostream>
+#include <sstream>
+
+DatabaseSink::DatabaseSink(EventLogger& logger) : logger(logger) {
+}
+
+const char* DatabaseSink::name() const {
+    return "database";
+}
+
+void DatabaseSink::write(const std::vector<std::shared_ptr<const AgentEvent>>& batch) {
+    if (batch.empty()) {
+        return;
+    }
+
+    logger.beginBatch();
+    for (const auto& event : batch) {
+        switch (event->type) {
+            case EventType::PROCESS_STARTED:
+                logger.logProcess(event->process, event->time_ns);
+                break;
+            case EventType::NETWORK_CONNECTION:
+                logger.logNetworkConnection(event->connection, event->time_ns);
+                break;
+            case EventType::ANOMALY_DETECTED:
+                logger.logAlert(event->alert.type, event->alert.severity, event->alert.message, event->alert.details,
+                                event->time_ns);
+                break;
+            case EventType::SYSTEM_STATS:
+                logger.logSystemStats(event->system, event->time_ns);
+                break;
+            case EventType::INTERFACE_STATS:
+                logger.logInterfaceStats(event->interface_stats, event->time_ns);
+                break;
+            case EventType::PROCESS_IO:
+                logger.logProcessIo(event->process, event->time_ns);
+                break;
+            case EventType::CGROUP_STATS:
+                logger.logCgroupStats(event->cgroup, event->time_ns);
+                break;
+            case EventType::THREAD_STATS:
+                logger.logThreadStats(event->thread, event->time_ns);
+                break;
+            case EventType::PROCESS_TERMINATED:
+                break; // No table for exits
+        }
+    }
+    logger.commitBatch();
+}
+
+JsonLinesSink::JsonLinesSink(const std::string& path) {
+    output.open(path, std::ios::app);
+    if (!output.is_open()) {
+        std::cerr << "Failed to open JSON log file: " << path << std::endl;
+    }
+}
+
+const char* JsonLinesSink::name() const {
+    return "json";
+}
+
+void JsonLinesSink::write(const std::vector<std::shared_ptr<const AgentEvent>>& batch) {
+    if (!output.is_open() || batch.empty()) {
+        return;
+    }
+
+    // Each event keeps its own observation time, however late the batch is written
+    char timestamp[TimestampFormatter::BUFFER_SIZE];
+    lines.clear();
+    for (const auto& event : batch) {
+        formatter.format(event->time_ns, timestamp);
+        lines += "{\"timestamp\":\"";
+        lines += timestamp;
+        lines += "\",\"time_ns\":";
+        lines += std::to_string(event->time_ns);
+        lines += ",\"type\":\"";
+        lines += typeName(event->type);
+        lines += "\",\"data\":";
+        lines += toJson(*event);
+        lines += "}\n";
+    }
+    output << lines;
+    output.flush();
+}
+
+const char* ConsoleSink::name() const {
+    return "console";
+}
+
+void ConsoleSink::write(const std::vector<std::shared_ptr<const AgentEvent>>& batch) {
+    if (batch.empty()) {
+        return;
+    }
+
+    std::ostringstream lines;
+    for (const auto& event : batch) {
+        switch (event->type) {
+            case EventType::PROCESS_STARTED:
+                lines << "[PROCESS] New: " << event->process.name << " (PID: " << event->process.pid << ")\n";
+                break;
+            case EventType::PROCESS_TERMINATED:
+                lines << "[PROCESS] Terminated: PID " << event->pid << "\n";
+                break;
+            case EventType::NETWORK_CONNECTION:
+                lines << "[NETWORK] New connection: " << event->connection.local_ip << ":"
+                      << event->connection.local_port << " -> " << event->connection.remote_ip << ":"
+                      << event->connection.remote_port << " (" << event->connection.protocol << ")\n";
+                break;
+            case EventType::ANOMALY_DETECTED:
+                lines << "[ALERT] " << event->alert.severity << " (" << event->alert.state << "): "
+                      << event->alert.message << "\n";
+                break;
+            case EventType::SYSTEM_STATS:
+                lines << "[STATS] CPU: " << event->system.cpu_usage << "%, "
+                      << "Memory: " << event->system.memory_usage << "%, "
+                      << "Disk: " << event->system.disk_usage << "%, "
+                      << "Load: " << event->system.load_average << "\n";
+                break;
+            default:
+                break; // Too detailed for the console
+        }
+    }
+    std::cout << lines.str();
+    std::cout.flush();
+}
+
+SocketSink::SocketSink(const std::string& path) {
+    publisher.listen(path);
+}
+
+const char* SocketSink::name() const {
+    return "socket";
+}
+
+void SocketSink::write(const std::vector<std::shared_ptr<const AgentEvent>>& batch) {
+    for (const auto& event : batch) {
+        publisher.publish(typeName(event->type), toJson(*event), event->time_ns);
+    }
+    // Called every cycle even when empty, so subscribers see the cycle marker
+    publisher.flush();
+}
+
+MetricsSink::MetricsSink() : info_alerts(0), warning_alerts(0), critical_alerts(0) {
+    for (auto& count : events) {
+        count = 0;
+    }
+}
+
+const char* MetricsSink::name() const {
+    return "metrics";
+}
+
+void MetricsSink::write(const std::vector<std::shared_ptr<const AgentEvent>>& batch) {
+    for (const auto& event : batch) {
+        events[static_cast<int>(event->type)].fetch_add(1, std::memory_order_relaxed);
+        if (event->type != EventType::ANOMALY_DETECTED) {
+            continue;
+        }
+        if (event->alert.severity == "CRITICAL") {
+            critical_alerts.fetch_add(1, std::memory_order_relaxed);
+        } else if (event->alert.severity == "WARNING") {
+            warning_alerts.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            info_alerts.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void MetricsSink::render(MetricsWriter& writer) const {
+    writer.metric("sentineltrack_events_total", "counter", "Events published, by type");
+    for (int i = 0; i < TYPE_COUNT; i++) {
+        writer.sample(static_cast<double>(events[i].load(std::memory_order_relaxed)),
+                      MetricsWriter::label("", "type", typeName(static_cast<EventType>(i))));
+    }
+    writer.metric("sentineltrack_alerts_total", "counter", "Alert notifications, by severity");
+    writer.sample(static_cast<double>(info_alerts.load(std::memory_order_relaxed)),
+                  MetricsWriter::label("", "severity", "INFO"));
+    writer.sample(static_cast<double>(warning_alerts.load(std::memory_order_relaxed)),
+                  MetricsWriter::label("", "severity", "WARNING"));
+    writer.sample(static_cast<double>(critical_alerts.load(std::memory_order_relaxed)),
+                  MetricsWriter::label("", "severity", "CRITICAL"));
+}
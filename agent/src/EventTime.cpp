@@ -0,0 +1,67 @@
+#include "../include/EventTime.h"
+#include <chrono>
+#include <cstring>
+#include <ctime>
+
+std::atomic<int64_t> EventClock::last_time(0);
+
+int64_t EventClock::now() {
+    int64_t wall = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    int64_t previous = last_time.load(std::memory_order_relaxed);
+    while (true) {
+        int64_t stamped = wall > previous ? wall : previous + 1;
+        if (last_time.compare_exchange_weak(previous, stamped, std::memory_order_relaxed)) {
+            return stamped;
+        }
+    }
+}
+
+TimestampFormatter::TimestampFormatter(bool utc) : utc(utc), cached_second(-1) {
+    prefix[0] = '\0';
+}
+
+size_t TimestampFormatter::format(int64_t epoch_ns, char* buffer, bool milliseconds) {
+    int64_t second = epoch_ns / 1000000000LL;
+    if (second != cached_second) {
+        // The reentrant forms; localtime() shares one buffer across threads
+        time_t seconds = static_cast<time_t>(second);
+        struct tm parts;
+#ifdef PLATFORM_WINDOWS
+        if (utc) {
+            gmtime_s(&parts, &seconds);
+        } else {
+            localtime_s(&parts, &seconds);
+        }
+#else
+        if (utc) {
+            gmtime_r(&seconds, &parts);
+        } else {
+            localtime_r(&seconds, &parts);
+        }
+#endif
+        if (std::strftime(prefix, sizeof(prefix), "%Y-%m-%d %H:%M:%S", &parts) != PREFIX_SIZE) {
+            std::memcpy(prefix, "0000-00-00 00:00:00", PREFIX_SIZE + 1);
+        }
+        cached_second = second;
+    }
+
+    std::memcpy(buffer, prefix, PREFIX_SIZE);
+    size_t length = PREFIX_SIZE;
+    if (milliseconds) {
+        int millis = static_cast<int>((epoch_ns / 1000000) % 1000);
+        buffer[length++] = '.';
+        buffer[length++] = static_cast<char>('0' + millis / 100);
+        buffer[length++] = static_cast<char>('0' + millis / 10 % 10);
+        buffer[length++] = static_cast<char>('0' + millis % 10);
+    }
+    buffer[length] = '\0';
+    return length;
+}
+
+std::string TimestampFormatter::format(int64_t epoch_ns, bool milliseconds) {
+    char buffer[BUFFER_SIZE];
+    size_t length = format(epoch_ns, buffer, milliseconds);
+    return std::string(buffer, length);
+}
@@ -0,0 +1,99 @@
+#include "../include/FrequencySketch.h"
+#include "../include/StateFile.h"
+#include "../include/PlatformUtils.h"
+#include <algorithm>
+
+FrequencySketch::FrequencySketch(size_t min_width, size_t rows) : width(1), depth(rows > 0 ? rows : 1) {
+    while (width < min_width) {
+        width <<= 1;
+    }
+    counters.assign(width * depth, 0);
+}
+
+FrequencySketch::~FrequencySketch() {
+    // Cleanup if needed
+}
+
+uint64_t FrequencySketch::hashKey(const std::string& key) {
+    // FNV-1a followed by a murmur finalizer to spread the bits
+    uint64_t hash = PlatformUtils::fnv1a(key);
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+size_t FrequencySketch::slot(size_t row, uint64_t hash) const {
+    // Double hashing derives one index per row from a single hash
+    uint64_t h1 = hash & 0xffffffffULL;
+    uint64_t h2 = (hash >> 32) | 1;
+    return row * width + ((h1 + row * h2) & (width - 1));
+}
+
+uint32_t FrequencySketch::add(const std::string& key) {
+    uint64_t hash = hashKey(key);
+
+    uint16_t minimum = UINT16_MAX;
+    for (size_t row = 0; row < depth; row++) {
+        minimum = std::min(minimum, counters[slot(row, hash)]);
+    }
+    if (minimum == UINT16_MAX) {
+        return minimum;
+    }
+
+    // Conservative update: only raise the counters that hold the minimum
+    for (size_t row = 0; row < depth; row++) {
+        uint16_t& counter = counters[slot(row, hash)];
+        if (counter == minimum) {
+            counter++;
+        }
+    }
+    return minimum + 1;
+}
+
+uint32_t FrequencySketch::estimate(const std::string& key) const {
+    uint64_t hash = hashKey(key);
+
+    uint16_t minimum = UINT16_MAX;
+    for (size_t row = 0; row < depth; row++) {
+        minimum = std::min(minimum, counters[slot(row, hash)]);
+    }
+    return minimum;
+}
+
+void FrequencySketch::age() {
+    for (auto& counter : counters) {
+        counter >>= 1;
+    }
+}
+
+void FrequencySketch::clear() {
+    std::fill(counters.begin(), counters.end(), 0);
+}
+
+size_t FrequencySketch::memoryBytes() const {
+    return counters.size() * sizeof(uint16_t);
+}
+
+void FrequencySketch::saveState(StateWriter& out) const {
+    out.putVarint(width);
+    out.putVarint(depth);
+    for (uint16_t counter : counters) {
+        out.putVarint(counter); // Mostly zero, so one byte each
+    }
+}
+
+bool FrequencySketch::loadState(StateReader& in) {
+    if (in.getVarint() != width || in.getVarint() != depth) {
+        return false;
+    }
+    std::vector<uint16_t> loaded(counters.size());
+    for (auto& counter : loaded) {
+        counter = static_cast<uint16_t>(std::min<uint64_t>(in.getVarint(), UINT16_MAX));
+    }
+    if (!in.ok()) {
+        return false;
+    }
+    counters.swap(loaded);
+    return true;
+}
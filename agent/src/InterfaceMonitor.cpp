@@ -0,0 +1,207 @@
+#include "../include/InterfaceMonitor.h"
+#include "../include/PlatformUtils.h"
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_MACOS)
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+// Column positions in /proc/net/dev of the counters we keep
+static const int counter_columns[] = {
+    0, 1, 2, 3,     // rx bytes, packets, errs, drop
+    8, 9, 10, 11    // tx bytes, packets, errs, drop
+};
+
+InterfaceMonitor::InterfaceMonitor() : has_previous(false) {
+    read_buffer.resize(16 * 1024);
+    states.reserve(16);
+}
+
+InterfaceMonitor::~InterfaceMonitor() {
+    // Cleanup if needed
+}
+
+uint64_t InterfaceMonitor::counterDelta(uint64_t current, uint64_t previous) {
+    if (current >= previous) {
+        return current - previous;
+    }
+    // A drop is a reset (driver reloaded, veth recreated under the same
+    // name), so count from zero. /proc/net/dev is 64-bit except on 32-bit
+    // kernels, where the counters are an unsigned long and wrap
+    if (sizeof(unsigned long) == 4 && previous <= 0xFFFFFFFFULL) {
+        return current + (0x100000000ULL - previous);
+    }
+    return current;
+}
+
+InterfaceMonitor::InterfaceState* InterfaceMonitor::findState(const char* name, size_t length) {
+    for (auto& state : states) {
+        if (std::strncmp(state.name, name, length) == 0 && state.name[length] == '\0') {
+            return &state;
+        }
+    }
+    return nullptr;
+}
+
+#if defined(PLATFORM_WINDOWS) || defined(PLATFORM_MACOS)
+
+long InterfaceMonitor::readLinkSpeed(const char* name) {
+    (void)name;
+    return -1;
+}
+
+bool InterfaceMonitor::collect(std::vector<InterfaceStats>& interfaces) {
+    // /proc/net/dev is Linux-specific
+    interfaces.clear();
+    return false;
+}
+
+#else
+
+long InterfaceMonitor::readLinkSpeed(const char* name) {
+    char path[64 + NAME_SIZE];
+    std::snprintf(path, sizeof(path), "/sys/class/net/%s/speed", name);
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    char buffer[32];
+    ssize_t count = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (count <= 0) {
+        return -1; // Virtual devices fail the read with EINVAL
+    }
+    buffer[count] = '\0';
+
+    long speed = std::strtol(buffer, nullptr, 10);
+    return speed > 0 ? speed : -1;
+}
+
+bool InterfaceMonitor::collect(std::vector<InterfaceStats>& interfaces) {
+    if (!PlatformUtils::readFileInto("/proc/net/dev", read_buffer)) {
+        interfaces.clear();
+        return false;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    double interval = std::chrono::duration<double>(now - last_collection).count();
+    bool have_rates = has_previous && interval > 0.0;
+
+    // Skip the two header lines
+    const char* cursor = read_buffer.data();
+    for (int skipped = 0; skipped < 2 && *cursor; cursor++) {
+        if (*cursor == '\n') {
+            skipped++;
+        }
+    }
+
+    for (auto& state : states) {
+        state.seen = false;
+    }
+    size_t count = 0;
+
+    while (*cursor) {
+        while (*cursor == ' ') {
+            cursor++;
+        }
+        const char* name = cursor;
+        while (*cursor && *cursor != ':' && *cursor != '\n') {
+            cursor++;
+        }
+        if (*cursor != ':') {
+            break;
+        }
+        size_t name_length = cursor - name;
+        cursor++;
+
+        // Parse all 16 columns, keeping the ones we track
+        uint64_t values[COUNTER_COUNT] = {0};
+        for (int column = 0, kept = 0; column < 16; column++) {
+            char* end;
+            uint64_t value = std::strtoull(cursor, &end, 10);
+            cursor = end;
+            if (kept < static_cast<int>(COUNTER_COUNT) && counter_columns[kept] == column) {
+                values[kept++] = value;
+            }
+        }
+        while (*cursor && *cursor != '\n') {
+            cursor++;
+        }
+        if (*cursor == '\n') {
+            cursor++;
+        }
+        if (name_length == 0 || name_length >= NAME_SIZE) {
+            continue;
+        }
+
+        InterfaceState* state = findState(name, name_length);
+        bool is_new = state == nullptr;
+        if (is_new) {
+            InterfaceState fresh;
+            std::memcpy(fresh.name, name, name_length);
+            fresh.name[name_length] = '\0';
+            std::memcpy(fresh.counters, values, sizeof(values));
+            fresh.link_speed_mbps = readLinkSpeed(fresh.name);
+            states.push_back(fresh);
+            state = &states.back();
+        }
+        state->seen = true;
+
+        // Reuse the caller's elements so names stay in their existing storage
+        if (count == interfaces.size()) {
+            interfaces.emplace_back();
+        }
+        InterfaceStats& stats = interfaces[count++];
+        stats.name.assign(name, name_length);
+        stats.rx_bytes = values[0];
+        stats.rx_packets = values[1];
+        stats.rx_errors = values[2];
+        stats.rx_drops = values[3];
+        stats.tx_bytes = values[4];
+        stats.tx_packets = values[5];
+        stats.tx_errors = values[6];
+        stats.tx_drops = values[7];
+        stats.link_speed_mbps = state->link_speed_mbps;
+
+        uint64_t deltas[COUNTER_COUNT] = {0};
+        if (have_rates && !is_new) {
+            for (size_t i = 0; i < COUNTER_COUNT; i++) {
+                deltas[i] = counterDelta(values[i], state->counters[i]);
+            }
+        }
+        double scale = have_rates ? 1.0 / interval : 0.0;
+        stats.rx_bytes_rate = deltas[0] * scale;
+        stats.rx_packets_rate = deltas[1] * scale;
+        stats.tx_bytes_rate = deltas[4] * scale;
+        stats.tx_packets_rate = deltas[5] * scale;
+        stats.errors_rate = (deltas[2] + deltas[6]) * scale;
+        stats.drops_rate = (deltas[3] + deltas[7]) * scale;
+
+        stats.utilization = -1.0;
+        if (stats.link_speed_mbps > 0) {
+            double busiest = stats.rx_bytes_rate > stats.tx_bytes_rate ? stats.rx_bytes_rate : stats.tx_bytes_rate;
+            stats.utilization = busiest * 8.0 / (stats.link_speed_mbps * 1000000.0) * 100.0;
+        }
+
+        std::memcpy(state->counters, values, sizeof(values));
+    }
+    interfaces.resize(count);
+
+    // Forget interfaces that disappeared (container veths come and go)
+    for (size_t i = states.size(); i-- > 0; ) {
+        if (!states[i].seen) {
+            states[i] = states.back();
+            states.pop_back();
+        }
+    }
+
+    last_collection = now;
+    has_previous = true;
+    return true;
+}
+
+#endif
@@ -0,0 +1,444 @@
+#include "../include/MetricsServer.h"
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_MACOS)
+    #include <unistd.h>
+    #include <fcntl.h>
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+#endif
+
+MetricsWriter::MetricsWriter() {
+    body.reserve(16384);
+}
+
+MetricsWriter::~MetricsWriter() {
+    // Cleanup if needed
+}
+
+void MetricsWriter::metric(const std::string& name, const std::string& type, const std::string& help) {
+    family = name;
+    body += "# HELP " + name + " " + help + "\n";
+    body += "# TYPE " + name + " " + type + "\n";
+}
+
+void MetricsWriter::sample(double value, const std::string& labels) {
+    char number[32];
+    std::snprintf(number, sizeof(number), "%.15g", value);
+
+    body += family;
+    if (!labels.empty()) {
+        body += "{" + labels + "}";
+    }
+    body += " ";
+    body += number;
+    body += "\n";
+}
+
+std::string MetricsWriter::label(const std::string& labels, const std::string& name, const std::string& value) {
+    std::string result = labels;
+    if (!result.empty()) {
+        result += ",";
+    }
+    result += name + "=\"";
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            result += '\\';
+            result += c;
+        } else if (c == '\n') {
+            result += "\\n";
+        } else {
+            result += c;
+        }
+    }
+    result += "\"";
+    return result;
+}
+
+std::string MetricsWriter::take() {
+    std::string result;
+    result.swap(body);
+    body.reserve(result.size());
+    return result;
+}
+
+MetricsServer::MetricsServer() : epoll_fd(-1), wake_fd(-1), scrapes(0) {
+    snapshot = std::make_shared<const std::string>();
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+void MetricsServer::publish(std::string body) {
+    auto next = std::make_shared<const std::string>(std::move(body));
+    std::lock_guard<std::mutex> lock(snapshot_mutex);
+    snapshot.swap(next);
+    // The old body is released here, or by the last scrape still sending it
+}
+
+uint64_t MetricsServer::scrapeCount() const {
+    return scrapes.load(std::memory_order_relaxed);
+}
+
+#if defined(PLATFORM_WINDOWS) || defined(PLATFORM_MACOS)
+
+bool MetricsServer::listenTcp(const std::string& address, int port) {
+    (void)address;
+    (void)port;
+    std::cerr << "Metrics endpoint is not supported on this platform" << std::endl;
+    return false;
+}
+
+bool MetricsServer::listenUnix(const std::string& path) {
+    (void)path;
+    std::cerr << "Metrics endpoint is not supported on this platform" << std::endl;
+    return false;
+}
+
+bool MetricsServer::start() {
+    return false;
+}
+
+void MetricsServer::stop() {
+}
+
+void MetricsServer::run() {
+}
+
+void MetricsServer::acceptConnections(int listen_fd) {
+    (void)listen_fd;
+}
+
+void MetricsServer::readRequest(Connection& connection) {
+    (void)connection;
+}
+
+void MetricsServer::prepareResponse(Connection& connection) {
+    (void)connection;
+}
+
+bool MetricsServer::writeResponse(Connection& connection) {
+    (void)connection;
+    return true;
+}
+
+void MetricsServer::closeConnection(int fd) {
+    (void)fd;
+}
+
+void MetricsServer::closeIdleConnections() {
+}
+
+#else
+
+bool MetricsServer::listenTcp(const std::string& address, int port) {
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+        std::cerr << "Invalid metrics address: " << address << std::endl;
+        return false;
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, 16) < 0) {
+        std::cerr << "Failed to listen for metrics on " << address << ":" << port << ": "
+                  << std::strerror(errno) << std::endl;
+        close(fd);
+        return false;
+    }
+    listen_fds.push_back(fd);
+    return true;
+}
+
+bool MetricsServer::listenUnix(const std::string& path) {
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Metrics socket path too long: " << path << std::endl;
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    unlink(path.c_str()); // Left behind by a previous run
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, 16) < 0) {
+        std::cerr << "Failed to listen for metrics on " << path << ": " << std::strerror(errno) << std::endl;
+        close(fd);
+        return false;
+    }
+    listen_fds.push_back(fd);
+    unix_path = path;
+    return true;
+}
+
+bool MetricsServer::start() {
+    if (listen_fds.empty() || worker.joinable()) {
+        return false;
+    }
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd < 0 || wake_fd < 0) {
+        return false;
+    }
+
+    epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    for (int fd : listen_fds) {
+        event.data.fd = fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    }
+    event.data.fd = wake_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event);
+
+    worker = std::thread(&MetricsServer::run, this);
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (worker.joinable()) {
+        uint64_t one = 1;
+        ssize_t written = write(wake_fd, &one, sizeof(one));
+        (void)written;
+        worker.join();
+    }
+
+    while (!connections.empty()) {
+        closeConnection(connections.begin()->first);
+    }
+    for (int fd : listen_fds) {
+        close(fd);
+    }
+    listen_fds.clear();
+    if (!unix_path.empty()) {
+        unlink(unix_path.c_str());
+        unix_path.clear();
+    }
+    if (epoll_fd >= 0) {
+        close(epoll_fd);
+        epoll_fd = -1;
+    }
+    if (wake_fd >= 0) {
+        close(wake_fd);
+        wake_fd = -1;
+    }
+}
+
+void MetricsServer::run() {
+    epoll_event events[32];
+
+    while (true) {
+        // Wake at least once a second to drop stalled clients
+        int ready = epoll_wait(epoll_fd, events, 32, 1000);
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+
+        for (int i = 0; i < ready; i++) {
+            int fd = events[i].data.fd;
+            if (fd == wake_fd) {
+                return;
+            }
+
+            bool listener = false;
+            for (int listen_fd : listen_fds) {
+                listener = listener || fd == listen_fd;
+            }
+            if (listener) {
+                acceptConnections(fd);
+                continue;
+            }
+
+            auto it = connections.find(fd);
+            if (it == connections.end()) {
+                continue;
+            }
+            if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                closeConnection(fd);
+            } else if (it->second.responding) {
+                if (writeResponse(it->second)) {
+                    closeConnection(fd);
+                }
+            } else {
+                readRequest(it->second);
+            }
+        }
+
+        closeIdleConnections();
+    }
+}
+
+void MetricsServer::acceptConnections(int listen_fd) {
+    while (true) {
+        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        if (connections.size() >= MAX_CONNECTIONS) {
+            close(fd);
+            continue;
+        }
+
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            close(fd);
+            continue;
+        }
+
+        Connection& connection = connections[fd];
+        connection.fd = fd;
+        connection.sent = 0;
+        connection.responding = false;
+        connection.opened = std::chrono::steady_clock::now();
+    }
+}
+
+void MetricsServer::readRequest(Connection& connection) {
+    char buffer[2048];
+    ssize_t received = recv(connection.fd, buffer, sizeof(buffer), 0);
+    if (received <= 0) {
+        if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            closeConnection(connection.fd);
+        }
+        return;
+    }
+    connection.request.append(buffer, static_cast<size_t>(received));
+
+    // Only the request line matters; wait for the end of the headers so the
+    // client isn't reset by unread data when we close
+    if (connection.request.find("\r\n\r\n") == std::string::npos &&
+        connection.request.find("\n\n") == std::string::npos) {
+        if (connection.request.size() > MAX_REQUEST_SIZE) {
+            closeConnection(connection.fd);
+        }
+        return;
+    }
+
+    prepareResponse(connection);
+    if (writeResponse(connection)) {
+        closeConnection(connection.fd);
+        return;
+    }
+
+    epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = EPOLLOUT;
+    event.data.fd = connection.fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, connection.fd, &event);
+}
+
+void MetricsServer::prepareResponse(Connection& connection) {
+    const std::string& request = connection.request;
+    bool head = request.compare(0, 5, "HEAD ") == 0;
+    bool get = request.compare(0, 4, "GET ") == 0;
+
+    size_t path_start = request.find(' ') + 1;
+    size_t path_end = request.find_first_of(" ?\r\n", path_start);
+    std::string path = request.substr(path_start, path_end - path_start);
+
+    const char* status = "200 OK";
+    if (!get && !head) {
+        status = "405 Method Not Allowed";
+    } else if (path != "/metrics" && path != "/") {
+        status = "404 Not Found";
+    } else {
+        std::lock_guard<std::mutex> lock(snapshot_mutex);
+        connection.body = snapshot;
+    }
+    if (connection.body) {
+        scrapes.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    size_t length = connection.body ? connection.body->size() : 0;
+    char header[256];
+    std::snprintf(header, sizeof(header),
+                  "HTTP/1.1 %s\r\n"
+                  "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                  "Content-Length: %zu\r\n"
+                  "Connection: close\r\n\r\n",
+                  status, length);
+    connection.header = header;
+    if (head) {
+        connection.body.reset();
+    }
+    connection.request.clear();
+    connection.responding = true;
+}
+
+bool MetricsServer::writeResponse(Connection& connection) {
+    size_t header_size = connection.header.size();
+    size_t body_size = connection.body ? connection.body->size() : 0;
+
+    while (connection.sent < header_size + body_size) {
+        // Header and body go out in one call; the body is never copied
+        iovec parts[2];
+        int count = 0;
+        if (connection.sent < header_size) {
+            parts[count].iov_base = const_cast<char*>(connection.header.data() + connection.sent);
+            parts[count].iov_len = header_size - connection.sent;
+            count++;
+        }
+        if (body_size > 0) {
+            size_t body_offset = connection.sent > header_size ? connection.sent - header_size : 0;
+            parts[count].iov_base = const_cast<char*>(connection.body->data() + body_offset);
+            parts[count].iov_len = body_size - body_offset;
+            count++;
+        }
+
+        msghdr message;
+        std::memset(&message, 0, sizeof(message));
+        message.msg_iov = parts;
+        message.msg_iovlen = count;
+        ssize_t written = sendmsg(connection.fd, &message, MSG_NOSIGNAL);
+        if (written < 0) {
+            // Not done yet on EAGAIN; any other error ends the connection
+            return errno != EAGAIN && errno != EWOULDBLOCK;
+        }
+        connection.sent += static_cast<size_t>(written);
+    }
+    return true;
+}
+
+void MetricsServer::closeConnection(int fd) {
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    connections.erase(fd);
+}
+
+void MetricsServer::closeIdleConnections() {
+    auto now = std::chrono::steady_clock::now();
+    std::vector<int> expired;
+    for (const auto& entry : connections) {
+        if (now - entry.second.opened > std::chrono::milliseconds(IDLE_TIMEOUT_MS)) {
+            expired.push_back(entry.first);
+        }
+    }
+    for (int fd : expired) {
+        closeConnection(fd);
+    }
+}
+
+#endif
@@ -1,10 +1,15 @@
 #include "../include/NetworkMonitor.h"
+#include "../include/StateFile.h"
+#include "../include/PlatformUtils.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <libproc.h>
 #include <iomanip>
 #include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
 
 #ifdef PLATFORM_WINDOWS
     #include <winsock2.h>
@@ -17,7 +22,35 @@
     #include <sys/sysctl.h>
 #endif
 
-NetworkMonitor::NetworkMonitor() {
+// Next slot of a buffer being refilled in place
+static NetworkConnection& nextConnection(std::vector<NetworkConnection>& connections, size_t& count) {
+    if (count == connections.size()) {
+        connections.emplace_back();
+    }
+    return connections[count++];
+}
+
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_MACOS)
+// One line of /proc/net/tcp or udp: "sl: local_ip:port remote_ip:port st ...",
+// with addresses and state in hex. Returns the state.
+static int parseProcNetLine(char* line, NetworkConnection& conn) {
+    char* cursor = std::strchr(line, ':');
+    if (cursor == nullptr) {
+        return 0;
+    }
+    unsigned long local_ip = std::strtoul(cursor + 1, &cursor, 16);
+    conn.local_port = static_cast<int>(std::strtoul(cursor + 1, &cursor, 16));
+    unsigned long remote_ip = std::strtoul(cursor, &cursor, 16);
+    conn.remote_port = static_cast<int>(std::strtoul(cursor + 1, &cursor, 16));
+    int state = static_cast<int>(std::strtoul(cursor, &cursor, 16));
+    
+    conn.local_ip = NetworkMonitor::ipToString(local_ip);
+    conn.remote_ip = NetworkMonitor::ipToString(remote_ip);
+    return state;
+}
+#endif
+
+NetworkMonitor::NetworkMonitor() : snapshot_pending(false) {
 #ifdef PLATFORM_WINDOWS
     WSADATA wsaData;
     WSAStartup(MAKEWORD(2, 2), &wsaData);
@@ -38,9 +71,7 @@ std::string NetworkMonitor::ipToString(unsigned long ip) {
            std::to_string((ip >> 24) & 0xFF);
 }
 
-std::vector<NetworkConnection> NetworkMonitor::parseTcpConnections() {
-    std::vector<NetworkConnection> connections;
-    
+void NetworkMonitor::parseTcpConnections(std::vector<NetworkConnection>& connections, size_t& count) {
 #ifdef PLATFORM_WINDOWS
     PMIB_TCPTABLE_OWNER_PID pTcpTable;
     DWORD dwSize = 0;
@@ -50,12 +81,12 @@ std::vector<NetworkConnection> NetworkMonitor::parseTcpConnections() {
     dwRetVal = GetExtendedTcpTable(NULL, &dwSize, FALSE, AF_INET, TCP_TABLE_OWNER_PID_ALL, 0);
     if (dwRetVal == ERROR_INSUFFICIENT_BUFFER) {
         pTcpTable = (MIB_TCPTABLE_OWNER_PID*)malloc(dwSize);
-        if (pTcpTable == NULL) return connections;
+        if (pTcpTable == NULL) return;
         
         dwRetVal = GetExtendedTcpTable(pTcpTable, &dwSize, FALSE, AF_INET, TCP_TABLE_OWNER_PID_ALL, 0);
         if (dwRetVal == NO_ERROR) {
             for (DWORD i = 0; i < pTcpTable->dwNumEntries; i++) {
-                NetworkConnection conn;
+                NetworkConnection& conn = nextConnection(connections, count);
                 conn.protocol = "TCP";
                 conn.local_ip = ipToString(pTcpTable->table[i].dwLocalAddr);
                 conn.local_port = ntohs((u_short)pTcpTable->table[i].dwLocalPort);
@@ -79,8 +110,6 @@ std::vector<NetworkConnection> NetworkMonitor::parseTcpConnections() {
                     case MIB_TCP_STATE_TIME_WAIT: conn.state = "TIME_WAIT"; break;
                     default: conn.state = "UNKNOWN"; break;
                 }
-                
-                connections.push_back(conn);
             }
         }
         free(pTcpTable);
@@ -90,13 +119,13 @@ std::vector<NetworkConnection> NetworkMonitor::parseTcpConnections() {
     // macOS implementation using sysctl
     size_t len;
     if (sysctlbyname("net.inet.tcp.pcblist", NULL, &len, NULL, 0) < 0) {
-        return connections;
+        return;
     }
     
     char* buf = (char*)malloc(len);
     if (sysctlbyname("net.inet.tcp.pcblist", buf, &len, NULL, 0) < 0) {
         free(buf);
-        return connections;
+        return;
     }
     
     // Parse the buffer (simplified - actual parsing is complex)
@@ -104,49 +133,18 @@ std::vector<NetworkConnection> NetworkMonitor::parseTcpConnections() {
     free(buf);
     
 #else
-    // Linux implementation (existing code)
-    std::ifstream tcp_file("/proc/net/tcp");
-    
-    if (!tcp_file.is_open()) {
-        return connections;
+    // Linux implementation, parsed in place from a reused buffer
+    if (!PlatformUtils::readFileInto("/proc/net/tcp", read_buffer)) {
+        return;
     }
     
-    std::string line;
-    std::getline(tcp_file, line); // Skip header
-    
-    while (std::getline(tcp_file, line)) {
-        std::istringstream iss(line);
-        std::string sl, local_address, rem_address, st, tx_queue, rx_queue, tr, tm_when, retrnsmt, uid, timeout, inode;
-        
-        iss >> sl >> local_address >> rem_address >> st >> tx_queue >> rx_queue >> tr >> tm_when >> retrnsmt >> uid >> timeout >> inode;
-        
-        NetworkConnection conn;
+    char* line = std::strchr(read_buffer.data(), '\n'); // Skip header
+    while (line != nullptr && line[1] != '\0') {
+        line++;
+        NetworkConnection& conn = nextConnection(connections, count);
         conn.protocol = "TCP";
         
-        // Parse local address (IP:Port in hex)
-        size_t colon_pos = local_address.find(':');
-        if (colon_pos != std::string::npos) {
-            std::string local_ip_hex = local_address.substr(0, colon_pos);
-            std::string local_port_hex = local_address.substr(colon_pos + 1);
-            
-            unsigned long local_ip_num = std::stoul(local_ip_hex, nullptr, 16);
-            conn.local_ip = ipToString(local_ip_num);
-            conn.local_port = std::stoi(local_port_hex, nullptr, 16);
-        }
-        
-        // Parse remote address
-        colon_pos = rem_address.find(':');
-        if (colon_pos != std::string::npos) {
-            std::string rem_ip_hex = rem_address.substr(0, colon_pos);
-            std::string rem_port_hex = rem_address.substr(colon_pos + 1);
-            
-            unsigned long rem_ip_num = std::stoul(rem_ip_hex, nullptr, 16);
-            conn.remote_ip = ipToString(rem_ip_num);
-            conn.remote_port = std::stoi(rem_port_hex, nullptr, 16);
-        }
-        
-        // Parse state
-        int state_num = std::stoi(st, nullptr, 16);
+        int state_num = parseProcNetLine(line, conn);
         switch (state_num) {
             case 1: conn.state = "ESTABLISHED"; break;
             case 2: conn.state = "SYN_SENT"; break;
@@ -164,17 +162,12 @@ std::vector<NetworkConnection> NetworkMonitor::parseTcpConnections() {
         
         conn.pid = 0;
         conn.process_name = "Unknown";
-        
-        connections.push_back(conn);
+        line = std::strchr(line, '\n');
     }
 #endif
-    
-    return connections;
 }
 
-std::vector<NetworkConnection> NetworkMonitor::parseUdpConnections() {
-    std::vector<NetworkConnection> connections;
-    
+void NetworkMonitor::parseUdpConnections(std::vector<NetworkConnection>& connections, size_t& count) {
 #ifdef PLATFORM_WINDOWS
     PMIB_UDPTABLE_OWNER_PID pUdpTable;
     DWORD dwSize = 0;
@@ -183,12 +176,12 @@ std::vector<NetworkConnection> NetworkMonitor::parseUdpConnections() {
     dwRetVal = GetExtendedUdpTable(NULL, &dwSize, FALSE, AF_INET, UDP_TABLE_OWNER_PID, 0);
     if (dwRetVal == ERROR_INSUFFICIENT_BUFFER) {
         pUdpTable = (MIB_UDPTABLE_OWNER_PID*)malloc(dwSize);
-        if (pUdpTable == NULL) return connections;
+        if (pUdpTable == NULL) return;
         
         dwRetVal = GetExtendedUdpTable(pUdpTable, &dwSize, FALSE, AF_INET, UDP_TABLE_OWNER_PID, 0);
         if (dwRetVal == NO_ERROR) {
             for (DWORD i = 0; i < pUdpTable->dwNumEntries; i++) {
-                NetworkConnection conn;
+                NetworkConnection& conn = nextConnection(connections, count);
                 conn.protocol = "UDP";
                 conn.local_ip = ipToString(pUdpTable->table[i].dwLocalAddr);
                 conn.local_port = ntohs((u_short)pUdpTable->table[i].dwLocalPort);
@@ -197,8 +190,6 @@ std::vector<NetworkConnection> NetworkMonitor::parseUdpConnections() {
                 conn.state = "ESTABLISHED";
                 conn.pid = pUdpTable->table[i].dwOwningPid;
                 conn.process_name = getProcessNameByPid(conn.pid);
-                
-                connections.push_back(conn);
             }
         }
         free(pUdpTable);
@@ -209,61 +200,31 @@ std::vector<NetworkConnection> NetworkMonitor::parseUdpConnections() {
     // Simplified implementation
     
 #else
-    // Linux implementation (existing code)
-    std::ifstream udp_file("/proc/net/udp");
-    
-    if (!udp_file.is_open()) {
-        return connections;
+    // Linux implementation, parsed in place from a reused buffer
+    if (!PlatformUtils::readFileInto("/proc/net/udp", read_buffer)) {
+        return;
     }
     
-    std::string line;
-    std::getline(udp_file, line); // Skip header
-    
-    while (std::getline(udp_file, line)) {
-        std::istringstream iss(line);
-        std::string sl, local_address, rem_address, st, tx_queue, rx_queue, tr, tm_when, retrnsmt, uid, timeout, inode;
-        
-        iss >> sl >> local_address >> rem_address >> st >> tx_queue >> rx_queue >> tr >> tm_when >> retrnsmt >> uid >> timeout >> inode;
-        
-        NetworkConnection conn;
+    char* line = std::strchr(read_buffer.data(), '\n'); // Skip header
+    while (line != nullptr && line[1] != '\0') {
+        line++;
+        NetworkConnection& conn = nextConnection(connections, count);
         conn.protocol = "UDP";
         conn.state = "ESTABLISHED";
-        
-        // Parse local address
-        size_t colon_pos = local_address.find(':');
-        if (colon_pos != std::string::npos) {
-            std::string local_ip_hex = local_address.substr(0, colon_pos);
-            std::string local_port_hex = local_address.substr(colon_pos + 1);
-            
-            unsigned long local_ip_num = std::stoul(local_ip_hex, nullptr, 16);
-            conn.local_ip = ipToString(local_ip_num);
-            conn.local_port = std::stoi(local_port_hex, nullptr, 16);
-        }
-        
-        // Parse remote address
-        colon_pos = rem_address.find(':');
-        if (colon_pos != std::string::npos) {
-            std::string rem_ip_hex = rem_address.substr(0, colon_pos);
-            std::string rem_port_hex = rem_address.substr(colon_pos + 1);
-            
-            unsigned long rem_ip_num = std::stoul(rem_ip_hex, nullptr, 16);
-            conn.remote_ip = ipToString(rem_ip_num);
-            conn.remote_port = std::stoi(rem_port_hex, nullptr, 16);
-        }
+        parseProcNetLine(line, conn);
         
         conn.pid = 0;
         conn.process_name = "Unknown";
-        
-        connections.push_back(conn);
+        line = std::strchr(line, '\n');
     }
 #endif
-    
-    return connections;
 }
 
-std::string NetworkMonitor::getConnectionKey(const NetworkConnection& conn) {
-    return conn.protocol + ":" + conn.local_ip + ":" + std::to_string(conn.local_port) + 
-           "->" + conn.remote_ip + ":" + std::to_string(conn.remote_port);
+void NetworkMonitor::getConnectionKey(const NetworkConnection& conn, std::string& key) {
+    char text[96];
+    std::snprintf(text, sizeof(text), "%s:%s:%d->%s:%d", conn.protocol.c_str(), conn.local_ip.c_str(),
+                  conn.local_port, conn.remote_ip.c_str(), conn.remote_port);
+    key.assign(text);
 }
 
 std::string NetworkMonitor::getProcessNameByPid(int pid) {
@@ -301,28 +262,35 @@ std::string NetworkMonitor::getProcessNameByPid(int pid) {
 #endif
 }
 
-std::vector<NetworkConnection> NetworkMonitor::getCurrentConnections() {
-    std::vector<NetworkConnection> all_connections;
-    
-    // Get TCP connections
-    auto tcp_connections = parseTcpConnections();
-    all_connections.insert(all_connections.end(), tcp_connections.begin(), tcp_connections.end());
-    
-    // Get UDP connections
-    auto udp_connections = parseUdpConnections();
-    all_connections.insert(all_connections.end(), udp_connections.begin(), udp_connections.end());
-    
-    return all_connections;
+void NetworkMonitor::scanConnections() {
+    size_t count = 0;
+    parseTcpConnections(current_connections, count);
+    parseUdpConnections(current_connections, count);
+    current_connections.resize(count);
+    
+    current_keys.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        getConnectionKey(current_connections[i], current_keys[i]);
+    }
+    snapshot_pending = true;
+}
+
+const std::vector<NetworkConnection>& NetworkMonitor::getCurrentConnections() {
+    scanConnections();
+    return current_connections;
 }
 
 std::vector<NetworkConnection> NetworkMonitor::getNewConnections() {
     std::vector<NetworkConnection> new_connections;
-    auto current_connections = getCurrentConnections();
     
-    for (const auto& conn : current_connections) {
-        std::string key = getConnectionKey(conn);
-        if (previous_connections.find(key) == previous_connections.end()) {
-            new_connections.push_back(conn);
+    // Reuse this cycle's scan if getCurrentConnections already ran
+    if (!snapshot_pending) {
+        scanConnections();
+    }
+    
+    for (size_t i = 0; i < current_connections.size(); i++) {
+        if (!std::binary_search(previous_keys.begin(), previous_keys.end(), current_keys[i])) {
+            new_connections.push_back(current_connections[i]);
         }
     }
     
@@ -331,7 +299,10 @@ std::vector<NetworkConnection> NetworkMonitor::getNewConnections() {
 
 std::vector<NetworkConnection> NetworkMonitor::getListeningPorts() {
     std::vector<NetworkConnection> listening_ports;
-    auto current_connections = getCurrentConnections();
+    
+    if (!snapshot_pending) {
+        scanConnections();
+    }
     
     for (const auto& conn : current_connections) {
         if (conn.state == "LISTEN" || (conn.protocol == "UDP" && conn.remote_ip == "0.0.0.0")) {
@@ -342,14 +313,38 @@ std::vector<NetworkConnection> NetworkMonitor::getListeningPorts() {
     return listening_ports;
 }
 
-void NetworkMonitor::updateConnectionList() {
-    previous_connections.clear();
-    auto current_connections = getCurrentConnections();
+void NetworkMonitor::saveState(StateWriter& out) const {
+    out.putVarint(previous_keys.size());
+    for (const auto& key : previous_keys) {
+        out.putString(key);
+    }
+}
+
+bool NetworkMonitor::loadState(StateReader& in) {
+    uint64_t count = in.getVarint();
+    std::vector<std::string> loaded;
+    for (uint64_t n = 0; n < count && in.ok(); n++) {
+        loaded.push_back(in.getString());
+    }
+    if (!in.ok()) {
+        return false;
+    }
+    std::sort(loaded.begin(), loaded.end());
     
-    for (const auto& conn : current_connections) {
-        std::string key = getConnectionKey(conn);
-        previous_connections.insert(key);
+    // Connections opened while the agent was down are reported as new
+    previous_keys.swap(loaded);
+    return true;
+}
+
+void NetworkMonitor::updateConnectionList() {
+    if (!snapshot_pending) {
+        scanConnections();
     }
+    
+    // The old keys' strings are overwritten by the next scan
+    previous_keys.swap(current_keys);
+    std::sort(previous_keys.begin(), previous_keys.end());
+    snapshot_pending = false;
 }
 
 std::vector<int> NetworkMonitor::getOpenPorts() {
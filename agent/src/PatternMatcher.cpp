@@ -0,0 +1,111 @@
+#include "../include/PatternMatcher.h"
+#include <deque>
+#include <cstring>
+
+PatternMatcher::PatternMatcher() : alphabet_size(1), built(false) {
+    std::memset(byte_class, 0, sizeof(byte_class));
+}
+
+void PatternMatcher::addPattern(const std::string& pattern) {
+    if (pattern.empty()) {
+        return; // An empty pattern would match every name
+    }
+    patterns.push_back(pattern);
+    built = false;
+}
+
+void PatternMatcher::clear() {
+    patterns.clear();
+    transitions.clear();
+    accepting.clear();
+    std::memset(byte_class, 0, sizeof(byte_class));
+    alphabet_size = 1;
+    built = false;
+}
+
+void PatternMatcher::build() {
+    // Class 0 is shared by every byte that appears in no pattern
+    std::memset(byte_class, 0, sizeof(byte_class));
+    alphabet_size = 1;
+    for (const auto& pattern : patterns) {
+        for (unsigned char c : pattern) {
+            if (byte_class[c] == 0) {
+                byte_class[c] = static_cast<uint8_t>(alphabet_size++);
+            }
+        }
+    }
+
+    // Build the trie
+    transitions.assign(alphabet_size, -1);
+    accepting.assign(1, 0);
+    for (const auto& pattern : patterns) {
+        int32_t state = 0;
+        for (unsigned char c : pattern) {
+            int32_t& next = transitions[state * alphabet_size + byte_class[c]];
+            if (next == -1) {
+                next = static_cast<int32_t>(accepting.size());
+                accepting.push_back(0);
+                transitions.resize(transitions.size() + alphabet_size, -1);
+            }
+            state = transitions[state * alphabet_size + byte_class[c]];
+        }
+        accepting[state] = 1;
+    }
+
+    // Breadth-first pass turns failure links into a complete DFA
+    std::vector<int32_t> failure(accepting.size(), 0);
+    std::deque<int32_t> queue;
+    for (int c = 0; c < alphabet_size; c++) {
+        int32_t& next = transitions[c];
+        if (next == -1) {
+            next = 0;
+        } else {
+            failure[next] = 0;
+            queue.push_back(next);
+        }
+    }
+
+    while (!queue.empty()) {
+        int32_t state = queue.front();
+        queue.pop_front();
+
+        for (int c = 0; c < alphabet_size; c++) {
+            int32_t& next = transitions[state * alphabet_size + c];
+            int32_t fallback = transitions[failure[state] * alphabet_size + c];
+            if (next == -1) {
+                next = fallback;
+            } else {
+                failure[next] = fallback;
+                accepting[next] |= accepting[fallback];
+                queue.push_back(next);
+            }
+        }
+    }
+
+    built = true;
+}
+
+bool PatternMatcher::matchesAny(const std::string& text) const {
+    if (!built) {
+        for (const auto& pattern : patterns) {
+            if (text.find(pattern) != std::string::npos) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const int32_t* table = transitions.data();
+    int32_t state = 0;
+    for (unsigned char c : text) {
+        state = table[state * alphabet_size + byte_class[c]];
+        if (accepting[state]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t PatternMatcher::patternCount() const {
+    return patterns.size();
+}
@@ -1,8 +1,9 @@
 #include "../include/PlatformUtils.h"
+#include "../include/EventTime.h"
 #include <chrono>
 #include <thread>
-#include <sstream>
-#include <iomanip>
+#include <cstring>
+#include <cstdlib>
 #ifdef PLATFORM_MACOS
 #include <mach-o/dyld.h>
 #endif
@@ -13,17 +14,22 @@
     #include <io.h>
 #else
     #include <sys/stat.h>
+    #include <sys/statvfs.h>
+    #include <fcntl.h>
     #include <unistd.h>
 #endif
 
 namespace PlatformUtils {
 
+// One formatter per thread: the sinks format on their own threads
+static thread_local TimestampFormatter local_formatter;
+
 std::string getCurrentTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-    return ss.str();
+    return local_formatter.format(EventClock::now());
+}
+
+std::string formatTimestamp(time_t time) {
+    return local_formatter.format(static_cast<int64_t>(time) * 1000000000LL);
 }
 
 void sleepMs(int milliseconds) {
@@ -243,4 +249,96 @@ double getLoadAverage() {
 #endif
 }
 
+double getDiskUsage(const std::string& path) {
+#ifdef PLATFORM_WINDOWS
+    ULARGE_INTEGER free_bytes, total_bytes;
+    if (GetDiskFreeSpaceExA(path.c_str(), &free_bytes, &total_bytes, NULL) && total_bytes.QuadPart > 0) {
+        return (double)(total_bytes.QuadPart - free_bytes.QuadPart) / total_bytes.QuadPart * 100.0;
+    }
+    return 0.0;
+    
+#else
+    struct statvfs fs;
+    if (statvfs(path.c_str(), &fs) != 0 || fs.f_blocks == 0) {
+        return 0.0;
+    }
+    
+    // Same formula as df: used / (used + available to unprivileged users)
+    unsigned long long used = fs.f_blocks - fs.f_bfree;
+    unsigned long long usable = used + fs.f_bavail;
+    if (usable == 0) return 0.0;
+    return (double)used / usable * 100.0;
+#endif
+}
+
+bool readFileInto(const char* path, std::vector<char>& buffer) {
+#ifdef PLATFORM_WINDOWS
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    size_t used = 0;
+    if (buffer.size() < 4096) buffer.resize(4096);
+    while (true) {
+        if (used + 1 >= buffer.size()) buffer.resize(buffer.size() * 2);
+        size_t count = fread(buffer.data() + used, 1, buffer.size() - used - 1, file);
+        if (count == 0) break;
+        used += count;
+    }
+    fclose(file);
+    buffer[used] = '\0';
+    return true;
+    
+#else
+    return readFileAt(AT_FDCWD, path, buffer);
+#endif
+}
+
+#ifndef PLATFORM_WINDOWS
+bool readFileAt(int dir_fd, const char* name, std::vector<char>& buffer) {
+    int fd = openat(dir_fd, name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    
+    if (buffer.size() < 4096) {
+        buffer.resize(4096);
+    }
+    
+    size_t used = 0;
+    while (true) {
+        // Grow only when the file is larger than ever before
+        if (used + 1 >= buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+        ssize_t count = read(fd, buffer.data() + used, buffer.size() - used - 1);
+        if (count < 0) {
+            close(fd);
+            return false;
+        }
+        if (count == 0) {
+            break;
+        }
+        used += count;
+    }
+    close(fd);
+    
+    buffer[used] = '\0';
+    return true;
+}
+#endif
+
+unsigned long long findField(const std::vector<char>& buffer, const char* key) {
+    size_t key_length = std::strlen(key);
+    const char* line = buffer.data();
+    while (line != nullptr && *line) {
+        if (std::strncmp(line, key, key_length) == 0) {
+            return std::strtoull(line + key_length, nullptr, 10);
+        }
+        line = std::strchr(line, '\n');
+        if (line != nullptr) {
+            line++;
+        }
+    }
+    return 0;
+}
+
 } // namespace PlatformUtils
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "../include/PortBitmap.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+
+// A whole decimal port number; "8080x", "-1" and "70000" are rejected
+static bool parsePort(const std::string& text, int& port) {
+    if (text.empty() || text[0] < '0' || text[0] > '9') {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    long value = std::strtol(text.c_str(), &end, 10);
+    if (errno != 0 || *end != '\0' || value > 65535) {
+        return false;
+    }
+    port = static_cast<int>(value);
+    return true;
+}
+
+void PortBitmap::reset() {
+    for (size_t i = 0; i < WORD_COUNT; i++) {
+        words[i] = 0;
+    }
+}
+
+void PortBitmap::merge(const PortBitmap& other) {
+    for (size_t i = 0; i < WORD_COUNT; i++) {
+        words[i] |= other.words[i];
+    }
+}
+
+size_t PortBitmap::count() const {
+    size_t total = 0;
+    for (size_t i = 0; i < WORD_COUNT; i++) {
+        total += __builtin_popcountll(words[i]);
+    }
+    return total;
+}
+
+bool PortBitmap::addList(const std::string& list, std::string* bad_entry) {
+    std::string entries = list;
+    std::replace(entries.begin(), entries.end(), ',', ' ');
+
+    bool valid = true;
+    std::istringstream iss(entries);
+    std::string token;
+    while (iss >> token) {
+        int first = 0;
+        int last = 0;
+        size_t dash = token.find('-');
+        bool parsed = dash == std::string::npos ?
+            parsePort(token, first) && parsePort(token, last) :
+            parsePort(token.substr(0, dash), first) && parsePort(token.substr(dash + 1), last) && first <= last;
+        if (!parsed) {
+            if (valid && bad_entry != nullptr) {
+                *bad_entry = token;
+            }
+            valid = false; // Skip malformed entries
+            continue;
+        }
+        setRange(first, last);
+    }
+    return valid;
+}
+
+bool PortBitmap::loadFromFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    PortBitmap loaded;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        std::string bad_entry;
+        if (!loaded.addList(line, &bad_entry)) {
+            std::cerr << path << ":" << line_number << ": invalid port entry '" << bad_entry << "'" << std::endl;
+            return false;
+        }
+    }
+
+    *this = loaded;
+    return true;
+}
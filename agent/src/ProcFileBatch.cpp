@@ -0,0 +1,376 @@
+#include "../include/ProcFileBatch.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_MACOS)
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <linux/io_uring.h>
+#endif
+
+static const size_t PATH_SIZE = 32;
+static const unsigned RING_ENTRIES = ProcFileBatch::WINDOW * 2;    // A read and a close per pid
+static const unsigned long long CLOSE_TAG = 1ULL << 32;            // user_data of close completions
+
+ProcFileBatch::ProcFileBatch(const std::string& root)
+    : root_fd(-1), ring_fd(-1), sq_ring(nullptr), sq_ring_size(0), cq_ring(nullptr), cq_ring_size(0),
+      sqes(nullptr), sqes_size(0), sq_head(nullptr), sq_tail(nullptr), sq_mask(nullptr), sq_array(nullptr),
+      cq_head(nullptr), cq_tail(nullptr), cq_mask(nullptr), cqes(nullptr) {
+#if defined(PLATFORM_WINDOWS) || defined(PLATFORM_MACOS)
+    (void)root;
+#else
+    root_fd = open(root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (root_fd < 0) {
+        std::cerr << "Cannot open " << root << std::endl;
+    }
+#endif
+}
+
+ProcFileBatch::~ProcFileBatch() {
+    closeRing();
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_MACOS)
+    if (root_fd >= 0) {
+        close(root_fd);
+    }
+#endif
+}
+
+bool ProcFileBatch::enableRing(bool enabled) {
+    if (!enabled) {
+        closeRing();
+        return true;
+    }
+    if (ring_fd >= 0) {
+        return true;
+    }
+    return root_fd >= 0 && setupRing();
+}
+
+bool ProcFileBatch::ringEnabled() const {
+    return ring_fd >= 0;
+}
+
+void ProcFileBatch::read(const std::vector<int>& window, const char* name) {
+    // Sized once, on first use, so an agent that never batches pays nothing
+    if (slots.size() < WINDOW * SLOT_SIZE) {
+        slots.resize(WINDOW * SLOT_SIZE);
+        sizes.resize(WINDOW);
+        fds.resize(WINDOW);
+        paths.resize(WINDOW * PATH_SIZE);
+    }
+
+    size_t count = std::min(window.size(), WINDOW);
+    pids.assign(window.begin(), window.begin() + count);
+    for (size_t i = 0; i < count; i++) {
+        sizes[i] = -1;
+        fds[i] = -1;
+    }
+
+    if (ring_fd >= 0 && !readRing(name)) {
+        std::cerr << "io_uring reads failed; reading /proc with plain system calls" << std::endl;
+        closeRing();
+        readSync(name);
+    } else if (ring_fd < 0) {
+        readSync(name);
+    }
+}
+
+bool ProcFileBatch::find(int pid, const char*& data, size_t& size) const {
+    auto it = std::lower_bound(pids.begin(), pids.end(), pid);
+    if (it == pids.end() || *it != pid) {
+        return false;
+    }
+    size_t index = static_cast<size_t>(it - pids.begin());
+    if (sizes[index] < 0) {
+        return false;
+    }
+    data = &slots[index * SLOT_SIZE];
+    size = static_cast<size_t>(sizes[index]);
+    return true;
+}
+
+#if defined(PLATFORM_WINDOWS) || defined(PLATFORM_MACOS)
+
+bool ProcFileBatch::setupRing() {
+    return false;
+}
+
+void ProcFileBatch::closeRing() {
+}
+
+unsigned ProcFileBatch::submit(unsigned count, unsigned tail) {
+    (void)count;
+    (void)tail;
+    return 0;
+}
+
+bool ProcFileBatch::waitCompletion(unsigned remaining, unsigned long long& user_data, int& result) {
+    (void)remaining;
+    user_data = 0;
+    result = -1;
+    return false;
+}
+
+bool ProcFileBatch::readRing(const char* name) {
+    (void)name;
+    return false;
+}
+
+void ProcFileBatch::readSync(const char* name) {
+    (void)name;
+}
+
+#else
+
+// Zeroed entry at the tail; the caller fills it in and publishes the tail
+static io_uring_sqe* nextEntry(void* sqes, unsigned* array, unsigned mask, unsigned& tail) {
+    unsigned index = tail & mask;
+    array[index] = index;
+    tail++;
+    io_uring_sqe* sqe = &static_cast<io_uring_sqe*>(sqes)[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+static bool opSupported(const io_uring_probe* probe, unsigned op) {
+    return op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+}
+
+bool ProcFileBatch::setupRing() {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    int fd = static_cast<int>(syscall(__NR_io_uring_setup, RING_ENTRIES, &params));
+    if (fd < 0) {
+        return false;
+    }
+    ring_fd = fd;
+
+    // openat, read and close all arrived in 5.6; older rings lack some of them
+    const unsigned probe_ops = 256;
+    std::vector<char> probe_buffer(sizeof(io_uring_probe) + probe_ops * sizeof(io_uring_probe_op), 0);
+    io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(probe_buffer.data());
+    if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, probe_ops) < 0 ||
+        !opSupported(probe, IORING_OP_OPENAT) || !opSupported(probe, IORING_OP_READ) ||
+        !opSupported(probe, IORING_OP_CLOSE)) {
+        closeRing();
+        return false;
+    }
+
+    sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        sq_ring_size = std::max(sq_ring_size, cq_ring_size);
+        cq_ring_size = sq_ring_size;
+    }
+
+    void* mapped = mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (mapped == MAP_FAILED) {
+        closeRing();
+        return false;
+    }
+    sq_ring = mapped;
+
+    if (single_mmap) {
+        cq_ring = sq_ring;
+    } else {
+        mapped = mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (mapped == MAP_FAILED) {
+            closeRing();
+            return false;
+        }
+        cq_ring = mapped;
+    }
+
+    sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    mapped = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (mapped == MAP_FAILED) {
+        closeRing();
+        return false;
+    }
+    sqes = mapped;
+
+    char* sq = static_cast<char*>(sq_ring);
+    sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    char* cq = static_cast<char*>(cq_ring);
+    cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes = cq + params.cq_off.cqes;
+    return true;
+}
+
+void ProcFileBatch::closeRing() {
+    if (sqes != nullptr) {
+        munmap(sqes, sqes_size);
+    }
+    if (cq_ring != nullptr && cq_ring != sq_ring) {
+        munmap(cq_ring, cq_ring_size);
+    }
+    if (sq_ring != nullptr) {
+        munmap(sq_ring, sq_ring_size);
+    }
+    if (ring_fd >= 0) {
+        close(ring_fd);
+    }
+    ring_fd = -1;
+    sq_ring = nullptr;
+    cq_ring = nullptr;
+    sqes = nullptr;
+    sq_head = sq_tail = sq_mask = sq_array = nullptr;
+    cq_head = cq_tail = cq_mask = nullptr;
+    cqes = nullptr;
+}
+
+// Publishes the queued entries and returns how many the kernel took
+unsigned ProcFileBatch::submit(unsigned count, unsigned tail) {
+    __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+    unsigned pending = count;
+    while (pending > 0) {
+        long result = syscall(__NR_io_uring_enter, ring_fd, pending, 0, 0, nullptr, 0);
+        pending = tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+        if (result < 0 && errno != EINTR) {
+            break;
+        }
+        if (result == 0 && pending > 0) {
+            break;
+        }
+    }
+    return count - pending;
+}
+
+// Blocks until a completion is available, waiting for all that are still
+// outstanding in a single call when the queue runs dry
+// False once io_uring_enter fails for good; the ring is then abandoned
+bool ProcFileBatch::waitCompletion(unsigned remaining, unsigned long long& user_data, int& result) {
+    io_uring_cqe* completions = static_cast<io_uring_cqe*>(cqes);
+    while (true) {
+        unsigned head = *cq_head;
+        if (head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+            const io_uring_cqe& cqe = completions[head & *cq_mask];
+            user_data = cqe.user_data;
+            result = cqe.res;
+            __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+            return true;
+        }
+        long entered = syscall(__NR_io_uring_enter, ring_fd, 0, remaining, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (entered < 0 && errno != EINTR) {
+            return false;
+        }
+    }
+}
+
+bool ProcFileBatch::readRing(const char* name) {
+    unsigned mask = *sq_mask;
+    unsigned tail = *sq_tail;
+    unsigned long long user_data = 0;
+    int result = 0;
+
+    // Open every file of the window
+    unsigned count = 0;
+    for (size_t i = 0; i < pids.size(); i++) {
+        char* path = &paths[i * PATH_SIZE];
+        std::snprintf(path, PATH_SIZE, "%d/%s", pids[i], name);
+        io_uring_sqe* sqe = nextEntry(sqes, sq_array, mask, tail);
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = root_fd;
+        sqe->addr = reinterpret_cast<unsigned long long>(path);
+        sqe->open_flags = O_RDONLY | O_CLOEXEC;
+        sqe->user_data = i;
+        count++;
+    }
+    unsigned submitted = submit(count, tail);
+    bool waited = true;
+    for (unsigned n = 0; n < submitted && waited; n++) {
+        waited = waitCompletion(submitted - n, user_data, result);
+        if (waited && user_data < pids.size() && result >= 0) {
+            fds[user_data] = result;
+        }
+    }
+    if (submitted != count || !waited) {
+        for (size_t i = 0; i < pids.size(); i++) {
+            if (fds[i] >= 0) {
+                close(fds[i]);
+                fds[i] = -1;
+            }
+        }
+        return false;
+    }
+
+    // Then read and close each one that opened (processes exit in between)
+    count = 0;
+    for (size_t i = 0; i < pids.size(); i++) {
+        if (fds[i] < 0) {
+            continue;
+        }
+        io_uring_sqe* sqe = nextEntry(sqes, sq_array, mask, tail);
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = fds[i];
+        sqe->addr = reinterpret_cast<unsigned long long>(&slots[i * SLOT_SIZE]);
+        sqe->len = SLOT_SIZE - 1;
+        sqe->off = 0;
+        sqe->flags = IOSQE_IO_HARDLINK;
+        sqe->user_data = i;
+
+        sqe = nextEntry(sqes, sq_array, mask, tail);
+        sqe->opcode = IORING_OP_CLOSE;
+        sqe->fd = fds[i];
+        sqe->user_data = CLOSE_TAG | i;
+        count += 2;
+    }
+    submitted = submit(count, tail);
+    for (unsigned n = 0; n < submitted; n++) {
+        if (!waitCompletion(submitted - n, user_data, result)) {
+            // Unreaped closes may have run already, and closing those
+            // descriptors again could hit reused ones; leave them open
+            return false;
+        }
+        size_t index = static_cast<size_t>(user_data & (CLOSE_TAG - 1));
+        if (index >= pids.size()) {
+            continue;
+        }
+        if (user_data & CLOSE_TAG) {
+            fds[index] = -1;    // Released even when close reports an error
+        } else if (result >= 0) {
+            sizes[index] = result;
+            slots[index * SLOT_SIZE + result] = '\0';
+        }
+    }
+
+    // Descriptors whose close never ran
+    for (size_t i = 0; i < pids.size(); i++) {
+        if (fds[i] >= 0) {
+            close(fds[i]);
+            fds[i] = -1;
+        }
+    }
+    return submitted == count;
+}
+
+void ProcFileBatch::readSync(const char* name) {
+    char path[PATH_SIZE];
+    for (size_t i = 0; i < pids.size(); i++) {
+        sizes[i] = -1;
+        std::snprintf(path, sizeof(path), "%d/%s", pids[i], name);
+        int fd = openat(root_fd, path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+        ssize_t count = ::read(fd, &slots[i * SLOT_SIZE], SLOT_SIZE - 1);
+        close(fd);
+        if (count >= 0) {
+            sizes[i] = static_cast<int>(count);
+            slots[i * SLOT_SIZE + count] = '\0';
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,207 @@
+#include "../include/ProcessBaselines.h"
+#include "../include/StateFile.h"
+#include "../include/PlatformUtils.h"
+#include <cmath>
+#include <algorithm>
+
+ProcessBaselines::ProcessBaselines(size_t capacity, double smoothing, uint32_t warmup)
+    : cycle(0), alpha(smoothing), warmup_samples(warmup), evictions(0) {
+    set_count = capacity / SET_WAYS;
+    if (set_count == 0) {
+        set_count = 1;
+    }
+    entries.assign(set_count * SET_WAYS, Entry{});
+}
+
+ProcessBaselines::~ProcessBaselines() {
+    // Cleanup if needed
+}
+
+uint64_t ProcessBaselines::hashName(const std::string& name) {
+    // 0 is reserved for empty slots
+    uint64_t hash = PlatformUtils::fnv1a(name);
+    return hash == 0 ? 1 : hash;
+}
+
+bool ProcessBaselines::evictsBefore(const Entry& a, const Entry& b) const {
+    // Empty slots first, then entries still in warm-up, then plain LRU
+    if ((a.key == 0) != (b.key == 0)) {
+        return a.key == 0;
+    }
+    bool a_warm = a.samples < warmup_samples;
+    bool b_warm = b.samples < warmup_samples;
+    if (a_warm != b_warm) {
+        return a_warm;
+    }
+    return a.last_used < b.last_used;
+}
+
+ProcessBaselines::Entry& ProcessBaselines::findOrInsert(uint64_t key) {
+    Entry* set = &entries[(key % set_count) * SET_WAYS];
+    Entry* victim = nullptr;
+
+    for (size_t way = 0; way < SET_WAYS; way++) {
+        Entry& entry = set[way];
+        if (entry.key == key) {
+            entry.last_used = cycle;
+            return entry;
+        }
+
+        if (victim == nullptr || evictsBefore(entry, *victim)) {
+            victim = &entry;
+        }
+    }
+
+    if (victim->key != 0) {
+        evictions++;
+    }
+    *victim = Entry{};
+    victim->key = key;
+    victim->last_used = cycle;
+    return *victim;
+}
+
+double ProcessBaselines::score(double value, double mean, double var, double min_stddev) {
+    // A floor keeps perfectly steady processes from scoring infinite deviations
+    double stddev = std::max(std::sqrt(var), min_stddev);
+    return (value - mean) / stddev;
+}
+
+void ProcessBaselines::beginCycle() {
+    cycle++;
+}
+
+void ProcessBaselines::fold(Entry& entry) const {
+    double cpu_usage = entry.pending_cpu;
+    double memory_kb = entry.pending_memory;
+    entry.pending_cycle = 0;
+
+    if (entry.samples == 0) {
+        entry.cpu_mean = cpu_usage;
+        entry.memory_mean = memory_kb;
+    } else {
+        // Exponentially weighted mean and variance
+        double cpu_diff = cpu_usage - entry.cpu_mean;
+        double cpu_incr = alpha * cpu_diff;
+        entry.cpu_mean += cpu_incr;
+        entry.cpu_var = (1.0 - alpha) * (entry.cpu_var + cpu_diff * cpu_incr);
+
+        double memory_diff = memory_kb - entry.memory_mean;
+        double memory_incr = alpha * memory_diff;
+        entry.memory_mean += memory_incr;
+        entry.memory_var = (1.0 - alpha) * (entry.memory_var + memory_diff * memory_incr);
+    }
+    if (entry.samples < UINT32_MAX) {
+        entry.samples++;
+    }
+}
+
+BaselineDeviation ProcessBaselines::update(const std::string& name, double cpu_usage, double memory_kb, bool measured) {
+    Entry& entry = findOrInsert(hashName(name));
+    if (entry.pending_cycle != 0 && entry.pending_cycle != cycle) {
+        fold(entry);
+    }
+
+    BaselineDeviation deviation;
+    deviation.established = entry.samples >= warmup_samples;
+    deviation.cpu_mean = entry.cpu_mean;
+    deviation.memory_mean = entry.memory_mean;
+    deviation.cpu_score = score(cpu_usage, entry.cpu_mean, entry.cpu_var, 1.0);
+    deviation.memory_score = score(memory_kb, entry.memory_mean, entry.memory_var, 1024.0);
+
+    // A process's first scan has no CPU figure yet; its 0 is not a sample
+    if (measured) {
+        if (entry.pending_cycle == cycle) {
+            entry.pending_cpu = std::max(entry.pending_cpu, cpu_usage);
+            entry.pending_memory = std::max(entry.pending_memory, memory_kb);
+        } else {
+            entry.pending_cycle = cycle;
+            entry.pending_cpu = cpu_usage;
+            entry.pending_memory = memory_kb;
+        }
+    }
+
+    return deviation;
+}
+
+size_t ProcessBaselines::capacity() const {
+    return entries.size();
+}
+
+size_t ProcessBaselines::size() const {
+    size_t used = 0;
+    for (const auto& entry : entries) {
+        if (entry.key != 0) {
+            used++;
+        }
+    }
+    return used;
+}
+
+uint64_t ProcessBaselines::evictionCount() const {
+    return evictions;
+}
+
+void ProcessBaselines::saveState(StateWriter& out) const {
+    size_t used = 0;
+    for (const auto& entry : entries) {
+        if (entry.key != 0) {
+            used++;
+        }
+    }
+
+    out.putVarint(entries.size());
+    out.putVarint(cycle);
+    out.putVarint(used);
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].key == 0) {
+            continue;
+        }
+        // The last cycle's sample goes in folded
+        Entry entry = entries[i];
+        if (entry.pending_cycle != 0) {
+            fold(entry);
+        }
+        // Slot index kept so entries land back in their own set
+        out.putVarint(i);
+        out.putVarint(entry.key);
+        out.putVarint(entry.last_used);
+        out.putVarint(entry.samples);
+        out.putDouble(entry.cpu_mean);
+        out.putDouble(entry.cpu_var);
+        out.putDouble(entry.memory_mean);
+        out.putDouble(entry.memory_var);
+    }
+}
+
+bool ProcessBaselines::loadState(StateReader& in) {
+    if (in.getVarint() != entries.size()) {
+        return false;
+    }
+    uint64_t saved_cycle = in.getVarint();
+    uint64_t used = in.getVarint();
+
+    std::vector<Entry> loaded(entries.size(), Entry{});
+    for (uint64_t n = 0; n < used && in.ok(); n++) {
+        uint64_t index = in.getVarint();
+        Entry entry{};
+        entry.key = in.getVarint();
+        entry.last_used = in.getVarint();
+        entry.samples = static_cast<uint32_t>(in.getVarint());
+        entry.cpu_mean = in.getDouble();
+        entry.cpu_var = in.getDouble();
+        entry.memory_mean = in.getDouble();
+        entry.memory_var = in.getDouble();
+        if (index >= loaded.size()) {
+            return false;
+        }
+        loaded[index] = entry;
+    }
+    if (!in.ok()) {
+        return false;
+    }
+
+    entries.swap(loaded);
+    cycle = saved_cycle;
+    return true;
+}
@@ -1,10 +1,13 @@
 #include "../include/ProcessMonitor.h"
 #include "../include/PlatformUtils.h"
+#include "../include/StateFile.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
-#include <set>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
 
 #ifdef PLATFORM_WINDOWS
     #include <windows.h>
@@ -17,10 +20,47 @@
 #else
     #include <dirent.h>
     #include <unistd.h>
+    #include <fcntl.h>
+    #include <climits>
     #include <sys/stat.h>
 #endif
 
-ProcessMonitor::ProcessMonitor() : previous_total_cpu_time(0) {
+static void copyDetails(const ProcessInfo& details, ProcessInfo& info) {
+    info.has_details = details.has_details;
+    info.resident_kb = details.resident_kb;
+    info.swap_kb = details.swap_kb;
+    info.pss_kb = details.pss_kb;
+    info.thread_count = details.thread_count;
+    info.fd_count = details.fd_count;
+    info.has_io_stats = details.has_io_stats;
+    info.read_bytes = details.read_bytes;
+    info.write_bytes = details.write_bytes;
+    info.read_bytes_rate = details.read_bytes_rate;
+    info.write_bytes_rate = details.write_bytes_rate;
+    info.run_delay_ms = details.run_delay_ms;
+}
+
+static const ProcessInfo no_details = ProcessInfo();
+
+ProcessMonitor::ProcessMonitor() 
+    : previous_total_cpu_time(0), boot_time(0), clock_ticks(100), 
+      scan_total_cpu_time(0), scan_count(0), details_enabled(true), sample_stride(1),
+      snapshot_pending(false), batched_reads(false), io_uring_requested(false), thread_top_n(0), thread_budget(0) {
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_MACOS)
+    // Start times in /proc/<pid>/stat are ticks since boot
+    std::ifstream stat_file("/proc/stat");
+    std::string line;
+    while (std::getline(stat_file, line)) {
+        if (line.compare(0, 6, "btime ") == 0) {
+            boot_time = std::stoll(line.substr(6));
+            break;
+        }
+    }
+    long ticks = sysconf(_SC_CLK_TCK);
+    if (ticks > 0) {
+        clock_ticks = ticks;
+    }
+#endif
     updateProcessList();
 }
 
@@ -28,13 +68,13 @@ ProcessMonitor::~ProcessMonitor() {
     // Cleanup if needed
 }
 
-std::vector<int> ProcessMonitor::getAllPids() {
-    std::vector<int> pids;
+void ProcessMonitor::getAllPids(std::vector<int>& pids) {
+    pids.clear();
     
 #ifdef PLATFORM_WINDOWS
     HANDLE hProcessSnap = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
     if (hProcessSnap == INVALID_HANDLE_VALUE) {
-        return pids;
+        return;
     }
     
     PROCESSENTRY32 pe32;
@@ -53,13 +93,13 @@ std::vector<int> ProcessMonitor::getAllPids() {
     size_t size;
     
     if (sysctl(mib, 4, NULL, &size, NULL, 0) < 0) {
-        return pids;
+        return;
     }
     
     struct kinfo_proc* procs = (struct kinfo_proc*)malloc(size);
     if (sysctl(mib, 4, procs, &size, NULL, 0) < 0) {
         free(procs);
-        return pids;
+        return;
     }
     
     int nprocs = size / sizeof(struct kinfo_proc);
@@ -73,7 +113,7 @@ std::vector<int> ProcessMonitor::getAllPids() {
     // Linux implementation (existing code)
     DIR* proc_dir = opendir("/proc");
     if (proc_dir == nullptr) {
-        return pids;
+        return;
     }
     
     struct dirent* entry;
@@ -88,12 +128,10 @@ std::vector<int> ProcessMonitor::getAllPids() {
     
     closedir(proc_dir);
 #endif
-    
-    return pids;
 }
 
-ProcessInfo ProcessMonitor::parseProcessInfo(int pid) {
-    ProcessInfo info;
+void ProcessMonitor::parseProcessInfo(int pid, ProcessInfo& info) {
+    // The slot held another process last time; assigning keeps its capacity
     info.pid = pid;
     info.cpu_usage = 0.0;
     info.memory_usage = 0;
@@ -101,7 +139,14 @@ ProcessInfo ProcessMonitor::parseProcessInfo(int pid) {
     info.parent_pid = 0;
     info.name = "Unknown";
     info.command = "Unknown";
-    
+    info.start_time.clear();
+    info.start_ticks = 0;
+    info.has_cpu_usage = false;
+    info.executable.clear();
+    info.uid = -1;
+    info.cgroup.clear();
+    copyDetails(no_details, info);
+
 #ifdef PLATFORM_WINDOWS
     HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, pid);
     if (hProcess) {
@@ -127,6 +172,7 @@ ProcessInfo ProcessMonitor::parseProcessInfo(int pid) {
             ut.HighPart = userTime.dwHighDateTime;
             
             unsigned long long totalTime = kt.QuadPart + ut.QuadPart;
+            info.has_cpu_usage = previous_cpu_times.count(pid) > 0 && previous_total_cpu_time != 0;
             info.cpu_usage = calculateCpuUsage(pid, totalTime);
         }
         
@@ -152,51 +198,43 @@ ProcessInfo ProcessMonitor::parseProcessInfo(int pid) {
         
         // CPU usage calculation (simplified)
         unsigned long long current_cpu_time = taskInfo.ptinfo.pti_total_user + taskInfo.ptinfo.pti_total_system;
+        info.has_cpu_usage = previous_cpu_times.count(pid) > 0 && previous_total_cpu_time != 0;
         info.cpu_usage = calculateCpuUsage(pid, current_cpu_time);
     }
     
 #else
-    // Linux implementation (existing code)
-    std::ifstream stat_file("/proc/" + std::to_string(pid) + "/stat");
-    if (stat_file.is_open()) {
-        std::string line;
-        std::getline(stat_file, line);
-        std::istringstream iss(line);
-        
-        std::string token;
-        int field_num = 0;
-        while (iss >> token && field_num < 25) {
-            switch (field_num) {
-                case 1:
-                    info.name = token.substr(1, token.length() - 2);
-                    break;
-                case 2:
-                    info.state = token;
-                    break;
-                case 3:
-                    info.parent_pid = std::stoi(token);
-                    break;
-                case 22:
-                    info.memory_usage = std::stol(token) / 1024;
-                    break;
-            }
-            field_num++;
-        }
-        stat_file.close();
+    // Stat fields are read every scan; everything else comes from the cache,
+    // so a recycled pid never inherits the previous owner's data
+    unsigned long long cpu_time = 0;
+    if (!readProcessStat(pid, info, cpu_time)) {
+        return;
     }
     
-    std::ifstream cmdline_file("/proc/" + std::to_string(pid) + "/cmdline");
-    if (cmdline_file.is_open()) {
-        std::getline(cmdline_file, info.command);
-        std::replace(info.command.begin(), info.command.end(), '\0', ' ');
-        cmdline_file.close();
+    ProcessCacheEntry& entry = process_cache[keyOf(info)];
+    entry.last_seen_scan = scan_count;
+    
+    // Against the system total at this process's own previous sample, which
+    // may be several scans back when sampling
+    if (entry.has_cpu_sample && scan_total_cpu_time > entry.total_cpu_time && cpu_time >= entry.cpu_time) {
+        info.cpu_usage = static_cast<double>(cpu_time - entry.cpu_time) / 
+                         (scan_total_cpu_time - entry.total_cpu_time) * 100.0;
+        info.has_cpu_usage = true;
     }
+    entry.cpu_time = cpu_time;
+    entry.total_cpu_time = scan_total_cpu_time;
+    entry.has_cpu_sample = scan_total_cpu_time > 0;
     
-    unsigned long long current_cpu_time = getProcessCpuTime(pid);
-    info.cpu_usage = calculateCpuUsage(pid, current_cpu_time);
+    // Command line, executable and owner only change on exec, which renames the process
+    if (!entry.identity_loaded || entry.name != info.name) {
+        entry.name = info.name;
+        loadIdentity(info, entry);
+    }
+    info.start_time = entry.start_time;
+    info.command = entry.command;
+    info.executable = entry.executable;
+    info.uid = entry.uid;
+    info.cgroup = entry.cgroup;
 #endif
-    
-    return info;
 }
 
 unsigned long long ProcessMonitor::getTotalCpuTime() {
@@ -225,23 +263,17 @@ unsigned long long ProcessMonitor::getTotalCpuTime() {
     return 0;
     
 #else
-    // Linux implementation (existing)
-    std::ifstream stat_file("/proc/stat");
-    if (!stat_file.is_open()) {
+    // First line: "cpu  user nice system idle iowait irq softirq steal ..."
+    if (!PlatformUtils::readFileInto("/proc/stat", read_buffer) || std::strncmp(read_buffer.data(), "cpu ", 4) != 0) {
         return 0;
     }
     
-    std::string line;
-    std::getline(stat_file, line);
-    
-    std::istringstream iss(line);
-    std::string cpu_label;
-    iss >> cpu_label;
-    
-    unsigned long long user, nice, system, idle, iowait, irq, softirq, steal;
-    iss >> user >> nice >> system >> idle >> iowait >> irq >> softirq >> steal;
-    
-    return user + nice + system + idle + iowait + irq + softirq + steal;
+    char* cursor = read_buffer.data() + 4;
+    unsigned long long total = 0;
+    for (int field = 0; field < 8; field++) {
+        total += std::strtoull(cursor, &cursor, 10);
+    }
+    return total;
 #endif
 }
 
@@ -320,30 +352,103 @@ double ProcessMonitor::calculateCpuUsage(int pid, unsigned long long current_cpu
     return cpu_usage;
 }
 
-std::vector<ProcessInfo> ProcessMonitor::getCurrentProcesses() {
-    std::vector<ProcessInfo> processes;
-    auto pids = getAllPids();
+void ProcessMonitor::scanProcesses() {
+    // Refill the buffer from two scans ago; the last scan stays readable for
+    // carrying forward processes not re-read while sampling
+    previous_snapshot.swap(current_snapshot);
+    scan_count++;
+    
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_MACOS)
+    // One system-wide CPU sample per scan rather than one per process
+    scan_total_cpu_time = getTotalCpuTime();
+#endif
     
-    for (int pid : pids) {
+    getAllPids(pid_buffer);
+    std::sort(pid_buffer.begin(), pid_buffer.end());
+    
+    size_t count = 0;
+    size_t previous = 0;    // Cursor into previous_snapshot, which is sorted by pid too
+    for (size_t i = 0; i < pid_buffer.size(); i++) {
+        int pid = pid_buffer[i];
+        if (batched_reads && i % ProcFileBatch::WINDOW == 0) {
+            readStatWindow(i);
+        }
+        if (count == current_snapshot.size()) {
+            current_snapshot.emplace_back();
+        }
+        ProcessInfo& info = current_snapshot[count];
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_MACOS)
+        if (sample_stride > 1 && pid % sample_stride != scan_count % sample_stride) {
+            // A pid recycled between this process's turns is picked up on its next turn
+            while (previous < previous_snapshot.size() && previous_snapshot[previous].pid < pid) {
+                previous++;
+            }
+            if (previous < previous_snapshot.size() && previous_snapshot[previous].pid == pid) {
+                auto cached = process_cache.find(keyOf(previous_snapshot[previous]));
+                if (cached != process_cache.end()) {
+                    cached->second.last_seen_scan = scan_count;
+                    info = previous_snapshot[previous];
+                    if (!details_enabled) {
+                        info.has_details = false;
+                        info.has_io_stats = false;
+                    }
+                    count++;
+                    continue;
+                }
+            }
+        }
+#endif
         try {
-            ProcessInfo info = parseProcessInfo(pid);
+            parseProcessInfo(pid, info);
             if (!info.name.empty() && info.name != "Unknown") {
-                processes.push_back(info);
+                count++;
             }
         } catch (const std::exception& e) {
             continue;
         }
     }
+    current_snapshot.resize(count);
     
-    return processes;
+    // Sorted already, since pids are unique and the snapshot is in pid order
+    current_keys.clear();
+    for (const auto& info : current_snapshot) {
+        current_keys.push_back(keyOf(info));
+    }
+    
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_MACOS)
+    // Forget processes that have exited
+    for (auto it = process_cache.begin(); it != process_cache.end(); ) {
+        if (it->second.last_seen_scan != scan_count) {
+            it = process_cache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    
+    if (details_enabled) {
+        refreshHotProcesses();
+    }
+    scanThreads();
+#endif
+    
+    snapshot_pending = true;
+}
+
+const std::vector<ProcessInfo>& ProcessMonitor::getCurrentProcesses() {
+    scanProcesses();
+    return current_snapshot;
 }
 
 std::vector<ProcessInfo> ProcessMonitor::getNewProcesses() {
     std::vector<ProcessInfo> new_processes;
-    auto current_processes = getCurrentProcesses();
     
-    for (const auto& process : current_processes) {
-        if (previous_processes.find(process.pid) == previous_processes.end()) {
+    // Reuse this cycle's scan if getCurrentProcesses already ran
+    if (!snapshot_pending) {
+        scanProcesses();
+    }
+    
+    for (const auto& process : current_snapshot) {
+        if (!std::binary_search(previous_keys.begin(), previous_keys.end(), keyOf(process))) {
             new_processes.push_back(process);
         }
     }
@@ -353,12 +458,15 @@ std::vector<ProcessInfo> ProcessMonitor::getNewProcesses() {
 
 std::vector<int> ProcessMonitor::getTerminatedProcesses() {
     std::vector<int> terminated_pids;
-    auto current_pids = getAllPids();
-    std::set<int> current_pid_set(current_pids.begin(), current_pids.end());
     
-    for (const auto& pair : previous_processes) {
-        if (current_pid_set.find(pair.first) == current_pid_set.end()) {
-            terminated_pids.push_back(pair.first);
+    if (!snapshot_pending) {
+        scanProcesses();
+    }
+    
+    // A pid reused within one interval shows up here and as a new process
+    for (const auto& key : previous_keys) {
+        if (!std::binary_search(current_keys.begin(), current_keys.end(), key)) {
+            terminated_pids.push_back(key.pid);
         }
     }
     
@@ -366,14 +474,576 @@ std::vector<int> ProcessMonitor::getTerminatedProcesses() {
 }
 
 void ProcessMonitor::updateProcessList() {
-    previous_processes.clear();
-    auto current_processes = getCurrentProcesses();
+    if (!snapshot_pending) {
+        scanProcesses();
+    }
+    
+    previous_keys.swap(current_keys);
+    snapshot_pending = false;
+}
+
+void ProcessMonitor::flagProcess(int pid) {
+    // Only one live instance can hold the pid; flagging is rare enough to scan
+    for (auto& pair : process_cache) {
+        if (pair.first.pid == pid) {
+            pair.second.open_alerts++;
+        }
+    }
+}
+
+void ProcessMonitor::unflagProcess(int pid) {
+    // It leaves the hot set at the next re-ranking
+    for (auto& pair : process_cache) {
+        if (pair.first.pid == pid && pair.second.open_alerts > 0) {
+            pair.second.open_alerts--;
+        }
+    }
+}
+
+void ProcessMonitor::setDetailsEnabled(bool enabled) {
+    details_enabled = enabled;
+}
+
+void ProcessMonitor::setSampleStride(unsigned int stride) {
+    sample_stride = stride > 0 ? stride : 1;
+}
+
+void ProcessMonitor::setThreadMonitoring(size_t top_processes, size_t max_threads) {
+    thread_top_n = top_processes;
+    thread_budget = max_threads > 0 ? max_threads : 1;
+    if (thread_top_n == 0) {
+        thread_snapshot.clear();
+        thread_cache.clear();
+    }
+}
+
+const std::vector<ThreadInfo>& ProcessMonitor::getThreads() const {
+    return thread_snapshot;
+}
+
+void ProcessMonitor::setIoUringReads(bool enabled) {
+    // Also called on every governor step; only a change retries the setup
+    if (enabled == io_uring_requested) {
+        return;
+    }
+    io_uring_requested = enabled;
+    batched_reads = stat_reads.enableRing(enabled) && enabled;
+    if (enabled && !batched_reads) {
+        std::cerr << "io_uring is unavailable; reading /proc with plain system calls" << std::endl;
+    }
+}
+
+void ProcessMonitor::saveState(StateWriter& out) const {
+    out.putSigned(boot_time);
+    // The last scan, which updateProcessList has made the known set
+    out.putVarint(current_snapshot.size());
+    for (const auto& info : current_snapshot) {
+        out.putVarint(info.pid);
+        out.putVarint(info.start_ticks);
+        out.putString(info.name);
+        out.putVarint(info.parent_pid);
+        
+        auto cached = process_cache.find(keyOf(info));
+        bool has_sample = cached != process_cache.end() && cached->second.has_cpu_sample;
+        out.putVarint(has_sample ? cached->second.cpu_time : 0);
+        out.putVarint(has_sample ? cached->second.total_cpu_time : 0);
+    }
+}
+
+bool ProcessMonitor::loadState(StateReader& in) {
+    if (in.getSigned() != boot_time || boot_time == 0) {
+        return false;
+    }
+    
+    uint64_t count = in.getVarint();
+    std::vector<ProcessKey> keys;
+    std::unordered_map<ProcessKey, ProcessCacheEntry, ProcessKeyHash> cache;
+    for (uint64_t n = 0; n < count && in.ok(); n++) {
+        ProcessInfo info{};
+        info.pid = static_cast<int>(in.getVarint());
+        info.start_ticks = in.getVarint();
+        info.name = in.getString();
+        info.parent_pid = static_cast<int>(in.getVarint());
+        
+        // The next scan measures CPU from here, so the first cycle after a
+        // restart reports the average over the downtime instead of 0%
+        ProcessCacheEntry entry;
+        entry.cpu_time = in.getVarint();
+        entry.total_cpu_time = in.getVarint();
+        entry.has_cpu_sample = entry.total_cpu_time > 0;
+        entry.name = info.name;
+        
+        keys.push_back(keyOf(info));
+        cache[keyOf(info)] = entry;
+    }
+    if (!in.ok()) {
+        return false;
+    }
+    std::sort(keys.begin(), keys.end());
+    
+    // Processes started or exited while the agent was down show up as
+    // new or terminated on the first cycle
+    previous_keys.swap(keys);
+    process_cache.swap(cache);
+    snapshot_pending = false;
+    return true;
+}
+
+ProcessMonitor::ProcessKey ProcessMonitor::keyOf(const ProcessInfo& info) {
+    return ProcessKey{info.pid, info.start_ticks};
+}
+
+#if defined(PLATFORM_WINDOWS) || defined(PLATFORM_MACOS)
+
+bool ProcessMonitor::readProcessStat(int pid, ProcessInfo& info, unsigned long long& cpu_time) {
+    (void)pid;
+    (void)info;
+    (void)cpu_time;
+    return false;
+}
+
+void ProcessMonitor::readStatWindow(size_t first) {
+    (void)first;
+}
+
+void ProcessMonitor::loadIdentity(const ProcessInfo& info, ProcessCacheEntry& entry) {
+    (void)info;
+    (void)entry;
+}
+
+void ProcessMonitor::loadDetails(int pid, ProcessCacheEntry& entry) {
+    (void)pid;
+    (void)entry;
+}
+
+void ProcessMonitor::sampleActivity(int pid, ProcessCacheEntry& entry, std::chrono::steady_clock::time_point now) {
+    (void)pid;
+    (void)entry;
+    (void)now;
+}
+
+void ProcessMonitor::refreshHotProcesses() {
+}
+
+void ProcessMonitor::scanThreads() {
+}
+
+void ProcessMonitor::listThreads(int pid) {
+    (void)pid;
+    tid_buffer.clear();
+}
+
+bool ProcessMonitor::readThreadStat(int pid, int tid, ThreadInfo& thread, unsigned long long& cpu_time,
+                                   unsigned long long& start_ticks) {
+    (void)pid;
+    (void)tid;
+    (void)thread;
+    (void)cpu_time;
+    (void)start_ticks;
+    return false;
+}
+
+#else
+
+static const int STAT_FIELDS = 24;
+
+// A process or thread stat line: the name, the state, and the numeric
+// fields from ppid (3) through rss (23), numbered as in proc(5) minus one
+static bool parseStat(const char* buffer, size_t count, std::string& name, std::string& state,
+                      unsigned long long (&fields)[STAT_FIELDS]) {
+    if (count == 0) {
+        return false;
+    }
+    
+    // The name is parenthesised and may itself contain spaces or ')'
+    const char* name_start = std::strchr(buffer, '(');
+    const char* name_end = std::strrchr(buffer, ')');
+    if (name_start == nullptr || name_end == nullptr || name_end < name_start || name_end + 2 >= buffer + count) {
+        return false;
+    }
+    name.assign(name_start + 1, name_end - name_start - 1);
+    state.assign(1, name_end[2]);
+    
+    fields[0] = fields[1] = fields[2] = 0;
+    const char* position = name_end + 3;
+    char* cursor = nullptr;
+    for (int field = 3; field < STAT_FIELDS; field++) {
+        fields[field] = std::strtoull(position, &cursor, 10);
+        position = cursor;
+    }
+    return true;
+}
+
+// The pids of this window that the scan will re-read, i.e. the ones not
+// carried forward while sampling
+void ProcessMonitor::readStatWindow(size_t first) {
+    batch_pids.clear();
+    size_t last = std::min(first + ProcFileBatch::WINDOW, pid_buffer.size());
+    for (size_t i = first; i < last; i++) {
+        int pid = pid_buffer[i];
+        if (sample_stride <= 1 || pid % sample_stride == scan_count % sample_stride) {
+            batch_pids.push_back(pid);
+        }
+    }
+    stat_reads.read(batch_pids, "stat");
+}
+
+bool ProcessMonitor::readProcessStat(int pid, ProcessInfo& info, unsigned long long& cpu_time) {
+    const char* buffer = nullptr;
+    size_t count = 0;
+    char local[1024];
+    
+    // From the window read ahead, or on its own (new pids outside their turn)
+    if (!batched_reads || !stat_reads.find(pid, buffer, count)) {
+        char path[64];
+        std::snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        ssize_t bytes = read(fd, local, sizeof(local) - 1);
+        close(fd);
+        if (bytes <= 0) {
+            return false;
+        }
+        local[bytes] = '\0';
+        buffer = local;
+        count = static_cast<size_t>(bytes);
+    }
+    
+    unsigned long long fields[STAT_FIELDS];
+    if (!parseStat(buffer, count, info.name, info.state, fields)) {
+        return false;
+    }
+    info.parent_pid = static_cast<int>(fields[3]);
+    cpu_time = fields[13] + fields[14];     // utime + stime
+    info.start_ticks = fields[21];
+    info.memory_usage = static_cast<long>(fields[22] / 1024); // vsize
+    return true;
+}
+
+void ProcessMonitor::loadIdentity(const ProcessInfo& info, ProcessCacheEntry& entry) {
+    int pid = info.pid;
+    char path[64];
+    entry.command.clear();
+    entry.executable.clear();
+    entry.uid = -1;
+    
+    time_t started = static_cast<time_t>(boot_time + static_cast<long long>(info.start_ticks / clock_ticks));
+    entry.start_time = PlatformUtils::formatTimestamp(started);
+    
+    // Arguments are NUL-separated; very long command lines are truncated
+    std::snprintf(path, sizeof(path), "/proc/%d/cmdline", pid);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        char buffer[4096];
+        ssize_t count = read(fd, buffer, sizeof(buffer));
+        close(fd);
+        if (count > 0) {
+            std::replace(buffer, buffer + count, '\0', ' ');
+            while (count > 0 && buffer[count - 1] == ' ') {
+                count--;
+            }
+            entry.command.assign(buffer, count);
+        }
+    }
+    
+    // Unreadable for kernel threads and other users' processes when unprivileged
+    std::snprintf(path, sizeof(path), "/proc/%d/exe", pid);
+    char target[PATH_MAX];
+    ssize_t length = readlink(path, target, sizeof(target));
+    if (length > 0) {
+        entry.executable.assign(target, length);
+    }
+    
+    std::snprintf(path, sizeof(path), "/proc/%d", pid);
+    struct stat status;
+    if (stat(path, &status) == 0) {
+        entry.uid = static_cast<int>(status.st_uid);
+    }
+    
+    // Membership rarely changes after start; the unified hierarchy is the "0::" line
+    entry.cgroup.clear();
+    std::snprintf(path, sizeof(path), "/proc/%d/cgroup", pid);
+    if (PlatformUtils::readFileInto(path, read_buffer)) {
+        const char* line = std::strstr(read_buffer.data(), "0::");
+        if (line != nullptr && (line == read_buffer.data() || line[-1] == '\n')) {
+            const char* end = std::strchr(line, '\n');
+            entry.cgroup.assign(line + 3, end != nullptr ? end - line - 3 : std::strlen(line + 3));
+        }
+    }
+    
+    entry.identity_loaded = true;
+}
+
+void ProcessMonitor::loadDetails(int pid, ProcessCacheEntry& entry) {
+    char path[64];
+    ProcessInfo& details = entry.details;
+    
+    std::snprintf(path, sizeof(path), "/proc/%d/status", pid);
+    if (PlatformUtils::readFileInto(path, read_buffer)) {
+        details.resident_kb = static_cast<long>(PlatformUtils::findField(read_buffer, "VmRSS:"));
+        details.swap_kb = static_cast<long>(PlatformUtils::findField(read_buffer, "VmSwap:"));
+        details.thread_count = static_cast<int>(PlatformUtils::findField(read_buffer, "Threads:"));
+    }
+    
+    // smaps_rollup walks the page tables, which is why this tier is rationed
+    std::snprintf(path, sizeof(path), "/proc/%d/smaps_rollup", pid);
+    if (PlatformUtils::readFileInto(path, read_buffer)) {
+        details.pss_kb = static_cast<long>(PlatformUtils::findField(read_buffer, "Pss:"));
+    }
+    
+    std::snprintf(path, sizeof(path), "/proc/%d/fd", pid);
+    details.fd_count = -1;
+    DIR* fd_dir = opendir(path);
+    if (fd_dir != nullptr) {
+        int count = 0;
+        struct dirent* fd_entry;
+        while ((fd_entry = readdir(fd_dir)) != nullptr) {
+            if (fd_entry->d_name[0] != '.') {
+                count++;
+            }
+        }
+        closedir(fd_dir);
+        details.fd_count = count;
+    }
+    details.has_details = true;
+}
+
+void ProcessMonitor::sampleActivity(int pid, ProcessCacheEntry& entry, std::chrono::steady_clock::time_point now) {
+    char path[64];
+    ProcessInfo& details = entry.details;
+    unsigned long long read_bytes = details.read_bytes;
+    unsigned long long write_bytes = details.write_bytes;
+    unsigned long long run_delay_ns = entry.run_delay_ns;
+    
+    // Other users' io is only readable with CAP_SYS_PTRACE; rates then stay zero
+    std::snprintf(path, sizeof(path), "/proc/%d/io", pid);
+    if (PlatformUtils::readFileInto(path, read_buffer)) {
+        read_bytes = PlatformUtils::findField(read_buffer, "read_bytes:");
+        write_bytes = PlatformUtils::findField(read_buffer, "write_bytes:");
+    }
+    
+    // "<on-cpu ns> <run-queue wait ns> <timeslices>", for the main thread only
+    std::snprintf(path, sizeof(path), "/proc/%d/schedstat", pid);
+    if (PlatformUtils::readFileInto(path, read_buffer)) {
+        char* cursor;
+        std::strtoull(read_buffer.data(), &cursor, 10);
+        run_delay_ns = std::strtoull(cursor, nullptr, 10);
+    }
+    
+    // Rates need a sample from the previous scan; a process that rejoins the
+    // hot set after a gap starts over
+    double interval = std::chrono::duration<double>(now - entry.activity_time).count();
+    details.has_io_stats = false;
+    if (entry.activity_scan != 0 && entry.activity_scan + 1 == scan_count && interval > 0.0) {
+        details.read_bytes_rate = read_bytes >= details.read_bytes ? (read_bytes - details.read_bytes) / interval : 0.0;
+        details.write_bytes_rate = write_bytes >= details.write_bytes ? (write_bytes - details.write_bytes) / interval : 0.0;
+        details.run_delay_ms = run_delay_ns >= entry.run_delay_ns ? (run_delay_ns - entry.run_delay_ns) / 1e6 / interval : 0.0;
+        details.has_io_stats = true;
+    }
     
-    for (const auto& process : current_processes) {
-        previous_processes[process.pid] = process;
+    details.read_bytes = read_bytes;
+    details.write_bytes = write_bytes;
+    entry.run_delay_ns = run_delay_ns;
+    entry.activity_time = now;
+    entry.activity_scan = scan_count;
+}
+
+void ProcessMonitor::refreshHotProcesses() {
+    // The first scan and every DETAIL_INTERVAL-th after it re-rank the hot set
+    bool periodic = scan_count % DETAIL_INTERVAL == 1;
+    
+    if (periodic) {
+        for (auto& pair : process_cache) {
+            pair.second.hot = false;
+        }
+        
+        hot_order.resize(current_snapshot.size());
+        for (size_t i = 0; i < hot_order.size(); i++) {
+            hot_order[i] = i;
+        }
+        size_t top = std::min(DETAIL_TOP_N, hot_order.size());
+        
+        std::partial_sort(hot_order.begin(), hot_order.begin() + top, hot_order.end(), [this](size_t a, size_t b) {
+            return current_snapshot[a].cpu_usage > current_snapshot[b].cpu_usage;
+        });
+        for (size_t i = 0; i < top; i++) {
+            process_cache[keyOf(current_snapshot[hot_order[i]])].hot = true;
+        }
+        
+        std::partial_sort(hot_order.begin(), hot_order.begin() + top, hot_order.end(), [this](size_t a, size_t b) {
+            return current_snapshot[a].memory_usage > current_snapshot[b].memory_usage;
+        });
+        for (size_t i = 0; i < top; i++) {
+            process_cache[keyOf(current_snapshot[hot_order[i]])].hot = true;
+        }
+    }
+    
+    size_t hot_count = 0;
+    for (const auto& info : current_snapshot) {
+        if (process_cache[keyOf(info)].hot) {
+            hot_count++;
+        }
+    }
+    
+    auto now = std::chrono::steady_clock::now();
+    for (auto& info : current_snapshot) {
+        ProcessCacheEntry& entry = process_cache[keyOf(info)];
+        
+        // Flagged processes and those blocked in uninterruptible (usually
+        // disk) wait join between re-rankings, up to the cap
+        if (!entry.hot && (entry.open_alerts > 0 || info.state == "D") && hot_count < MAX_HOT_PROCESSES) {
+            entry.hot = true;
+            hot_count++;
+        }
+        if (!entry.hot) {
+            continue;
+        }
+        
+        sampleActivity(info.pid, entry, now);
+        if (periodic || entry.details_scan == 0 || scan_count - entry.details_scan >= DETAIL_INTERVAL) {
+            loadDetails(info.pid, entry);
+            entry.details_scan = scan_count;
+        }
+        copyDetails(entry.details, info);
     }
 }
 
+void ProcessMonitor::scanThreads() {
+    if (thread_top_n == 0 || !details_enabled) {
+        thread_snapshot.clear();
+        thread_cache.clear();
+        return;
+    }
+    
+    // Busiest first, so they are covered before the budget runs out
+    hot_order.resize(current_snapshot.size());
+    for (size_t i = 0; i < hot_order.size(); i++) {
+        hot_order[i] = i;
+    }
+    size_t top = std::min(thread_top_n, hot_order.size());
+    std::partial_sort(hot_order.begin(), hot_order.begin() + top, hot_order.end(), [this](size_t a, size_t b) {
+        return current_snapshot[a].cpu_usage > current_snapshot[b].cpu_usage;
+    });
+    
+    auto now = std::chrono::steady_clock::now();
+    size_t budget = thread_budget;
+    size_t count = 0;
+    for (size_t rank = 0; rank < top && budget > 0; rank++) {
+        const ProcessInfo& process = current_snapshot[hot_order[rank]];
+        if (process.cpu_usage <= 0.0) {
+            break;  // Nothing running to attribute
+        }
+        listThreads(process.pid);
+        if (tid_buffer.empty()) {
+            continue;
+        }
+        
+        // An even share of what is left; a process with more threads than
+        // that continues where it stopped on the next scan
+        size_t share = std::max<size_t>(budget / (top - rank), 1);
+        size_t take = std::min(tid_buffer.size(), share);
+        ProcessCacheEntry& entry = process_cache[keyOf(process)];
+        size_t first = take < tid_buffer.size() ? entry.thread_offset % tid_buffer.size() : 0;
+        entry.thread_offset = first + take;
+        budget -= take;
+        
+        // Scans until the rotation comes back to a thread, with slack for
+        // the share shrinking when other processes get busier
+        uint64_t rotation = (tid_buffer.size() + take - 1) / take;
+        uint64_t keep_until = scan_count + std::max<uint64_t>(THREAD_CACHE_SCANS, 2 * rotation);
+        
+        for (size_t n = 0; n < take; n++) {
+            int tid = tid_buffer[(first + n) % tid_buffer.size()];
+            if (count == thread_snapshot.size()) {
+                thread_snapshot.emplace_back();
+            }
+            ThreadInfo& thread = thread_snapshot[count];
+            unsigned long long cpu_time = 0;
+            unsigned long long start_ticks = 0;
+            if (!readThreadStat(process.pid, tid, thread, cpu_time, start_ticks)) {
+                continue;   // Exited since the listing
+            }
+            thread.process_name = process.name;
+            thread.cpu_usage = 0.0;
+            
+            // Against the thread's own last sample, which is further back
+            // for threads covered in turns
+            ThreadCacheEntry& cached = thread_cache[ProcessKey{tid, start_ticks}];
+            if (cached.last_seen_scan != 0 && cpu_time >= cached.cpu_time) {
+                double seconds = std::chrono::duration<double>(now - cached.sample_time).count();
+                if (seconds > 0.0) {
+                    thread.cpu_usage = static_cast<double>(cpu_time - cached.cpu_time) / clock_ticks / seconds * 100.0;
+                }
+            }
+            cached.cpu_time = cpu_time;
+            cached.sample_time = now;
+            cached.last_seen_scan = scan_count;
+            cached.keep_until_scan = keep_until;
+            count++;
+        }
+    }
+    thread_snapshot.resize(count);
+    
+    // Threads that exited, or whose process left the top set a while ago
+    for (auto it = thread_cache.begin(); it != thread_cache.end(); ) {
+        if (it->second.keep_until_scan < scan_count) {
+            it = thread_cache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// Thread ids of a process, sorted so a listing resumes at a stable position
+void ProcessMonitor::listThreads(int pid) {
+    tid_buffer.clear();
+    char path[64];
+    std::snprintf(path, sizeof(path), "/proc/%d/task", pid);
+    DIR* task_dir = opendir(path);
+    if (task_dir == nullptr) {
+        return;
+    }
+    struct dirent* task_entry;
+    while ((task_entry = readdir(task_dir)) != nullptr) {
+        if (task_entry->d_name[0] >= '0' && task_entry->d_name[0] <= '9') {
+            tid_buffer.push_back(std::atoi(task_entry->d_name));
+        }
+    }
+    closedir(task_dir);
+    std::sort(tid_buffer.begin(), tid_buffer.end());
+}
+
+bool ProcessMonitor::readThreadStat(int pid, int tid, ThreadInfo& thread, unsigned long long& cpu_time,
+                                   unsigned long long& start_ticks) {
+    char path[64];
+    std::snprintf(path, sizeof(path), "/proc/%d/task/%d/stat", pid, tid);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    char buffer[1024];
+    ssize_t count = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (count <= 0) {
+        return false;
+    }
+    buffer[count] = '\0';
+    
+    unsigned long long fields[STAT_FIELDS];
+    if (!parseStat(buffer, static_cast<size_t>(count), thread.name, thread.state, fields)) {
+        return false;
+    }
+    thread.pid = pid;
+    thread.tid = tid;
+    cpu_time = fields[13] + fields[14];
+    start_ticks = fields[21];
+    return true;
+}
+
+#endif
+
 long ProcessMonitor::getSystemMemoryTotal() {
 #ifdef PLATFORM_WINDOWS
     MEMORYSTATUSEX memInfo;
@@ -0,0 +1,162 @@
+#include "../include/ProcessTree.h"
+#include <algorithm>
+
+ProcessTree::ProcessTree() {
+    // Cleanup if needed
+}
+
+ProcessTree::~ProcessTree() {
+    // Cleanup if needed
+}
+
+void ProcessTree::link(int pid, int parent_pid) {
+    ProcessTreeNode& node = nodes[pid];
+    auto parent = nodes.find(parent_pid);
+    if (parent_pid == pid || parent == nodes.end()) {
+        // Parent not tracked (pid 0, or filtered out); retried next update
+        node.parent_pid = 0;
+        return;
+    }
+    parent->second.children.push_back(pid);
+    node.parent_pid = parent_pid;
+}
+
+void ProcessTree::unlink(int pid, int parent_pid) {
+    auto parent = nodes.find(parent_pid);
+    if (parent == nodes.end()) {
+        return;
+    }
+    std::vector<int>& siblings = parent->second.children;
+    auto it = std::find(siblings.begin(), siblings.end(), pid);
+    if (it != siblings.end()) {
+        *it = siblings.back();
+        siblings.pop_back();
+    }
+}
+
+void ProcessTree::update(const std::vector<ProcessInfo>& current,
+                         const std::vector<ProcessInfo>& started,
+                         const std::vector<int>& exited) {
+    for (int pid : exited) {
+        auto it = nodes.find(pid);
+        if (it == nodes.end()) {
+            continue;
+        }
+        unlink(pid, it->second.parent_pid);
+
+        // The kernel reparents orphans; until we see their new ppid they float.
+        // Clearing the link also keeps them off a new process reusing this pid.
+        for (int child : it->second.children) {
+            auto orphan = nodes.find(child);
+            if (orphan != nodes.end()) {
+                orphan->second.parent_pid = 0;
+            }
+        }
+        nodes.erase(it);
+    }
+
+    for (const auto& process : started) {
+        ProcessTreeNode& node = nodes[process.pid];
+        node.pid = process.pid;
+        node.parent_pid = 0;
+        node.name = process.name;
+        node.children.clear();
+    }
+
+    // Refresh metrics; the first update also inserts everything already running
+    for (const auto& process : current) {
+        auto it = nodes.find(process.pid);
+        if (it == nodes.end()) {
+            ProcessTreeNode node;
+            node.pid = process.pid;
+            node.parent_pid = 0;
+            it = nodes.emplace(process.pid, node).first;
+        }
+        it->second.name = process.name;
+        it->second.cpu_usage = process.cpu_usage;
+        it->second.memory_usage = process.memory_usage;
+    }
+
+    // Link after inserting so parents and children may arrive in any order
+    for (const auto& process : current) {
+        ProcessTreeNode& node = nodes[process.pid];
+        if (node.parent_pid == process.parent_pid) {
+            continue;
+        }
+        unlink(process.pid, node.parent_pid);
+        link(process.pid, process.parent_pid);
+    }
+}
+
+const ProcessTreeNode* ProcessTree::find(int pid) const {
+    auto it = nodes.find(pid);
+    return it != nodes.end() ? &it->second : nullptr;
+}
+
+std::vector<const ProcessTreeNode*> ProcessTree::ancestors(int pid, size_t max_depth) const {
+    std::vector<const ProcessTreeNode*> chain;
+    const ProcessTreeNode* node = find(pid);
+    max_depth = std::min(max_depth, MAX_DEPTH);
+
+    while (node != nullptr && node->parent_pid != 0 && chain.size() < max_depth) {
+        node = find(node->parent_pid);
+        if (node != nullptr) {
+            chain.push_back(node);
+        }
+    }
+    return chain;
+}
+
+ProcessTreeTotals ProcessTree::subtreeTotals(int pid) const {
+    ProcessTreeTotals totals;
+    totals.pid = pid;
+    totals.cpu_usage = 0.0;
+    totals.memory_usage = 0;
+    totals.process_count = 0;
+
+    const ProcessTreeNode* root = find(pid);
+    if (root == nullptr) {
+        return totals;
+    }
+    totals.name = root->name;
+
+    std::vector<const ProcessTreeNode*> pending(1, root);
+    while (!pending.empty() && totals.process_count < static_cast<int>(nodes.size())) {
+        const ProcessTreeNode* node = pending.back();
+        pending.pop_back();
+        totals.cpu_usage += node->cpu_usage;
+        totals.memory_usage += node->memory_usage;
+        totals.process_count++;
+
+        for (int child : node->children) {
+            const ProcessTreeNode* child_node = find(child);
+            if (child_node != nullptr) {
+                pending.push_back(child_node);
+            }
+        }
+    }
+    return totals;
+}
+
+std::vector<ProcessTreeTotals> ProcessTree::largestSubtrees(int root_pid, size_t count) const {
+    std::vector<ProcessTreeTotals> subtrees;
+    const ProcessTreeNode* root = find(root_pid);
+    if (root == nullptr) {
+        return subtrees;
+    }
+
+    for (int child : root->children) {
+        subtrees.push_back(subtreeTotals(child));
+    }
+    count = std::min(count, subtrees.size());
+    std::partial_sort(subtrees.begin(), subtrees.begin() + count, subtrees.end(),
+                      [](const ProcessTreeTotals& a, const ProcessTreeTotals& b) {
+                          return a.cpu_usage > b.cpu_usage;
+                      });
+    subtrees.resize(count);
+    return subtrees;
+}
+
+size_t ProcessTree::size() const {
+    return nodes.size();
+}
@@ -0,0 +1,469 @@
+#include "../include/ProcessWatcher.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <cstdint>
+
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_MACOS)
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <sys/wait.h>
+
+// PIDFD_GET_INFO (6.13) with exit information (6.15); older headers lack
+// both, so the layout of the first version is spelled out here
+struct PidfdInfo {
+    uint64_t mask;
+    uint64_t cgroupid;
+    uint32_t pid;
+    uint32_t tgid;
+    uint32_t ppid;
+    uint32_t ruid;
+    uint32_t rgid;
+    uint32_t euid;
+    uint32_t egid;
+    uint32_t suid;
+    uint32_t sgid;
+    uint32_t fsuid;
+    uint32_t fsgid;
+    int32_t exit_code;
+};
+static const uint64_t PIDFD_INFO_EXIT_MASK = 1ULL << 3;
+static const unsigned long PIDFD_GET_INFO_REQUEST = _IOWR(0xFF, 11, PidfdInfo);
+
+static const int CAP_SYS_PTRACE_BIT = 19;
+
+static bool readSmallFile(const char* path, char* buffer, size_t size) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    ssize_t count = read(fd, buffer, size - 1);
+    close(fd);
+    if (count <= 0) {
+        return false;
+    }
+    buffer[count] = '\0';
+    return true;
+}
+
+// Real, effective and saved ids of a "Uid:" / "Gid:" line all equal id
+static bool idsMatch(const char* status, const char* key, unsigned long id) {
+    const char* line = std::strstr(status, key);
+    if (line == nullptr) {
+        return false;
+    }
+    char* cursor = const_cast<char*>(line) + std::strlen(key);
+    for (int i = 0; i < 3; i++) {
+        if (std::strtoul(cursor, &cursor, 10) != id) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The kernel shows a zombie's exit code in /proc/<pid>/stat only to readers
+// allowed to ptrace-read it (same ids, or CAP_SYS_PTRACE); others read 0
+static bool exitCodeVisible(int pid) {
+    static const bool ptrace_capable = [] {
+        char status[4096];
+        if (!readSmallFile("/proc/self/status", status, sizeof(status))) {
+            return false;
+        }
+        const char* line = std::strstr(status, "\nCapEff:");
+        return line != nullptr && (std::strtoull(line + 8, nullptr, 16) >> CAP_SYS_PTRACE_BIT & 1) != 0;
+    }();
+    if (ptrace_capable) {
+        return true;
+    }
+
+    char path[64];
+    std::snprintf(path, sizeof(path), "/proc/%d/status", pid);
+    char status[4096];
+    return readSmallFile(path, status, sizeof(status)) &&
+           idsMatch(status, "\nUid:", geteuid()) && idsMatch(status, "\nGid:", getegid());
+}
+#endif
+
+ProcessWatcher::ProcessWatcher(EventRouter& router)
+    : router(router), pidfd_supported(false), epoll_fd(-1), wake_fd(-1), stopping(false), limit_reported(false) {
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_MACOS)
+    int fd = static_cast<int>(syscall(SYS_pidfd_open, getpid(), 0));
+    if (fd >= 0) {
+        pidfd_supported = true;
+        close(fd);
+    }
+#endif
+}
+
+ProcessWatcher::~ProcessWatcher() {
+    stop();
+}
+
+void ProcessWatcher::setWatchList(const std::vector<std::string>& watch_names) {
+    std::lock_guard<std::mutex> lock(mutex);
+    names = watch_names;
+    std::sort(names.begin(), names.end());
+
+    auto unwatched = [this](const std::string& name) {
+        return !std::binary_search(names.begin(), names.end(), name);
+    };
+    for (auto& watch : watches) {
+        if (unwatched(watch.name)) {
+            release(watch);
+        }
+    }
+    watches.erase(std::remove_if(watches.begin(), watches.end(),
+                                 [&unwatched](const Watch& watch) { return unwatched(watch.name); }),
+                  watches.end());
+    exited_names.erase(std::remove_if(exited_names.begin(), exited_names.end(), unwatched), exited_names.end());
+}
+
+void ProcessWatcher::update(const std::vector<ProcessInfo>& processes) {
+    std::vector<AnomalyAlert> alerts;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (names.empty()) {
+            return;
+        }
+
+        // Exits already reported stay out until their zombie is reaped
+        exited.erase(std::remove_if(exited.begin(), exited.end(), [&processes](const Watch& gone) {
+            return std::none_of(processes.begin(), processes.end(), [&gone](const ProcessInfo& process) {
+                return process.pid == gone.pid && process.start_ticks == gone.start_ticks;
+            });
+        }), exited.end());
+
+        for (const auto& process : processes) {
+            if (process.state == "Z" || !std::binary_search(names.begin(), names.end(), process.name)) {
+                continue;
+            }
+            auto same = [&process](const Watch& watch) {
+                return watch.pid == process.pid && watch.start_ticks == process.start_ticks;
+            };
+            if (std::any_of(watches.begin(), watches.end(), same) ||
+                std::any_of(exited.begin(), exited.end(), same) || !attach(process)) {
+                continue;
+            }
+
+            auto back = std::find(exited_names.begin(), exited_names.end(), process.name);
+            if (back != exited_names.end()) {
+                exited_names.erase(back);
+                AnomalyAlert alert;
+                alert.type = "WATCHED_PROCESS_EXITED";
+                alert.entity = process.name;
+                alert.pid = process.pid;
+                alert.severity = "INFO";
+                alert.state = "RESOLVED";
+                alert.message = "Watched process " + process.name + " restarted as PID " + std::to_string(process.pid);
+                alert.details = "PID: " + std::to_string(process.pid);
+                alert.timestamp = "";
+                alerts.push_back(alert);
+            }
+        }
+    }
+
+    for (const auto& alert : alerts) {
+        AgentEvent event{EventType::ANOMALY_DETECTED};
+        event.alert = alert;
+        router.deliver(std::move(event));
+    }
+}
+
+AnomalyAlert ProcessWatcher::exitAlert(const Watch& watch, int status) const {
+    AnomalyAlert alert;
+    alert.type = "WATCHED_PROCESS_EXITED";
+    alert.entity = watch.name;
+    alert.pid = watch.pid;
+    alert.severity = "CRITICAL";
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_MACOS)
+    if (status >= 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+        alert.severity = "WARNING";     // A clean stop is still worth knowing about
+    }
+#endif
+    alert.message = "Watched process " + watch.name + " (PID " + std::to_string(watch.pid) + ") " +
+                    describeStatus(status);
+    alert.details = "PID: " + std::to_string(watch.pid) + ", Exit status: " +
+                    (status >= 0 ? std::to_string(status) : std::string("unknown"));
+    alert.timestamp = "";
+    return alert;
+}
+
+#if defined(PLATFORM_WINDOWS) || defined(PLATFORM_MACOS)
+
+bool ProcessWatcher::start() {
+    return false;
+}
+
+void ProcessWatcher::stop() {
+}
+
+void ProcessWatcher::run() {
+}
+
+bool ProcessWatcher::attach(const ProcessInfo& process) {
+    (void)process;
+    return false;
+}
+
+void ProcessWatcher::release(Watch& watch) {
+    (void)watch;
+}
+
+bool ProcessWatcher::readStat(int pid, unsigned long long& start_ticks, bool& zombie, int& exit_code) {
+    (void)pid;
+    (void)start_ticks;
+    (void)zombie;
+    (void)exit_code;
+    return false;
+}
+
+int ProcessWatcher::exitStatus(const Watch& watch) {
+    (void)watch;
+    return -1;
+}
+
+std::string ProcessWatcher::describeStatus(int status) {
+    (void)status;
+    return "exited";
+}
+
+#else
+
+bool ProcessWatcher::start() {
+    if (worker.joinable()) {
+        return true;
+    }
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd < 0 || wake_fd < 0) {
+        stop();
+        return false;
+    }
+    epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = wake_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event);
+
+    if (!pidfd_supported) {
+        std::cerr << "pidfd_open is unavailable; checking watched processes in /proc every "
+                  << POLL_INTERVAL_MS << " ms" << std::endl;
+    }
+    stopping.store(false);
+    worker = std::thread(&ProcessWatcher::run, this);
+    return true;
+}
+
+void ProcessWatcher::stop() {
+    if (worker.joinable()) {
+        stopping.store(true);
+        uint64_t one = 1;
+        ssize_t written = write(wake_fd, &one, sizeof(one));
+        (void)written;
+        worker.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& watch : watches) {
+        release(watch);
+    }
+    watches.clear();
+    if (epoll_fd >= 0) {
+        close(epoll_fd);
+        epoll_fd = -1;
+    }
+    if (wake_fd >= 0) {
+        close(wake_fd);
+        wake_fd = -1;
+    }
+}
+
+void ProcessWatcher::run() {
+    epoll_event events[16];
+    std::vector<AnomalyAlert> alerts;
+
+    while (!stopping.load()) {
+        // Blocks until something exits; only the /proc fallback polls
+        int ready = epoll_wait(epoll_fd, events, 16, pidfd_supported ? -1 : POLL_INTERVAL_MS);
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (int i = 0; i < ready; i++) {
+                int fd = events[i].data.fd;
+                if (fd == wake_fd) {
+                    continue;
+                }
+                auto it = std::find_if(watches.begin(), watches.end(), [fd](const Watch& watch) {
+                    return watch.fd == fd;
+                });
+                if (it == watches.end()) {
+                    continue;
+                }
+                alerts.push_back(exitAlert(*it, exitStatus(*it)));
+                exited_names.push_back(it->name);
+                release(*it);
+                exited.push_back(*it);
+                watches.erase(it);
+            }
+
+            if (!pidfd_supported) {
+                for (auto it = watches.begin(); it != watches.end(); ) {
+                    unsigned long long start_ticks = 0;
+                    bool zombie = false;
+                    int exit_code = 0;
+                    bool alive = readStat(it->pid, start_ticks, zombie, exit_code) && start_ticks == it->start_ticks;
+                    if (alive && !zombie) {
+                        ++it;
+                        continue;
+                    }
+                    alerts.push_back(exitAlert(*it, alive ? exit_code : -1));
+                    exited_names.push_back(it->name);
+                    exited.push_back(*it);
+                    it = watches.erase(it);
+                }
+            }
+        }
+
+        for (const auto& alert : alerts) {
+            AgentEvent event{EventType::ANOMALY_DETECTED};
+            event.alert = alert;
+            router.deliver(std::move(event));
+        }
+        alerts.clear();
+    }
+}
+
+// Called with the mutex held
+bool ProcessWatcher::attach(const ProcessInfo& process) {
+    if (watches.size() >= MAX_WATCHED) {
+        if (!limit_reported) {
+            std::cerr << "Watching the maximum of " << MAX_WATCHED << " processes; "
+                      << process.name << " (PID " << process.pid << ") is not watched" << std::endl;
+            limit_reported = true;
+        }
+        return false;
+    }
+
+    Watch watch{process.pid, process.start_ticks, process.name, -1};
+    if (pidfd_supported) {
+        watch.fd = static_cast<int>(syscall(SYS_pidfd_open, process.pid, 0));
+        if (watch.fd < 0) {
+            return false;   // Gone since the scan
+        }
+    }
+
+    // The pid may have been reused since the scan; the pidfd now pins
+    // whichever process holds it, so check that it is still the same one
+    unsigned long long start_ticks = 0;
+    bool zombie = false;
+    int exit_code = 0;
+    if (!readStat(process.pid, start_ticks, zombie, exit_code) || start_ticks != process.start_ticks) {
+        release(watch);
+        return false;
+    }
+
+    if (watch.fd >= 0) {
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.fd = watch.fd;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, watch.fd, &event) < 0) {
+            release(watch);
+            return false;
+        }
+    }
+    watches.push_back(watch);
+    return true;
+}
+
+void ProcessWatcher::release(Watch& watch) {
+    if (watch.fd >= 0) {
+        if (epoll_fd >= 0) {
+            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, watch.fd, nullptr);
+        }
+        close(watch.fd);
+        watch.fd = -1;
+    }
+}
+
+// Start time (field 22), and for zombies the wait status (field 52), or -1
+// when it is hidden from us and 0 would only be a placeholder
+bool ProcessWatcher::readStat(int pid, unsigned long long& start_ticks, bool& zombie, int& exit_code) {
+    char path[64];
+    std::snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    char buffer[1024];
+    ssize_t count = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (count <= 0) {
+        return false;
+    }
+    buffer[count] = '\0';
+
+    char* name_end = std::strrchr(buffer, ')');
+    if (name_end == nullptr || name_end + 2 >= buffer + count) {
+        return false;
+    }
+    zombie = name_end[2] == 'Z';
+
+    unsigned long long fields[53] = {0};
+    char* cursor = name_end + 3;
+    for (int field = 3; field < 53; field++) {
+        fields[field] = std::strtoull(cursor, &cursor, 10);
+    }
+    start_ticks = fields[21];
+    exit_code = zombie && exitCodeVisible(pid) ? static_cast<int>(fields[51]) : -1;
+    return true;
+}
+
+// Wait status of an exited process we are not the parent of: from the
+// pidfd once the parent has reaped it (6.15+), otherwise from the zombie
+int ProcessWatcher::exitStatus(const Watch& watch) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        PidfdInfo info;
+        std::memset(&info, 0, sizeof(info));
+        info.mask = PIDFD_INFO_EXIT_MASK;
+        if (ioctl(watch.fd, PIDFD_GET_INFO_REQUEST, &info) == 0 && (info.mask & PIDFD_INFO_EXIT_MASK)) {
+            return info.exit_code;
+        }
+
+        unsigned long long start_ticks = 0;
+        bool zombie = false;
+        int exit_code = 0;
+        if (readStat(watch.pid, start_ticks, zombie, exit_code) && start_ticks == watch.start_ticks && zombie) {
+            return exit_code;
+        }
+        // Reaped in between: the pidfd has the status now, if the kernel keeps it
+    }
+    return -1;
+}
+
+std::string ProcessWatcher::describeStatus(int status) {
+    if (status < 0) {
+        return "exited (status unavailable)";
+    }
+    if (WIFEXITED(status)) {
+        return "exited with status " + std::to_string(WEXITSTATUS(status));
+    }
+    if (WIFSIGNALED(status)) {
+        return "was killed by signal " + std::to_string(WTERMSIG(status)) +
+               (WCOREDUMP(status) ? " (core dumped)" : "");
+    }
+    return "exited";
+}
+
+#endif
@@ -0,0 +1,102 @@
+#include "../include/RateCounter.h"
+#include "../include/PlatformUtils.h"
+#include <cstring>
+
+SlidingWindowCounter::SlidingWindowCounter() {
+    clear();
+}
+
+void SlidingWindowCounter::clear() {
+    std::memset(buckets, 0, sizeof(buckets));
+    head_second = 0;
+    window_total = 0;
+}
+
+void SlidingWindowCounter::advance(int64_t now) {
+    if (now <= head_second) {
+        return; // Same second, or the caller's clock stepped back
+    }
+
+    // Expire every bucket that slid out of the window, at most one full ring
+    int64_t steps = now - head_second;
+    if (steps >= WINDOW_SECONDS) {
+        std::memset(buckets, 0, sizeof(buckets));
+        window_total = 0;
+    } else {
+        for (int64_t s = head_second + 1; s <= now; s++) {
+            uint32_t& bucket = buckets[s % WINDOW_SECONDS];
+            window_total -= bucket;
+            bucket = 0;
+        }
+    }
+    head_second = now;
+}
+
+void SlidingWindowCounter::add(int64_t now, uint32_t count) {
+    advance(now);
+    buckets[head_second % WINDOW_SECONDS] += count;
+    window_total += count;
+}
+
+uint64_t SlidingWindowCounter::total(int64_t now) {
+    advance(now);
+    return window_total;
+}
+
+KeyedRateCounter::KeyedRateCounter(size_t capacity) {
+    set_count = capacity / SET_WAYS;
+    if (set_count == 0) {
+        set_count = 1;
+    }
+    slots.resize(set_count * SET_WAYS);
+    for (auto& slot : slots) {
+        slot.key = 0;
+    }
+}
+
+uint64_t KeyedRateCounter::hashKey(const std::string& key) {
+    uint64_t hash = PlatformUtils::fnv1a(key);
+    return hash == 0 ? 1 : hash;
+}
+
+uint64_t KeyedRateCounter::add(const std::string& key, int64_t now, uint32_t count) {
+    uint64_t hash = hashKey(key);
+    Slot* set = &slots[(hash % set_count) * SET_WAYS];
+    Slot* victim = nullptr;
+    uint64_t victim_total = UINT64_MAX;
+
+    for (size_t way = 0; way < SET_WAYS; way++) {
+        Slot& slot = set[way];
+        if (slot.key == hash) {
+            slot.counter.add(now, count);
+            return slot.counter.total(now);
+        }
+
+        uint64_t slot_total = slot.key == 0 ? 0 : slot.counter.total(now);
+        if (slot_total < victim_total) {
+            victim = &slot;
+            victim_total = slot_total;
+        }
+    }
+
+    victim->key = hash;
+    victim->counter.clear();
+    victim->counter.add(now, count);
+    return count;
+}
+
+uint64_t KeyedRateCounter::total(const std::string& key, int64_t now) {
+    uint64_t hash = hashKey(key);
+    Slot* set = &slots[(hash % set_count) * SET_WAYS];
+
+    for (size_t way = 0; way < SET_WAYS; way++) {
+        if (set[way].key == hash) {
+            return set[way].counter.total(now);
+        }
+    }
+    return 0;
+}
+
+size_t KeyedRateCounter::capacity() const {
+    return slots.size();
+}
@@ -0,0 +1,248 @@
+#include "../include/ResourceGovernor.h"
+#include "../include/PlatformUtils.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdio>
+
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_MACOS)
+    #include <sched.h>
+    #include <unistd.h>
+    #include <sys/resource.h>
+    #include <sys/time.h>
+#endif
+
+static const int MAX_CPUS = 1024;
+
+static const char* const level_names[] = {
+    "normal", "longer_interval", "no_process_details", "sampled_processes", "no_console"
+};
+
+ResourceGovernor::ResourceGovernor()
+    : cpu_budget(0.0), memory_budget_kb(0), current_level(0), over_cycles(0), under_cycles(0),
+      cpu_percent(0.0), rss_kb(0), last_cpu_us(0), has_sample(false) {
+    for (auto& count : degradations) {
+        count = 0;
+    }
+}
+
+ResourceGovernor::~ResourceGovernor() {
+    // Cleanup if needed
+}
+
+void ResourceGovernor::setBudget(double cpu_percent, long memory_mb) {
+    cpu_budget = cpu_percent;
+    memory_budget_kb = memory_mb * 1024;
+}
+
+unsigned long long ResourceGovernor::readCpuTimeUs() {
+#if defined(PLATFORM_WINDOWS) || defined(PLATFORM_MACOS)
+    return 0;
+#else
+    // All threads of the agent, user and system
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return static_cast<unsigned long long>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000ULL +
+           usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#endif
+}
+
+long ResourceGovernor::readRssKb() {
+#if defined(PLATFORM_WINDOWS) || defined(PLATFORM_MACOS)
+    return 0;
+#else
+    std::ifstream statm("/proc/self/statm");
+    long size_pages = 0;
+    long resident_pages = 0;
+    if (!(statm >> size_pages >> resident_pages)) {
+        return 0;
+    }
+    return resident_pages * (sysconf(_SC_PAGESIZE) / 1024);
+#endif
+}
+
+bool ResourceGovernor::update() {
+    auto now = std::chrono::steady_clock::now();
+    unsigned long long cpu_us = readCpuTimeUs();
+    rss_kb = readRssKb();
+
+    if (!has_sample) {
+        last_cpu_us = cpu_us;
+        last_time = now;
+        has_sample = true;
+        return false;
+    }
+
+    double wall_us = std::chrono::duration<double, std::micro>(now - last_time).count();
+    if (wall_us <= 0.0 || cpu_us < last_cpu_us) {
+        return false;
+    }
+    cpu_percent = (cpu_us - last_cpu_us) / wall_us * 100.0;
+    last_cpu_us = cpu_us;
+    last_time = now;
+
+    bool over = (cpu_budget > 0.0 && cpu_percent > cpu_budget) ||
+                (memory_budget_kb > 0 && rss_kb > memory_budget_kb);
+    // Comfortably inside: half the CPU budget, and memory with some slack
+    bool comfortable = (cpu_budget <= 0.0 || cpu_percent < cpu_budget * 0.5) &&
+                       (memory_budget_kb <= 0 || rss_kb < memory_budget_kb * 9 / 10);
+
+    over_cycles = over ? over_cycles + 1 : 0;
+    under_cycles = comfortable && current_level > 0 ? under_cycles + 1 : 0;
+
+    char usage[160];
+    std::snprintf(usage, sizeof(usage), "CPU %.2f%% (budget %.2f%%), RSS %ld KB (budget %ld KB)",
+                  cpu_percent, cpu_budget, rss_kb, memory_budget_kb);
+
+    if (over_cycles >= OVER_BUDGET_CYCLES && current_level < MAX_LEVEL) {
+        current_level++;
+        degradations[current_level]++;
+        over_cycles = 0;
+
+        last_transition = AnomalyAlert();
+        last_transition.type = "AGENT_OVER_BUDGET";
+        last_transition.entity = "agent";
+        last_transition.severity = "WARNING";
+        last_transition.state = "DEGRADED";
+        last_transition.message = std::string("Agent over its resource budget, degraded to level ") +
+                                  std::to_string(current_level) + " (" + levelName(current_level) + ")";
+        last_transition.details = usage;
+        last_transition.timestamp = PlatformUtils::getCurrentTimestamp();
+        return true;
+    }
+
+    if (under_cycles >= UNDER_BUDGET_CYCLES) {
+        current_level--;
+        under_cycles = 0;
+
+        last_transition = AnomalyAlert();
+        last_transition.type = "AGENT_OVER_BUDGET";
+        last_transition.entity = "agent";
+        last_transition.severity = "INFO";
+        last_transition.state = "RESTORED";
+        last_transition.message = std::string("Agent within its resource budget, restored to level ") +
+                                  std::to_string(current_level) + " (" + levelName(current_level) + ")";
+        last_transition.details = usage;
+        last_transition.timestamp = PlatformUtils::getCurrentTimestamp();
+        return true;
+    }
+
+    return false;
+}
+
+int ResourceGovernor::level() const {
+    return current_level;
+}
+
+const char* ResourceGovernor::levelName(int level) {
+    if (level < 0 || level > MAX_LEVEL) {
+        return "unknown";
+    }
+    return level_names[level];
+}
+
+const AnomalyAlert& ResourceGovernor::transitionAlert() const {
+    return last_transition;
+}
+
+int ResourceGovernor::intervalMs(int configured_ms) const {
+    return current_level >= 1 ? configured_ms * 2 : configured_ms;
+}
+
+bool ResourceGovernor::detailsEnabled() const {
+    return current_level < 2;
+}
+
+unsigned int ResourceGovernor::sampleStride() const {
+    return current_level >= 3 ? SAMPLE_STRIDE : 1;
+}
+
+bool ResourceGovernor::consoleEnabled() const {
+    return current_level < 4;
+}
+
+double ResourceGovernor::cpuPercent() const {
+    return cpu_percent;
+}
+
+long ResourceGovernor::rssKb() const {
+    return rss_kb;
+}
+
+uint64_t ResourceGovernor::degradationCount(int level) const {
+    if (level < 1 || level > MAX_LEVEL) {
+        return 0;
+    }
+    return degradations[level];
+}
+
+bool ResourceGovernor::parseCpuList(const std::string& list, std::vector<int>& cpus) {
+    std::string entries = list;
+    std::replace(entries.begin(), entries.end(), ',', ' ');
+
+    std::istringstream iss(entries);
+    std::string token;
+    while (iss >> token) {
+        int first = 0;
+        int last = 0;
+        char dash = 0;
+        std::istringstream range(token);
+        if (!(range >> first)) {
+            return false;
+        }
+        last = first;
+        if (range >> dash && (dash != '-' || !(range >> last))) {
+            return false;
+        }
+        if (first < 0 || last < first || last >= MAX_CPUS) {
+            return false;
+        }
+        for (int cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return true;
+}
+
+bool ResourceGovernor::pinToCpus(const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return true;
+    }
+#if defined(PLATFORM_WINDOWS) || defined(PLATFORM_MACOS)
+    std::cerr << "CPU pinning is not supported on this platform" << std::endl;
+    return false;
+#else
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &set);
+    }
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        std::cerr << "Failed to pin the agent to the configured CPUs" << std::endl;
+        return false;
+    }
+    return true;
+#endif
+}
+
+bool ResourceGovernor::setNiceLevel(int nice_level) {
+    if (nice_level == 0) {
+        return true;
+    }
+#if defined(PLATFORM_WINDOWS) || defined(PLATFORM_MACOS)
+    std::cerr << "Nice levels are not supported on this platform" << std::endl;
+    return false;
+#else
+    if (setpriority(PRIO_PROCESS, 0, nice_level) != 0) {
+        std::cerr << "Failed to set nice level " << nice_level << std::endl;
+        return false;
+    }
+    return true;
+#endif
+}
@@ -0,0 +1,285 @@
+#include "../include/SnapshotDecoder.h"
+#include <cstring>
+
+using SnapshotFormat::getVarint;
+using SnapshotFormat::getSigned;
+
+SnapshotDecoder::SnapshotDecoder() : last_sequence(0), last_timestamp(0), synchronized(false) {
+}
+
+SnapshotDecoder::~SnapshotDecoder() {
+    // Cleanup if needed
+}
+
+bool SnapshotDecoder::readString(const char*& position, const char* end, uint32_t& id) const {
+    uint64_t value;
+    if (!getVarint(position, end, value) || value >= strings.size()) {
+        return false;
+    }
+    id = static_cast<uint32_t>(value);
+    return true;
+}
+
+bool SnapshotDecoder::decode(const std::string& message) {
+    const char* position = message.data();
+    const char* end = position + message.size();
+    if (position == end) {
+        return false;
+    }
+
+    uint8_t type = static_cast<uint8_t>(*position++);
+    uint64_t sequence_number;
+    uint64_t timestamp_ms;
+    if ((type != SnapshotFormat::KEYFRAME && type != SnapshotFormat::DELTA) ||
+        !getVarint(position, end, sequence_number) || !getVarint(position, end, timestamp_ms)) {
+        synchronized = false;
+        return false;
+    }
+
+    if (type == SnapshotFormat::KEYFRAME) {
+        strings.clear();
+        process_table.clear();
+        connection_table.clear();
+    } else if (!synchronized || sequence_number != last_sequence + 1) {
+        synchronized = false;
+        return false;
+    }
+
+    uint64_t added_strings;
+    if (!getVarint(position, end, added_strings)) {
+        synchronized = false;
+        return false;
+    }
+    for (uint64_t i = 0; i < added_strings; i++) {
+        uint64_t length;
+        if (!getVarint(position, end, length) || length > static_cast<uint64_t>(end - position)) {
+            synchronized = false;
+            return false;
+        }
+        strings.emplace_back(position, static_cast<size_t>(length));
+        position += length;
+    }
+
+    if (!decodeProcesses(position, end) || !decodeConnections(position, end) || position != end) {
+        synchronized = false;
+        return false;
+    }
+
+    last_sequence = sequence_number;
+    last_timestamp = timestamp_ms;
+    synchronized = true;
+    return true;
+}
+
+bool SnapshotDecoder::decodeProcesses(const char*& position, const char* end) {
+    uint64_t count;
+    uint64_t value;
+    int64_t signed_value;
+
+    if (!getVarint(position, end, count)) {
+        return false;
+    }
+    int pid = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        if (!getVarint(position, end, value)) {
+            return false;
+        }
+        pid += static_cast<int>(value);
+        process_table.erase(pid);
+    }
+
+    if (!getVarint(position, end, count)) {
+        return false;
+    }
+    pid = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        ProcessRecord record;
+        uint64_t parent;
+        uint64_t cpu;
+        uint64_t memory;
+        if (!getVarint(position, end, value) || !getVarint(position, end, record.start_ticks) ||
+            !getVarint(position, end, parent) || !readString(position, end, record.name) ||
+            !readString(position, end, record.command) || !readString(position, end, record.state) ||
+            !getVarint(position, end, cpu) || !getVarint(position, end, memory) ||
+            !getSigned(position, end, record.uid)) {
+            return false;
+        }
+        pid += static_cast<int>(value);
+        record.parent_pid = static_cast<int>(parent);
+        record.cpu = static_cast<int64_t>(cpu);
+        record.memory_kb = static_cast<int64_t>(memory);
+        process_table[pid] = record;
+    }
+
+    if (!getVarint(position, end, count)) {
+        return false;
+    }
+    pid = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        if (!getVarint(position, end, value) || position == end) {
+            return false;
+        }
+        pid += static_cast<int>(value);
+        auto it = process_table.find(pid);
+        if (it == process_table.end()) {
+            return false;
+        }
+        ProcessRecord& record = it->second;
+        uint8_t mask = static_cast<uint8_t>(*position++);
+
+        if (mask & SnapshotFormat::PROCESS_PARENT) {
+            if (!getVarint(position, end, value)) return false;
+            record.parent_pid = static_cast<int>(value);
+        }
+        if ((mask & SnapshotFormat::PROCESS_NAME) && !readString(position, end, record.name)) return false;
+        if ((mask & SnapshotFormat::PROCESS_COMMAND) && !readString(position, end, record.command)) return false;
+        if ((mask & SnapshotFormat::PROCESS_STATE) && !readString(position, end, record.state)) return false;
+        if (mask & SnapshotFormat::PROCESS_CPU) {
+            if (!getSigned(position, end, signed_value)) return false;
+            record.cpu += signed_value;
+        }
+        if (mask & SnapshotFormat::PROCESS_MEMORY) {
+            if (!getSigned(position, end, signed_value)) return false;
+            record.memory_kb += signed_value;
+        }
+        if ((mask & SnapshotFormat::PROCESS_UID) && !getSigned(position, end, record.uid)) return false;
+    }
+    return true;
+}
+
+bool SnapshotDecoder::readKey(const char*& position, const char* end, std::string& key, ConnectionRecord& record) const {
+    const char* start = position;
+    uint64_t local_port;
+    uint64_t remote_port;
+    if (!readString(position, end, record.protocol) || !readString(position, end, record.local_ip) ||
+        !getVarint(position, end, local_port) || !readString(position, end, record.remote_ip) ||
+        !getVarint(position, end, remote_port)) {
+        return false;
+    }
+    record.local_port = static_cast<int>(local_port);
+    record.remote_port = static_cast<int>(remote_port);
+    key.assign(start, static_cast<size_t>(position - start));
+    return true;
+}
+
+bool SnapshotDecoder::decodeConnections(const char*& position, const char* end) {
+    uint64_t count;
+    std::string key;
+    ConnectionRecord record;
+
+    if (!getVarint(position, end, count)) {
+        return false;
+    }
+    for (uint64_t i = 0; i < count; i++) {
+        if (!readKey(position, end, key, record)) {
+            return false;
+        }
+        connection_table.erase(key);
+    }
+
+    if (!getVarint(position, end, count)) {
+        return false;
+    }
+    for (uint64_t i = 0; i < count; i++) {
+        if (!readKey(position, end, key, record) || !readString(position, end, record.state) ||
+            !getSigned(position, end, record.pid) || !readString(position, end, record.process_name)) {
+            return false;
+        }
+        connection_table[key] = record;
+    }
+
+    if (!getVarint(position, end, count)) {
+        return false;
+    }
+    for (uint64_t i = 0; i < count; i++) {
+        if (!readKey(position, end, key, record) || position == end) {
+            return false;
+        }
+        auto it = connection_table.find(key);
+        if (it == connection_table.end()) {
+            return false;
+        }
+        uint8_t mask = static_cast<uint8_t>(*position++);
+        if ((mask & SnapshotFormat::CONNECTION_STATE) && !readString(position, end, it->second.state)) return false;
+        if ((mask & SnapshotFormat::CONNECTION_PID) && !getSigned(position, end, it->second.pid)) return false;
+        if ((mask & SnapshotFormat::CONNECTION_PROCESS) && !readString(position, end, it->second.process_name)) return false;
+    }
+    return true;
+}
+
+std::vector<ProcessInfo> SnapshotDecoder::processes() const {
+    std::vector<ProcessInfo> result;
+    result.reserve(process_table.size());
+    for (const auto& entry : process_table) {
+        ProcessInfo info;
+        info.pid = entry.first;
+        info.start_ticks = entry.second.start_ticks;
+        info.parent_pid = entry.second.parent_pid;
+        info.name = strings[entry.second.name];
+        info.command = strings[entry.second.command];
+        info.state = strings[entry.second.state];
+        info.cpu_usage = entry.second.cpu / 100.0;
+        info.memory_usage = static_cast<long>(entry.second.memory_kb);
+        info.uid = static_cast<int>(entry.second.uid);
+        result.push_back(info);
+    }
+    return result;
+}
+
+std::vector<NetworkConnection> SnapshotDecoder::connections() const {
+    std::vector<NetworkConnection> result;
+    result.reserve(connection_table.size());
+    for (const auto& entry : connection_table) {
+        NetworkConnection connection;
+        connection.protocol = strings[entry.second.protocol];
+        connection.local_ip = strings[entry.second.local_ip];
+        connection.local_port = entry.second.local_port;
+        connection.remote_ip = strings[entry.second.remote_ip];
+        connection.remote_port = entry.second.remote_port;
+        connection.state = strings[entry.second.state];
+        connection.pid = static_cast<int>(entry.second.pid);
+        connection.process_name = strings[entry.second.process_name];
+        result.push_back(connection);
+    }
+    return result;
+}
+
+uint64_t SnapshotDecoder::sequence() const {
+    return last_sequence;
+}
+
+uint64_t SnapshotDecoder::timestamp() const {
+    return last_timestamp;
+}
+
+bool SnapshotDecoder::isSynchronized() const {
+    return synchronized;
+}
+
+bool SnapshotDecoder::readHeader(std::istream& input) {
+    char magic[SnapshotFormat::MAGIC_SIZE];
+    input.read(magic, SnapshotFormat::MAGIC_SIZE);
+    return input.gcount() == static_cast<std::streamsize>(SnapshotFormat::MAGIC_SIZE) &&
+           std::memcmp(magic, SnapshotFormat::MAGIC, SnapshotFormat::MAGIC_SIZE) == 0;
+}
+
+bool SnapshotDecoder::readMessage(std::istream& input, std::string& message) {
+    uint64_t length = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = input.get();
+        if (byte == std::char_traits<char>::eof()) {
+            return false;
+        }
+        length |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            // Checked before allocating, so a corrupt prefix can't exhaust memory
+            if (length > SnapshotFormat::MAX_MESSAGE_SIZE) {
+                return false;
+            }
+            message.resize(static_cast<size_t>(length));
+            input.read(&message[0], static_cast<std::streamsize>(length));
+            return input.gcount() == static_cast<std::streamsize>(length);
+        }
+    }
+    return false;
+}
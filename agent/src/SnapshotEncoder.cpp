@@ -0,0 +1,318 @@
+#include "../include/SnapshotEncoder.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+using SnapshotFormat::putVarint;
+using SnapshotFormat::putSigned;
+
+SnapshotEncoder::SnapshotEncoder()
+    : dictionary_added(0), sequence(0), messages_since_keyframe(0), keyframe_requested(true),
+      stream_bytes(0), total_bytes(0) {
+}
+
+SnapshotEncoder::~SnapshotEncoder() {
+    if (stream.is_open()) {
+        stream.close();
+    }
+}
+
+void SnapshotEncoder::requestKeyframe() {
+    keyframe_requested = true;
+}
+
+uint32_t SnapshotEncoder::intern(const std::string& text) {
+    auto it = dictionary.find(text);
+    if (it != dictionary.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(dictionary.size());
+    dictionary.emplace(text, id);
+    putVarint(dictionary_additions, text.size());
+    dictionary_additions += text;
+    dictionary_added++;
+    return id;
+}
+
+void SnapshotEncoder::encode(const std::vector<ProcessInfo>& processes, const std::vector<NetworkConnection>& connections,
+                             uint64_t timestamp_ms, std::string& out) {
+    bool keyframe = keyframe_requested || messages_since_keyframe >= KEYFRAME_INTERVAL ||
+                    dictionary.size() >= MAX_DICTIONARY;
+    if (keyframe) {
+        // Ids restart so a consumer joining here needs nothing older
+        dictionary.clear();
+        keyframe_requested = false;
+        messages_since_keyframe = 0;
+    }
+    messages_since_keyframe++;
+    dictionary_additions.clear();
+    dictionary_added = 0;
+
+    section.clear();
+    encodeProcesses(processes, keyframe, section);
+    encodeConnections(connections, keyframe, section);
+
+    out.clear();
+    out += static_cast<char>(keyframe ? SnapshotFormat::KEYFRAME : SnapshotFormat::DELTA);
+    putVarint(out, ++sequence);
+    putVarint(out, timestamp_ms);
+    putVarint(out, dictionary_added);
+    out += dictionary_additions;
+    out += section;
+}
+
+void SnapshotEncoder::encodeProcesses(const std::vector<ProcessInfo>& processes, bool keyframe, std::string& out) {
+    current_records.clear();
+    current_records.reserve(processes.size());
+    for (const auto& process : processes) {
+        ProcessRecord record;
+        record.pid = process.pid;
+        record.start_ticks = process.start_ticks;
+        record.parent_pid = process.parent_pid;
+        record.name = intern(process.name);
+        record.command = intern(process.command);
+        record.state = intern(process.state);
+        record.cpu = std::max<int64_t>(std::llround(process.cpu_usage * 100.0), 0);
+        record.memory_kb = std::max<int64_t>(process.memory_usage, 0);
+        record.uid = process.uid;
+        current_records.push_back(record);
+    }
+    std::sort(current_records.begin(), current_records.end(),
+              [](const ProcessRecord& a, const ProcessRecord& b) { return a.pid < b.pid; });
+
+    if (keyframe) {
+        previous_processes.clear();
+    }
+
+    // Merge the two pid-ordered tables; a recycled pid is a removal plus an addition
+    std::vector<const ProcessRecord*> removed;
+    std::vector<const ProcessRecord*> added;
+    std::vector<std::pair<const ProcessRecord*, const ProcessRecord*>> changed;
+    size_t p = 0;
+    size_t c = 0;
+    while (p < previous_processes.size() || c < current_records.size()) {
+        if (c == current_records.size() ||
+            (p < previous_processes.size() && previous_processes[p].pid < current_records[c].pid)) {
+            removed.push_back(&previous_processes[p++]);
+        } else if (p == previous_processes.size() || current_records[c].pid < previous_processes[p].pid) {
+            added.push_back(&current_records[c++]);
+        } else {
+            if (previous_processes[p].start_ticks != current_records[c].start_ticks) {
+                removed.push_back(&previous_processes[p]);
+                added.push_back(&current_records[c]);
+            } else {
+                changed.emplace_back(&previous_processes[p], &current_records[c]);
+            }
+            p++;
+            c++;
+        }
+    }
+
+    putVarint(out, removed.size());
+    int last_pid = 0;
+    for (const ProcessRecord* record : removed) {
+        putVarint(out, static_cast<uint64_t>(record->pid - last_pid));
+        last_pid = record->pid;
+    }
+
+    putVarint(out, added.size());
+    last_pid = 0;
+    for (const ProcessRecord* record : added) {
+        putVarint(out, static_cast<uint64_t>(record->pid - last_pid));
+        last_pid = record->pid;
+        putVarint(out, record->start_ticks);
+        putVarint(out, static_cast<uint64_t>(record->parent_pid));
+        putVarint(out, record->name);
+        putVarint(out, record->command);
+        putVarint(out, record->state);
+        putVarint(out, static_cast<uint64_t>(record->cpu));
+        putVarint(out, static_cast<uint64_t>(record->memory_kb));
+        putSigned(out, record->uid);
+    }
+
+    // Unchanged records are skipped, so the count is only known afterwards
+    size_t changed_count = 0;
+    std::string entries;
+    last_pid = 0;
+    for (const auto& pair : changed) {
+        const ProcessRecord& before = *pair.first;
+        const ProcessRecord& after = *pair.second;
+        uint8_t mask = 0;
+        if (before.parent_pid != after.parent_pid) mask |= SnapshotFormat::PROCESS_PARENT;
+        if (before.name != after.name) mask |= SnapshotFormat::PROCESS_NAME;
+        if (before.command != after.command) mask |= SnapshotFormat::PROCESS_COMMAND;
+        if (before.state != after.state) mask |= SnapshotFormat::PROCESS_STATE;
+        if (before.cpu != after.cpu) mask |= SnapshotFormat::PROCESS_CPU;
+        if (before.memory_kb != after.memory_kb) mask |= SnapshotFormat::PROCESS_MEMORY;
+        if (before.uid != after.uid) mask |= SnapshotFormat::PROCESS_UID;
+        if (mask == 0) {
+            continue;
+        }
+
+        changed_count++;
+        putVarint(entries, static_cast<uint64_t>(after.pid - last_pid));
+        last_pid = after.pid;
+        entries += static_cast<char>(mask);
+        if (mask & SnapshotFormat::PROCESS_PARENT) putVarint(entries, static_cast<uint64_t>(after.parent_pid));
+        if (mask & SnapshotFormat::PROCESS_NAME) putVarint(entries, after.name);
+        if (mask & SnapshotFormat::PROCESS_COMMAND) putVarint(entries, after.command);
+        if (mask & SnapshotFormat::PROCESS_STATE) putVarint(entries, after.state);
+        if (mask & SnapshotFormat::PROCESS_CPU) putSigned(entries, after.cpu - before.cpu);
+        if (mask & SnapshotFormat::PROCESS_MEMORY) putSigned(entries, after.memory_kb - before.memory_kb);
+        if (mask & SnapshotFormat::PROCESS_UID) putSigned(entries, after.uid);
+    }
+    putVarint(out, changed_count);
+    out += entries;
+
+    previous_processes.swap(current_records);
+}
+
+void SnapshotEncoder::putConnectionKey(std::string& out, const ConnectionRecord& record) {
+    putVarint(out, record.protocol);
+    putVarint(out, record.local_ip);
+    putVarint(out, static_cast<uint64_t>(record.local_port));
+    putVarint(out, record.remote_ip);
+    putVarint(out, static_cast<uint64_t>(record.remote_port));
+}
+
+void SnapshotEncoder::encodeConnections(const std::vector<NetworkConnection>& connections, bool keyframe, std::string& out) {
+    if (keyframe) {
+        previous_connections.clear();
+    }
+    for (auto& entry : previous_connections) {
+        entry.second.seen = false;
+    }
+
+    std::string added;
+    std::string changed;
+    size_t added_count = 0;
+    size_t changed_count = 0;
+    std::string key;
+
+    for (const auto& connection : connections) {
+        key = connection.protocol;
+        key += ' ';
+        key += connection.local_ip;
+        key += ' ';
+        key += std::to_string(connection.local_port);
+        key += ' ';
+        key += connection.remote_ip;
+        key += ' ';
+        key += std::to_string(connection.remote_port);
+
+        ConnectionRecord record;
+        record.protocol = intern(connection.protocol);
+        record.local_ip = intern(connection.local_ip);
+        record.local_port = connection.local_port;
+        record.remote_ip = intern(connection.remote_ip);
+        record.remote_port = connection.remote_port;
+        record.state = intern(connection.state);
+        record.pid = connection.pid;
+        record.process_name = intern(connection.process_name);
+        record.seen = true;
+
+        auto it = previous_connections.find(key);
+        if (it == previous_connections.end()) {
+            added_count++;
+            putConnectionKey(added, record);
+            putVarint(added, record.state);
+            putSigned(added, record.pid);
+            putVarint(added, record.process_name);
+            previous_connections.emplace(key, record);
+            continue;
+        }
+        if (it->second.seen) {
+            continue; // Same socket listed twice in one cycle
+        }
+
+        uint8_t mask = 0;
+        if (it->second.state != record.state) mask |= SnapshotFormat::CONNECTION_STATE;
+        if (it->second.pid != record.pid) mask |= SnapshotFormat::CONNECTION_PID;
+        if (it->second.process_name != record.process_name) mask |= SnapshotFormat::CONNECTION_PROCESS;
+        if (mask != 0) {
+            changed_count++;
+            putConnectionKey(changed, record);
+            changed += static_cast<char>(mask);
+            if (mask & SnapshotFormat::CONNECTION_STATE) putVarint(changed, record.state);
+            if (mask & SnapshotFormat::CONNECTION_PID) putSigned(changed, record.pid);
+            if (mask & SnapshotFormat::CONNECTION_PROCESS) putVarint(changed, record.process_name);
+        }
+        it->second = record;
+    }
+
+    std::string removed;
+    size_t removed_count = 0;
+    for (auto it = previous_connections.begin(); it != previous_connections.end(); ) {
+        if (it->second.seen) {
+            ++it;
+            continue;
+        }
+        removed_count++;
+        putConnectionKey(removed, it->second);
+        it = previous_connections.erase(it);
+    }
+
+    putVarint(out, removed_count);
+    out += removed;
+    putVarint(out, added_count);
+    out += added;
+    putVarint(out, changed_count);
+    out += changed;
+}
+
+bool SnapshotEncoder::openStream() {
+    stream.open(stream_path, std::ios::binary | std::ios::trunc);
+    if (!stream.is_open()) {
+        std::cerr << "Failed to open snapshot stream: " << stream_path << std::endl;
+        return false;
+    }
+    stream.write(SnapshotFormat::MAGIC, SnapshotFormat::MAGIC_SIZE);
+    stream_bytes = SnapshotFormat::MAGIC_SIZE;
+    total_bytes += SnapshotFormat::MAGIC_SIZE;
+
+    // Every file must be decodable on its own
+    keyframe_requested = true;
+    return true;
+}
+
+bool SnapshotEncoder::open(const std::string& path) {
+    stream_path = path;
+    return openStream();
+}
+
+bool SnapshotEncoder::write(const std::vector<ProcessInfo>& processes, const std::vector<NetworkConnection>& connections) {
+    if (!stream.is_open()) {
+        return false;
+    }
+
+    if (stream_bytes >= MAX_FILE_BYTES) {
+        stream.close();
+        std::string rotated = stream_path + ".1";
+        std::remove(rotated.c_str());
+        std::rename(stream_path.c_str(), rotated.c_str());
+        if (!openStream()) {
+            return false;
+        }
+    }
+
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    uint64_t timestamp_ms = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+    std::string body;
+    encode(processes, connections, timestamp_ms, body);
+
+    std::string prefix;
+    putVarint(prefix, body.size());
+    stream.write(prefix.data(), static_cast<std::streamsize>(prefix.size()));
+    stream.write(body.data(), static_cast<std::streamsize>(body.size()));
+    stream.flush();
+
+    stream_bytes += prefix.size() + body.size();
+    total_bytes += prefix.size() + body.size();
+    return stream.good();
+}
+
+uint64_t SnapshotEncoder::bytesWritten() const {
+    return total_bytes;
+}
@@ -0,0 +1,234 @@
+#include "../include/SocketStatsCollector.h"
+#include "../include/PlatformUtils.h"
+#include <algorithm>
+#include <cstring>
+
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_MACOS)
+    #include <sys/socket.h>
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+    #include <linux/netlink.h>
+    #include <linux/rtnetlink.h>
+    #include <linux/sock_diag.h>
+    #include <linux/inet_diag.h>
+    #include <linux/tcp.h>
+#endif
+
+SocketStatsCollector::SocketStatsCollector() : netlink_fd(-1), has_previous(false) {
+    receive_buffer.resize(64 * 1024);
+}
+
+SocketStatsCollector::~SocketStatsCollector() {
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_MACOS)
+    if (netlink_fd >= 0) {
+        close(netlink_fd);
+    }
+#endif
+}
+
+void SocketStatsCollector::insertCounters(std::vector<CounterEntry>& table, const CounterEntry& entry) {
+    size_t mask = table.size() - 1;
+    size_t index = ((entry.cookie * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+    while (table[index].cookie != 0 && table[index].cookie != entry.cookie) {
+        index = (index + 1) & mask;
+    }
+    table[index] = entry;
+}
+
+const SocketStatsCollector::CounterEntry* SocketStatsCollector::findCounters(const std::vector<CounterEntry>& table, uint64_t cookie) {
+    if (table.empty()) {
+        return nullptr;
+    }
+    size_t mask = table.size() - 1;
+    size_t index = ((cookie * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+    while (table[index].cookie != 0) {
+        if (table[index].cookie == cookie) {
+            return &table[index];
+        }
+        index = (index + 1) & mask;
+    }
+    return nullptr;
+}
+
+std::vector<SocketStats> SocketStatsCollector::topTalkers(const std::vector<SocketStats>& sockets, size_t count) {
+    std::vector<SocketStats> top(sockets);
+    count = std::min(count, top.size());
+    std::partial_sort(top.begin(), top.begin() + count, top.end(),
+                      [](const SocketStats& a, const SocketStats& b) {
+                          return a.send_rate + a.receive_rate > b.send_rate + b.receive_rate;
+                      });
+    top.resize(count);
+    return top;
+}
+
+#if defined(PLATFORM_WINDOWS) || defined(PLATFORM_MACOS)
+
+bool SocketStatsCollector::openSocket() {
+    return false;
+}
+
+bool SocketStatsCollector::dumpFamily(int family, std::vector<SocketStats>& sockets) {
+    (void)family;
+    (void)sockets;
+    return false;
+}
+
+std::vector<SocketStats> SocketStatsCollector::collect() {
+    // sock_diag is Linux-specific; no per-socket TCP metrics elsewhere
+    return std::vector<SocketStats>();
+}
+
+#else
+
+static const char* tcpStateName(int state) {
+    switch (state) {
+        case 1: return "ESTABLISHED";
+        case 2: return "SYN_SENT";
+        case 3: return "SYN_RECV";
+        case 4: return "FIN_WAIT1";
+        case 5: return "FIN_WAIT2";
+        case 6: return "TIME_WAIT";
+        case 7: return "CLOSE";
+        case 8: return "CLOSE_WAIT";
+        case 9: return "LAST_ACK";
+        case 10: return "LISTEN";
+        case 11: return "CLOSING";
+        default: return "UNKNOWN";
+    }
+}
+
+static std::string addressToString(int family, const __be32* address) {
+    char buffer[INET6_ADDRSTRLEN];
+    if (inet_ntop(family, address, buffer, sizeof(buffer)) == nullptr) {
+        return "";
+    }
+    return std::string(buffer);
+}
+
+bool SocketStatsCollector::openSocket() {
+    if (netlink_fd >= 0) {
+        return true;
+    }
+    netlink_fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+    return netlink_fd >= 0;
+}
+
+bool SocketStatsCollector::dumpFamily(int family, std::vector<SocketStats>& sockets) {
+    struct {
+        nlmsghdr header;
+        inet_diag_req_v2 request;
+    } message;
+    std::memset(&message, 0, sizeof(message));
+
+    message.header.nlmsg_len = sizeof(message);
+    message.header.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+    message.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    message.request.sdiag_family = family;
+    message.request.sdiag_protocol = IPPROTO_TCP;
+    message.request.idiag_states = ~(1U << 10); // Everything except LISTEN
+    message.request.idiag_ext = 1 << (INET_DIAG_INFO - 1);
+
+    if (send(netlink_fd, &message, sizeof(message), 0) < 0) {
+        return false;
+    }
+
+    while (true) {
+        ssize_t length = recv(netlink_fd, receive_buffer.data(), receive_buffer.size(), 0);
+        if (length <= 0) {
+            return false;
+        }
+
+        nlmsghdr* header = reinterpret_cast<nlmsghdr*>(receive_buffer.data());
+        for (; NLMSG_OK(header, static_cast<unsigned int>(length)); header = NLMSG_NEXT(header, length)) {
+            if (header->nlmsg_type == NLMSG_DONE) {
+                return true;
+            }
+            if (header->nlmsg_type == NLMSG_ERROR) {
+                return false;
+            }
+
+            const inet_diag_msg* diag = static_cast<const inet_diag_msg*>(NLMSG_DATA(header));
+            SocketStats stats;
+            stats.cookie = diag->id.idiag_cookie[0] | (static_cast<uint64_t>(diag->id.idiag_cookie[1]) << 32);
+            stats.local_ip = addressToString(family, diag->id.idiag_src);
+            stats.local_port = ntohs(diag->id.idiag_sport);
+            stats.remote_ip = addressToString(family, diag->id.idiag_dst);
+            stats.remote_port = ntohs(diag->id.idiag_dport);
+            stats.state = tcpStateName(diag->idiag_state);
+            stats.inode = diag->idiag_inode;
+            stats.uid = diag->idiag_uid;
+            stats.bytes_acked = 0;
+            stats.bytes_received = 0;
+            stats.send_rate = 0.0;
+            stats.receive_rate = 0.0;
+            stats.rtt_us = 0;
+            stats.rtt_var_us = 0;
+            stats.snd_cwnd = 0;
+            stats.total_retrans = 0;
+            stats.retrans_delta = 0;
+
+            // Older kernels send a shorter tcp_info; missing fields stay zero
+            int attribute_length = header->nlmsg_len - NLMSG_LENGTH(sizeof(*diag));
+            for (rtattr* attribute = reinterpret_cast<rtattr*>(const_cast<inet_diag_msg*>(diag) + 1);
+                 RTA_OK(attribute, attribute_length);
+                 attribute = RTA_NEXT(attribute, attribute_length)) {
+                if (attribute->rta_type != INET_DIAG_INFO) {
+                    continue;
+                }
+                tcp_info info;
+                std::memset(&info, 0, sizeof(info));
+                std::memcpy(&info, RTA_DATA(attribute), std::min<size_t>(RTA_PAYLOAD(attribute), sizeof(info)));
+                stats.bytes_acked = info.tcpi_bytes_acked;
+                stats.bytes_received = info.tcpi_bytes_received;
+                stats.rtt_us = info.tcpi_rtt;
+                stats.rtt_var_us = info.tcpi_rttvar;
+                stats.snd_cwnd = info.tcpi_snd_cwnd;
+                stats.total_retrans = info.tcpi_total_retrans;
+            }
+
+            sockets.push_back(std::move(stats));
+        }
+    }
+}
+
+std::vector<SocketStats> SocketStatsCollector::collect() {
+    std::vector<SocketStats> sockets;
+    if (!openSocket()) {
+        return sockets;
+    }
+
+    if (!dumpFamily(AF_INET, sockets) || !dumpFamily(AF_INET6, sockets)) {
+        // Drop a socket left mid-dump; it is reopened next cycle
+        close(netlink_fd);
+        netlink_fd = -1;
+        return sockets;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    double interval = std::chrono::duration<double>(now - last_collection).count();
+
+    // Keep the table at most half full
+    size_t capacity = 16;
+    while (capacity < sockets.size() * 2) {
+        capacity <<= 1;
+    }
+    current_counters.assign(capacity, CounterEntry{0, 0, 0, 0});
+
+    for (auto& stats : sockets) {
+        const CounterEntry* previous = has_previous ? findCounters(previous_counters, stats.cookie) : nullptr;
+        if (previous != nullptr && interval > 0.0) {
+            stats.send_rate = (stats.bytes_acked - previous->bytes_acked) / interval;
+            stats.receive_rate = (stats.bytes_received - previous->bytes_received) / interval;
+            stats.retrans_delta = stats.total_retrans - previous->total_retrans;
+        }
+        insertCounters(current_counters, CounterEntry{stats.cookie, stats.bytes_acked,
+                                                      stats.bytes_received, stats.total_retrans});
+    }
+
+    previous_counters.swap(current_counters);
+    last_collection = now;
+    has_previous = true;
+    return sockets;
+}
+
+#endif
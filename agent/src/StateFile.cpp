@@ -0,0 +1,266 @@
+#include "../include/StateFile.h"
+#include "../include/SnapshotFormat.h"
+#include "../include/PlatformUtils.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <ctime>
+
+#ifndef PLATFORM_WINDOWS
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+// Bumped when a stored field's meaning changes; older files are then ignored
+const char StateFile::MAGIC[] = "STSTATE3";
+
+void StateWriter::putVarint(uint64_t value) {
+    SnapshotFormat::putVarint(buffer, value);
+}
+
+void StateWriter::putSigned(int64_t value) {
+    SnapshotFormat::putSigned(buffer, value);
+}
+
+void StateWriter::putDouble(double value) {
+    char bytes[sizeof(double)];
+    std::memcpy(bytes, &value, sizeof(bytes));
+    buffer.append(bytes, sizeof(bytes));
+}
+
+void StateWriter::putString(const std::string& value) {
+    putVarint(value.size());
+    buffer += value;
+}
+
+const std::string& StateWriter::data() const {
+    return buffer;
+}
+
+StateReader::StateReader() : position(nullptr), end(nullptr), valid(false) {
+}
+
+StateReader::StateReader(const char* data, size_t size) : position(data), end(data + size), valid(true) {
+}
+
+uint64_t StateReader::getVarint() {
+    uint64_t value = 0;
+    if (!valid || !SnapshotFormat::getVarint(position, end, value)) {
+        valid = false;
+        return 0;
+    }
+    return value;
+}
+
+int64_t StateReader::getSigned() {
+    int64_t value = 0;
+    if (!valid || !SnapshotFormat::getSigned(position, end, value)) {
+        valid = false;
+        return 0;
+    }
+    return value;
+}
+
+double StateReader::getDouble() {
+    double value = 0.0;
+    if (!valid || static_cast<size_t>(end - position) < sizeof(double)) {
+        valid = false;
+        return 0.0;
+    }
+    std::memcpy(&value, position, sizeof(double));
+    position += sizeof(double);
+    return value;
+}
+
+std::string StateReader::getString() {
+    uint64_t size = getVarint();
+    if (!valid || size > static_cast<uint64_t>(end - position)) {
+        valid = false;
+        return "";
+    }
+    std::string value(position, static_cast<size_t>(size));
+    position += size;
+    return value;
+}
+
+bool StateReader::ok() const {
+    return valid;
+}
+
+bool StateReader::atEnd() const {
+    return position == end;
+}
+
+StateFile::StateFile() : mapped(nullptr), mapped_size(0), saved_at(0) {
+}
+
+StateFile::~StateFile() {
+    close();
+}
+
+uint64_t StateFile::checksum(const char* data, size_t size) {
+    return PlatformUtils::fnv1a(data, size);
+}
+
+bool StateFile::open(const std::string& path) {
+    close();
+
+#ifdef PLATFORM_WINDOWS
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    contents = buffer.str();
+    const char* data = contents.data();
+    size_t size = contents.size();
+#else
+    // Parsed in place; nothing is copied until a component takes its values
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    void* mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    mapped = static_cast<const char*>(mapping);
+    mapped_size = static_cast<size_t>(info.st_size);
+    const char* data = mapped;
+    size_t size = mapped_size;
+#endif
+
+    uint64_t stored_checksum = 0;
+    if (size < MAGIC_SIZE + sizeof(stored_checksum) || std::memcmp(data, MAGIC, MAGIC_SIZE) != 0) {
+        std::cerr << "Ignoring state file " << path << ": not a state file" << std::endl;
+        close();
+        return false;
+    }
+    size -= sizeof(stored_checksum);
+    std::memcpy(&stored_checksum, data + size, sizeof(stored_checksum));
+    if (stored_checksum != checksum(data, size)) {
+        std::cerr << "Ignoring state file " << path << ": checksum mismatch" << std::endl;
+        close();
+        return false;
+    }
+
+    const char* position = data + MAGIC_SIZE;
+    const char* end = data + size;
+    SnapshotFormat::getSigned(position, end, saved_at);
+
+    while (position < end) {
+        uint64_t tag = 0;
+        uint64_t length = 0;
+        if (!SnapshotFormat::getVarint(position, end, tag) || !SnapshotFormat::getVarint(position, end, length) ||
+            length > static_cast<uint64_t>(end - position)) {
+            std::cerr << "Ignoring state file " << path << ": truncated section" << std::endl;
+            close();
+            return false;
+        }
+        sections.push_back({static_cast<uint32_t>(tag), position, static_cast<size_t>(length)});
+        position += length;
+    }
+    return true;
+}
+
+void StateFile::close() {
+#ifndef PLATFORM_WINDOWS
+    if (mapped != nullptr) {
+        munmap(const_cast<char*>(mapped), mapped_size);
+    }
+#endif
+    mapped = nullptr;
+    mapped_size = 0;
+    contents.clear();
+    sections.clear();
+}
+
+bool StateFile::section(uint32_t tag, StateReader& reader) const {
+    for (const auto& section : sections) {
+        if (section.tag == tag) {
+            reader = StateReader(section.data, section.size);
+            return true;
+        }
+    }
+    return false;
+}
+
+int64_t StateFile::savedAt() const {
+    return saved_at;
+}
+
+bool StateFile::save(const std::string& path, const std::vector<std::pair<uint32_t, std::string>>& sections) {
+    std::string data(MAGIC, MAGIC_SIZE);
+    SnapshotFormat::putSigned(data, static_cast<int64_t>(time(nullptr)));
+    for (const auto& section : sections) {
+        SnapshotFormat::putVarint(data, section.first);
+        SnapshotFormat::putVarint(data, section.second.size());
+        data += section.second;
+    }
+    uint64_t sum = checksum(data.data(), data.size());
+    data.append(reinterpret_cast<const char*>(&sum), sizeof(sum));
+
+    // A crash mid-write leaves the previous checkpoint intact
+    std::string temporary = path + ".tmp";
+#ifdef PLATFORM_WINDOWS
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.is_open() || !file.write(data.data(), data.size())) {
+            std::cerr << "Failed to write state file: " << temporary << std::endl;
+            return false;
+        }
+    }
+    std::remove(path.c_str());
+#else
+    // On disk before the rename, or a crash could leave the new name
+    // pointing at an empty file
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    bool written = fd >= 0;
+    size_t offset = 0;
+    while (written && offset < data.size()) {
+        ssize_t count = write(fd, data.data() + offset, data.size() - offset);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        written = count > 0;
+        if (written) {
+            offset += static_cast<size_t>(count);
+        }
+    }
+    written = written && fsync(fd) == 0;
+    if (fd >= 0 && ::close(fd) != 0) {
+        written = false;
+    }
+    if (!written) {
+        std::cerr << "Failed to write state file: " << temporary << std::endl;
+        return false;
+    }
+#endif
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::cerr << "Failed to replace state file: " << path << std::endl;
+        return false;
+    }
+#ifndef PLATFORM_WINDOWS
+    // The rename is durable once the directory entry is
+    size_t slash = path.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : path.substr(0, slash > 0 ? slash : 1);
+    int dir_fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir_fd >= 0) {
+        fsync(dir_fd);
+        ::close(dir_fd);
+    }
+#endif
+    return true;
+}
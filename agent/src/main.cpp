@@ -4,6 +4,20 @@
 #include <signal.h>
 #include "../include/ProcessMonitor.h"
 #include "../include/NetworkMonitor.h"
+#include "../include/SocketStatsCollector.h"
+#include "../include/InterfaceMonitor.h"
+#include "../include/DiskMonitor.h"
+#include "../include/CgroupMonitor.h"
+#include "../include/ProcessTree.h"
+#include "../include/MetricsServer.h"
+#include "../include/EventSink.h"
+#include "../include/EventSinks.h"
+#include "../include/EventRouter.h"
+#include "../include/ProcessWatcher.h"
+#include "../include/AgentConfig.h"
+#include "../include/ResourceGovernor.h"
+#include "../include/StateFile.h"
+#include "../include/SnapshotEncoder.h"
 #include "../include/EventLogger.h"
 #include "../include/AnomalyDetector.h"
 #include "../include/PlatformUtils.h"
@@ -16,6 +30,16 @@
     #include <sys/stat.h>
 #endif
 
+const char* const METRICS_ADDRESS = "127.0.0.1";
+const int METRICS_PORT = 9464;
+const char* const METRICS_SOCKET = "../data/metrics.sock";
+const char* const EVENTS_SOCKET = "../data/events.sock";
+const char* const JSON_LOG = "../data/sentineltrack.log";
+const char* const SNAPSHOT_STREAM = "../data/snapshots.bin";
+const char* const CONFIG_FILE = "sentineltrack.conf";
+const char* const STATE_FILE = "../data/agent.state";
+const int STATE_CHECKPOINT_CYCLES = 60;
+
 // Global flag for graceful shutdown
 volatile sig_atomic_t running = 1;
 
@@ -35,6 +59,198 @@ void createDataDirectory() {
     PlatformUtils::createDirectory("../data");
 }
 
+// Push the configuration, as limited by the governor's current level, into
+// the long-lived components; baselines, sketches and open alerts are left as they are
+void applyConfiguration(const AgentConfig& config, ResourceGovernor& governor, AnomalyDetector& detector,
+                        ProcessMonitor& processes, ProcessWatcher& watcher, EventRouter& router) {
+    governor.setBudget(config.cpu_budget_percent, config.memory_budget_mb);
+    detector.updateConfiguration(config.thresholds);
+    detector.setKnownProcesses(config.known_processes);
+    detector.setSuspiciousPorts(config.suspicious_ports);
+    processes.setDetailsEnabled(governor.detailsEnabled());
+    processes.setSampleStride(governor.sampleStride());
+    processes.setIoUringReads(config.process_io_uring);
+    processes.setThreadMonitoring(config.thread_top_processes, config.thread_budget);
+    watcher.setWatchList(config.watch_processes);
+    for (const auto& route : config.routes) {
+        if (route.sink == "console" && !governor.consoleEnabled()) {
+            router.setRoute(route.sink, 0, 0);
+        } else {
+            router.setRoute(route.sink, route.types, route.stats_interval);
+        }
+    }
+}
+
+// Checkpoint what the agent has learned so a restart can pick up from here
+void saveAgentState(const ProcessMonitor& processes, const NetworkMonitor& connections, const AnomalyDetector& detector) {
+    StateWriter process_state;
+    StateWriter connection_state;
+    StateWriter detector_state;
+    processes.saveState(process_state);
+    connections.saveState(connection_state);
+    detector.saveState(detector_state);
+    
+    StateFile::save(STATE_FILE, {
+        {StateFile::PROCESS_MONITOR, process_state.data()},
+        {StateFile::NETWORK_MONITOR, connection_state.data()},
+        {StateFile::ANOMALY_DETECTOR, detector_state.data()}
+    });
+}
+
+// Each component takes its own section or keeps its cold-start state
+void restoreAgentState(ProcessMonitor& processes, NetworkMonitor& connections, AnomalyDetector& detector) {
+    StateFile state;
+    if (!state.open(STATE_FILE)) {
+        return;
+    }
+    
+    StateReader reader;
+    bool processes_restored = state.section(StateFile::PROCESS_MONITOR, reader) && processes.loadState(reader);
+    bool connections_restored = state.section(StateFile::NETWORK_MONITOR, reader) && connections.loadState(reader);
+    bool detector_restored = state.section(StateFile::ANOMALY_DETECTOR, reader) && detector.loadState(reader);
+    
+    std::cout << "Resumed from state saved " << (time(nullptr) - state.savedAt()) << "s ago (processes: " 
+              << (processes_restored ? "yes" : "no") << ", connections: " << (connections_restored ? "yes" : "no") 
+              << ", detector: " << (detector_restored ? "yes" : "no") << ")" << std::endl;
+}
+
+// Render this cycle's numbers once; scrapes are served from the result
+std::string renderMetrics(const SystemStats& system, size_t process_count, size_t connection_count,
+                          const std::vector<InterfaceStats>& interfaces, const std::vector<DiskDeviceStats>& disks,
+                          const std::vector<MountUsage>& mounts, const std::vector<CgroupStats>& cgroups,
+                          const ProcessTree& tree, const MetricsSink& events, 
+                          const std::vector<SinkStatus>& sinks, const ResourceGovernor& governor,
+                          long suppressed_alerts, uint64_t scrapes) {
+    MetricsWriter writer;
+    
+    writer.metric("sentineltrack_cpu_usage_percent", "gauge", "System CPU usage");
+    writer.sample(system.cpu_usage);
+    writer.metric("sentineltrack_memory_usage_percent", "gauge", "System memory usage");
+    writer.sample(system.memory_usage);
+    writer.metric("sentineltrack_load_average", "gauge", "One-minute load average");
+    writer.sample(system.load_average);
+    writer.metric("sentineltrack_processes", "gauge", "Running processes");
+    writer.sample(static_cast<double>(process_count));
+    writer.metric("sentineltrack_connections", "gauge", "Open network connections");
+    writer.sample(static_cast<double>(connection_count));
+    
+    writer.metric("sentineltrack_interface_receive_bytes_total", "counter", "Bytes received per interface");
+    for (const auto& iface : interfaces) {
+        writer.sample(static_cast<double>(iface.rx_bytes), MetricsWriter::label("", "interface", iface.name));
+    }
+    writer.metric("sentineltrack_interface_transmit_bytes_total", "counter", "Bytes sent per interface");
+    for (const auto& iface : interfaces) {
+        writer.sample(static_cast<double>(iface.tx_bytes), MetricsWriter::label("", "interface", iface.name));
+    }
+    writer.metric("sentineltrack_interface_drops_total", "counter", "Dropped packets per interface, both directions");
+    for (const auto& iface : interfaces) {
+        writer.sample(static_cast<double>(iface.rx_drops + iface.tx_drops), MetricsWriter::label("", "interface", iface.name));
+    }
+    
+    writer.metric("sentineltrack_disk_read_bytes_per_second", "gauge", "Block device read throughput");
+    for (const auto& disk : disks) {
+        writer.sample(disk.read_bytes_rate, MetricsWriter::label("", "device", disk.name));
+    }
+    writer.metric("sentineltrack_disk_write_bytes_per_second", "gauge", "Block device write throughput");
+    for (const auto& disk : disks) {
+        writer.sample(disk.write_bytes_rate, MetricsWriter::label("", "device", disk.name));
+    }
+    writer.metric("sentineltrack_disk_utilization_percent", "gauge", "Share of the interval the device was busy");
+    for (const auto& disk : disks) {
+        writer.sample(disk.utilization, MetricsWriter::label("", "device", disk.name));
+    }
+    
+    writer.metric("sentineltrack_filesystem_size_bytes", "gauge", "Filesystem size");
+    for (const auto& mount : mounts) {
+        writer.sample(static_cast<double>(mount.total_bytes), MetricsWriter::label("", "mountpoint", mount.mount_point));
+    }
+    writer.metric("sentineltrack_filesystem_used_bytes", "gauge", "Filesystem space in use");
+    for (const auto& mount : mounts) {
+        writer.sample(static_cast<double>(mount.used_bytes), MetricsWriter::label("", "mountpoint", mount.mount_point));
+    }
+    writer.metric("sentineltrack_filesystem_inode_usage_percent", "gauge", "Filesystem inodes in use");
+    for (const auto& mount : mounts) {
+        writer.sample(mount.inode_usage_percent, MetricsWriter::label("", "mountpoint", mount.mount_point));
+    }
+    
+    // Only populated groups, to keep the series count bounded
+    std::vector<std::string> cgroup_labels;
+    for (const auto& group : cgroups) {
+        if (group.process_count > 0 || group.pids_current > 0) {
+            cgroup_labels.push_back(MetricsWriter::label(MetricsWriter::label("", "cgroup", group.path), 
+                                                         "container", group.container_id));
+        } else {
+            cgroup_labels.push_back("");
+        }
+    }
+    writer.metric("sentineltrack_cgroup_cpu_usage_percent", "gauge", "cgroup CPU usage, % of one CPU");
+    for (size_t i = 0; i < cgroups.size(); i++) {
+        if (!cgroup_labels[i].empty()) {
+            writer.sample(cgroups[i].cpu_usage, cgroup_labels[i]);
+        }
+    }
+    writer.metric("sentineltrack_cgroup_memory_bytes", "gauge", "cgroup memory.current");
+    for (size_t i = 0; i < cgroups.size(); i++) {
+        if (!cgroup_labels[i].empty()) {
+            writer.sample(static_cast<double>(cgroups[i].memory_current), cgroup_labels[i]);
+        }
+    }
+    writer.metric("sentineltrack_cgroup_throttled_percent", "gauge", "Share of the interval throttled by cpu.max");
+    for (size_t i = 0; i < cgroups.size(); i++) {
+        if (!cgroup_labels[i].empty()) {
+            writer.sample(cgroups[i].throttled_percent, cgroup_labels[i]);
+        }
+    }
+    
+    // Per-service totals: each child of init with everything below it
+    auto services = tree.largestSubtrees(1, 10);
+    writer.metric("sentineltrack_service_cpu_usage_percent", "gauge", "CPU usage of a process subtree under init");
+    for (const auto& service : services) {
+        writer.sample(service.cpu_usage, MetricsWriter::label(MetricsWriter::label("", "service", service.name), 
+                                                              "pid", std::to_string(service.pid)));
+    }
+    writer.metric("sentineltrack_service_memory_bytes", "gauge", "Memory of a process subtree under init");
+    for (const auto& service : services) {
+        writer.sample(static_cast<double>(service.memory_usage) * 1024.0, 
+                      MetricsWriter::label(MetricsWriter::label("", "service", service.name), 
+                                           "pid", std::to_string(service.pid)));
+    }
+    
+    events.render(writer);
+    writer.metric("sentineltrack_sink_delivered_events_total", "counter", "Events handed to each sink");
+    for (const auto& sink : sinks) {
+        writer.sample(static_cast<double>(sink.delivered), MetricsWriter::label("", "sink", sink.name));
+    }
+    writer.metric("sentineltrack_sink_dropped_events_total", "counter", "Events a sink lost because its queue was full");
+    for (const auto& sink : sinks) {
+        writer.sample(static_cast<double>(sink.dropped), MetricsWriter::label("", "sink", sink.name));
+    }
+    writer.metric("sentineltrack_sink_queued_events", "gauge", "Events waiting for each sink");
+    for (const auto& sink : sinks) {
+        writer.sample(static_cast<double>(sink.queued), MetricsWriter::label("", "sink", sink.name));
+    }
+    
+    writer.metric("sentineltrack_agent_cpu_percent", "gauge", "CPU used by the agent itself, % of one core");
+    writer.sample(governor.cpuPercent());
+    writer.metric("sentineltrack_agent_resident_bytes", "gauge", "Resident memory of the agent itself");
+    writer.sample(static_cast<double>(governor.rssKb()) * 1024.0);
+    writer.metric("sentineltrack_governor_level", "gauge", "Degradation level applied to stay within budget");
+    writer.sample(governor.level());
+    writer.metric("sentineltrack_governor_degradations_total", "counter", "Times each degradation level was entered");
+    for (int level = 1; level <= 4; level++) {
+        writer.sample(static_cast<double>(governor.degradationCount(level)),
+                      MetricsWriter::label("", "level", ResourceGovernor::levelName(level)));
+    }
+    
+    writer.metric("sentineltrack_alerts_suppressed_total", "counter", "Alert observations held back by rate limits");
+    writer.sample(static_cast<double>(suppressed_alerts));
+    
+    writer.metric("sentineltrack_metrics_scrapes_total", "counter", "Scrapes served by this endpoint");
+    writer.sample(static_cast<double>(scrapes));
+    
+    return writer.take();
+}
+
 int main(int argc, char* argv[]) {
     printBanner();
     
@@ -52,13 +268,34 @@ int main(int argc, char* argv[]) {
     signal(SIGTERM, signalHandler);
 #endif
     
+    // Before any thread exists, so only the config watcher sees SIGHUP
+    ConfigManager::blockReloadSignal();
+    ConfigManager configManager(argc > 1 ? argv[1] : CONFIG_FILE);
+    if (!configManager.load()) {
+        std::cerr << "Starting with the default configuration." << std::endl;
+    }
+    ResourceGovernor::pinToCpus(configManager.current().cpu_affinity);
+    ResourceGovernor::setNiceLevel(configManager.current().nice_level);
+    if (configManager.start()) {
+        std::cout << "Send SIGHUP to reload the configuration." << std::endl;
+    }
+    
     // Create data directory if it doesn't exist
     createDataDirectory();
     
     // Initialize components
     ProcessMonitor processMonitor;
+    ProcessTree processTree;
     NetworkMonitor networkMonitor;
-    EventLogger logger("../data/sentineltrack.db", "../data/sentineltrack.log");
+    SocketStatsCollector socketCollector;
+    InterfaceMonitor interfaceMonitor;
+    std::vector<InterfaceStats> interface_stats;
+    DiskMonitor diskMonitor;
+    std::vector<DiskDeviceStats> disk_devices;
+    std::vector<MountUsage> mount_usage;
+    CgroupMonitor cgroupMonitor;
+    std::vector<CgroupStats> cgroup_stats;
+    EventLogger logger("../data/sentineltrack.db", ""); // JSON lines are written by JsonLinesSink
     AnomalyDetector anomalyDetector;
     
     if (!logger.isInitialized()) {
@@ -66,98 +303,210 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
+    // Local-only scrape endpoint; the agent keeps running without it
+    MetricsServer metricsServer;
+    bool metrics_tcp = metricsServer.listenTcp(METRICS_ADDRESS, METRICS_PORT);
+    bool metrics_unix = metricsServer.listenUnix(METRICS_SOCKET);
+    if ((metrics_tcp || metrics_unix) && metricsServer.start()) {
+        std::cout << "Serving metrics on http://" << METRICS_ADDRESS << ":" << METRICS_PORT << "/metrics" << std::endl;
+    }
+    
+    // Every event goes through the router; each sink drains its own queue.
+    // Routes are set from the configuration just below.
+    EventRouter eventRouter;
+    auto metrics_sink = std::make_unique<MetricsSink>();
+    const MetricsSink& eventCounters = *metrics_sink;
+    eventRouter.addSink(std::make_unique<DatabaseSink>(logger), 0, 0);
+    eventRouter.addSink(std::make_unique<JsonLinesSink>(JSON_LOG), 0, 0);
+    eventRouter.addSink(std::make_unique<ConsoleSink>(), 0, 0);
+    eventRouter.addSink(std::make_unique<SocketSink>(EVENTS_SOCKET), 0, 0);
+    eventRouter.addSink(std::move(metrics_sink), 0, 0);
+    
+    // Measures the agent's own cost and sheds work when over budget
+    ResourceGovernor governor;
+    
+    // Exits of the configured critical processes skip the cycle and go
+    // straight to the sinks
+    ProcessWatcher processWatcher(eventRouter);
+    
+    uint64_t applied_version = configManager.current().version;
+    applyConfiguration(configManager.current(), governor, anomalyDetector, processMonitor, processWatcher, eventRouter);
+    processWatcher.start();
+    
+    // Keyframe + delta export of the process and connection tables
+    SnapshotEncoder snapshotEncoder;
+    snapshotEncoder.open(SNAPSHOT_STREAM);
+    
+    // Warm restart: counters, baselines and alert state from the last checkpoint
+    restoreAgentState(processMonitor, networkMonitor, anomalyDetector);
+    
     std::cout << "SentinelTrack agent started. Monitoring system..." << std::endl;
     std::cout << "Press Ctrl+C to stop monitoring." << std::endl;
     
     int cycle_count = 0;
-    auto last_stats_time = std::chrono::steady_clock::now();
     
     while (running) {
         try {
             auto start_time = std::chrono::steady_clock::now();
             
-            // Monitor processes
-            processMonitor.updateProcessList();
-            auto current_processes = processMonitor.getCurrentProcesses();
+            // Configurations swapped out during the previous cycle are no longer referenced
+            configManager.reclaim();
+            const AgentConfig& config = configManager.current();
+            if (config.version != applied_version) {
+                applyConfiguration(config, governor, anomalyDetector, processMonitor, processWatcher, eventRouter);
+                applied_version = config.version;
+            }
+            
+            // Monitor processes; deltas are taken against the previous cycle's list
+            const auto& current_processes = processMonitor.getCurrentProcesses();
             auto new_processes = processMonitor.getNewProcesses();
             auto terminated_processes = processMonitor.getTerminatedProcesses();
+            processMonitor.updateProcessList();
+            processTree.update(current_processes, new_processes, terminated_processes);
+            processWatcher.update(current_processes);
             
-            // Log new processes
             for (const auto& process : new_processes) {
-                logger.logProcess(process);
-                std::cout << "[PROCESS] New: " << process.name << " (PID: " << process.pid << ")" << std::endl;
+                AgentEvent event{EventType::PROCESS_STARTED};
+                event.process = process;
+                eventRouter.publish(std::move(event));
             }
             
-            // Log terminated processes
             for (int pid : terminated_processes) {
-                std::cout << "[PROCESS] Terminated: PID " << pid << std::endl;
+                AgentEvent event{EventType::PROCESS_TERMINATED};
+                event.pid = pid;
+                eventRouter.publish(std::move(event));
             }
             
             // Monitor network connections
-            networkMonitor.updateConnectionList();
-            auto current_connections = networkMonitor.getCurrentConnections();
+            const auto& current_connections = networkMonitor.getCurrentConnections();
             auto new_connections = networkMonitor.getNewConnections();
+            networkMonitor.updateConnectionList();
+            
+            // Per-socket TCP throughput, RTT and retransmits
+            auto socket_stats = socketCollector.collect();
+            
+            // Host-level interface throughput, errors and drops
+            interfaceMonitor.collect(interface_stats);
+            
+            // Block device I/O and filesystem space
+            diskMonitor.collectDevices(disk_devices);
+            diskMonitor.collectMounts(mount_usage);
+            
+            // Per-container usage straight from the cgroup v2 hierarchy
+            cgroupMonitor.collect(cgroup_stats);
+            CgroupMonitor::attributeProcesses(current_processes, cgroup_stats);
             
-            // Log new network connections
             for (const auto& connection : new_connections) {
-                logger.logNetworkConnection(connection);
-                std::cout << "[NETWORK] New connection: " << connection.local_ip << ":" 
-                         << connection.local_port << " -> " << connection.remote_ip << ":" 
-                         << connection.remote_port << " (" << connection.protocol << ")" << std::endl;
+                AgentEvent event{EventType::NETWORK_CONNECTION};
+                event.connection = connection;
+                eventRouter.publish(std::move(event));
             }
             
             // Check for anomalies
-            auto process_anomalies = anomalyDetector.checkProcessAnomalies(current_processes);
-            auto network_anomalies = anomalyDetector.checkNetworkAnomalies(current_connections);
+            anomalyDetector.checkProcessAnomalies(current_processes);
+            anomalyDetector.checkNetworkAnomalies(current_connections);
+            anomalyDetector.checkProcessCreationRate(new_processes);
+            anomalyDetector.checkProcessLineage(new_processes, processTree);
+            anomalyDetector.checkConnectionRate(new_connections);
+            anomalyDetector.checkSocketAnomalies(socket_stats);
+            anomalyDetector.checkInterfaceAnomalies(interface_stats);
+            anomalyDetector.checkDiskAnomalies(disk_devices, mount_usage);
+            anomalyDetector.checkCgroupAnomalies(cgroup_stats);
+            anomalyDetector.checkThreadAnomalies(processMonitor.getThreads());
             
             // Get system stats and check for system anomalies
             auto system_stats = logger.getSystemStats();
-            auto system_anomalies = anomalyDetector.checkSystemAnomalies(
+            anomalyDetector.checkSystemAnomalies(
                 system_stats.cpu_usage, 
                 static_cast<long>(system_stats.memory_usage * 1024 * 1024) // Convert to KB
             );
             
-            // Log all anomalies
-            for (const auto& anomaly : process_anomalies) {
-                logger.logAlert(anomaly.type, anomaly.severity, anomaly.message, anomaly.details);
-                std::cout << "[ALERT] " << anomaly.severity << ": " << anomaly.message << std::endl;
+            if (governor.update()) {
+                applyConfiguration(config, governor, anomalyDetector, processMonitor, processWatcher, eventRouter);
+                AgentEvent event{EventType::ANOMALY_DETECTED};
+                event.alert = governor.transitionAlert();
+                eventRouter.publish(std::move(event));
             }
             
-            for (const auto& anomaly : network_anomalies) {
-                logger.logAlert(anomaly.type, anomaly.severity, anomaly.message, anomaly.details);
-                std::cout << "[ALERT] " << anomaly.severity << ": " << anomaly.message << std::endl;
+            // Only alert state transitions, not every repeated observation
+            auto alert_transitions = anomalyDetector.collectAlertTransitions();
+            for (const auto& anomaly : alert_transitions) {
+                // Collect its details while the alert is open
+                if (anomaly.pid > 0 && anomaly.severity != "INFO" && anomaly.state == "OPEN") {
+                    processMonitor.flagProcess(anomaly.pid);
+                } else if (anomaly.pid > 0 && anomaly.severity != "INFO" && anomaly.state == "RESOLVED") {
+                    processMonitor.unflagProcess(anomaly.pid);
+                }
+                AgentEvent event{EventType::ANOMALY_DETECTED};
+                event.alert = anomaly;
+                eventRouter.publish(std::move(event));
             }
             
-            for (const auto& anomaly : system_anomalies) {
-                logger.logAlert(anomaly.type, anomaly.severity, anomaly.message, anomaly.details);
-                std::cout << "[ALERT] " << anomaly.severity << ": " << anomaly.message << std::endl;
+            // Stats go out every cycle; each route decides how many of them it keeps
+            AgentEvent system_event{EventType::SYSTEM_STATS};
+            system_event.system = system_stats;
+            eventRouter.publish(std::move(system_event));
+            for (const auto& iface : interface_stats) {
+                AgentEvent event{EventType::INTERFACE_STATS};
+                event.interface_stats = iface;
+                eventRouter.publish(std::move(event));
             }
+            for (const auto& process : current_processes) {
+                if (process.has_io_stats) {
+                    AgentEvent event{EventType::PROCESS_IO};
+                    event.process = process;
+                    eventRouter.publish(std::move(event));
+                }
+            }
+            for (const auto& group : cgroup_stats) {
+                if (group.process_count > 0 || group.pids_current > 0) {
+                    AgentEvent event{EventType::CGROUP_STATS};
+                    event.cgroup = group;
+                    eventRouter.publish(std::move(event));
+                }
+            }
+            for (const auto& thread : processMonitor.getThreads()) {
+                AgentEvent event{EventType::THREAD_STATS};
+                event.thread = thread;
+                eventRouter.publish(std::move(event));
+            }
+            eventRouter.flush();
+            
+            metricsServer.publish(renderMetrics(system_stats, current_processes.size(), current_connections.size(),
+                                                interface_stats, disk_devices, mount_usage, cgroup_stats,
+                                                processTree, eventCounters, eventRouter.status(), governor,
+                                                anomalyDetector.suppressedAlerts(), metricsServer.scrapeCount()));
+            snapshotEncoder.write(current_processes, current_connections);
             
-            // Log system statistics every 10 cycles (approximately every 10 seconds)
-            auto current_time = std::chrono::steady_clock::now();
-            if (std::chrono::duration_cast<std::chrono::seconds>(current_time - last_stats_time).count() >= 10) {
-                logger.logSystemStats(system_stats);
-                last_stats_time = current_time;
-                
-                std::cout << "[STATS] CPU: " << system_stats.cpu_usage << "%, "
-                         << "Memory: " << system_stats.memory_usage << "%, "
-                         << "Load: " << system_stats.load_average << std::endl;
+            if (++cycle_count % STATE_CHECKPOINT_CYCLES == 0) {
+                saveAgentState(processMonitor, networkMonitor, anomalyDetector);
             }
             
             // Display monitoring summary every 100 cycles
-            if (++cycle_count % 100 == 0) {
+            if (cycle_count % 100 == 0) {
                 std::cout << "\n--- Monitoring Summary ---" << std::endl;
                 std::cout << "Active processes: " << current_processes.size() << std::endl;
                 std::cout << "Active connections: " << current_connections.size() << std::endl;
                 std::cout << "System CPU: " << system_stats.cpu_usage << "%" << std::endl;
                 std::cout << "System Memory: " << system_stats.memory_usage << "%" << std::endl;
+                for (const auto& service : processTree.largestSubtrees(1, 3)) {
+                    std::cout << "Top service: " << service.name << " (PID: " << service.pid << ", " 
+                             << service.process_count << " processes, CPU " << service.cpu_usage << "%, " 
+                             << service.memory_usage << " KB)" << std::endl;
+                }
+                for (const auto& talker : SocketStatsCollector::topTalkers(socket_stats, 3)) {
+                    std::cout << "Top talker: " << talker.local_ip << ":" << talker.local_port << " -> "
+                             << talker.remote_ip << ":" << talker.remote_port << " (tx " 
+                             << static_cast<long>(talker.send_rate) << " B/s, rx " 
+                             << static_cast<long>(talker.receive_rate) << " B/s)" << std::endl;
+                }
                 std::cout << "------------------------\n" << std::endl;
             }
             
-            // Sleep for monitoring interval (1 second)
+            // Sleep for the rest of the monitoring interval
             auto end_time = std::chrono::steady_clock::now();
             auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
-            auto sleep_time = std::chrono::milliseconds(1000) - elapsed;
+            auto sleep_time = std::chrono::milliseconds(governor.intervalMs(config.monitor_interval_ms)) - elapsed;
             
             if (sleep_time > std::chrono::milliseconds(0)) {
                 PlatformUtils::sleepMs(sleep_time.count());
@@ -170,6 +519,10 @@ int main(int argc, char* argv[]) {
     }
     
     // Cleanup
+    saveAgentState(processMonitor, networkMonitor, anomalyDetector);
+    configManager.stop();
+    processWatcher.stop();
+    eventRouter.stop();
     logger.flushLogs();
     std::cout << "SentinelTrack agent stopped." << std::endl;
     
@@ -0,0 +1,105 @@
+// Suspicious-port and known-process lookups against the paths they
+// replaced: a vector of ports and a list of patterns rebuilt and scanned
+// on every call. Both must give the same answers; the rates are
+// informational.
+#include "../include/AnomalyDetector.h"
+#include "../include/PortBitmap.h"
+#include "../include/PatternMatcher.h"
+#include <cstdio>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <iterator>
+
+static const int PORT_LOOKUPS = 20000000;
+static const int NAME_LOOKUPS = 5000000;
+
+// As AnomalyDetector::isSuspiciousPort was before the bitmap
+static bool oldIsSuspiciousPort(int port) {
+    std::vector<int> suspicious_ports = {
+        4444, 5555, 6666, 7777, 8888, 9999,
+        1234, 12345, 54321,
+        31337, 1337,
+        6667, 6668, 6669,
+        8080, 8888, 9000, 9001
+    };
+    return std::find(suspicious_ports.begin(), suspicious_ports.end(), port) != suspicious_ports.end();
+}
+
+// The common system process patterns of AnomalyDetector.cpp
+static const char* const common_process_patterns[] = {
+    "init", "kthreadd", "ksoftirqd", "systemd", "bash", "sh", "ssh", "sshd",
+    "dbus", "networkd", "resolved", "cron", "rsyslog", "kernel", "migration"
+};
+
+// As the known-process check matched them before the automaton
+static bool oldMatchesCommonProcess(const std::string& name) {
+    std::vector<std::string> common_processes(std::begin(common_process_patterns), std::end(common_process_patterns));
+    for (const auto& known : common_processes) {
+        if (name.find(known) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static double seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    const PortBitmap& ports = AnomalyDetector::defaultSuspiciousPorts();
+    PatternMatcher matcher;
+    for (const char* pattern : common_process_patterns) {
+        matcher.addPattern(pattern);
+    }
+    matcher.build();
+
+    for (int port = -1; port <= 65536; port++) {
+        if (ports.contains(port) != oldIsSuspiciousPort(port)) {
+            std::fprintf(stderr, "lookup_bench: port %d differs from the old lookup\n", port);
+            return 1;
+        }
+    }
+    const std::vector<std::string> names = {
+        "postgres", "nginx", "kworker/0:1", "systemd-journald", "python3", "java", "containerd",
+        "node", "chrome", "redis-server", "sshd", "zsh", "cron", "migration/3", "rsyslogd", ""
+    };
+    for (const auto& name : names) {
+        if (matcher.matchesAny(name) != oldMatchesCommonProcess(name)) {
+            std::fprintf(stderr, "lookup_bench: '%s' differs from the old match\n", name.c_str());
+            return 1;
+        }
+    }
+
+    // Ports spread over the whole range; volatile keeps the loops honest
+    volatile long hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < PORT_LOOKUPS; i++) {
+        hits = hits + ports.contains(static_cast<int>((static_cast<unsigned>(i) * 7919u) & 0xffff));
+    }
+    double bitmap_rate = PORT_LOOKUPS / seconds(start) / 1e6;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < PORT_LOOKUPS; i++) {
+        hits = hits + oldIsSuspiciousPort(static_cast<int>((static_cast<unsigned>(i) * 7919u) & 0xffff));
+    }
+    double vector_rate = PORT_LOOKUPS / seconds(start) / 1e6;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < NAME_LOOKUPS; i++) {
+        hits = hits + matcher.matchesAny(names[i % names.size()]);
+    }
+    double matcher_rate = NAME_LOOKUPS / seconds(start) / 1e6;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < NAME_LOOKUPS; i++) {
+        hits = hits + oldMatchesCommonProcess(names[i % names.size()]);
+    }
+    double find_rate = NAME_LOOKUPS / seconds(start) / 1e6;
+
+    std::printf("port lookups:  bitmap %.0fM/s, vector + find %.0fM/s\n", bitmap_rate, vector_rate);
+    std::printf("name matches:  automaton %.0fM/s, per-pattern find %.1fM/s\n", matcher_rate, find_rate);
+    return 0;
+}
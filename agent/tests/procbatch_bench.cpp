@@ -0,0 +1,188 @@
+// ProcFileBatch with io_uring against plain system calls, on a fake procfs
+// of N pids in a temporary directory (default 20000) or on a real one:
+//   procbatch_bench [pid count | procfs root] [rounds]
+// Both paths must return the same files; the timings are informational.
+#include "../include/ProcFileBatch.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+#if defined(PLATFORM_WINDOWS) || defined(PLATFORM_MACOS)
+int main() {
+    std::printf("procbatch_bench: skipped, procfs and io_uring are Linux only\n");
+    return 0;
+}
+#else
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+
+static const int DEFAULT_PIDS = 20000;
+static const int DEFAULT_ROUNDS = 5;
+
+static double cpuMilliseconds() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0 +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+}
+
+// <root>/<pid>/stat for pids 1..count, shaped like the real thing. Every
+// hundredth pid has no stat file, as if it exited between listing and read.
+static bool buildFakeProcfs(const std::string& root, int count, std::vector<int>& pids) {
+    char line[512];
+    for (int pid = 1; pid <= count; pid++) {
+        std::string dir = root + "/" + std::to_string(pid);
+        if (mkdir(dir.c_str(), 0755) != 0) {
+            return false;
+        }
+        pids.push_back(pid);
+        if (pid % 100 == 0) {
+            continue;
+        }
+        int length = std::snprintf(line, sizeof(line),
+                                   "%d (worker%d) S %d %d %d 0 -1 4194560 %d 0 0 0 %d %d 0 0 20 0 1 0 %d "
+                                   "%d %d 18446744073709551615 1 1 0 0 0 0 0 0 0 0 0 0 17 %d 0 0 0 0 0\n",
+                                   pid, pid % 200, 1 + pid % 50, pid, pid, pid * 7, pid % 977, pid % 311,
+                                   100 + pid, 1000000 + pid % 50000 * 4096, 200 + pid % 5000, pid % 4);
+        FILE* file = std::fopen((dir + "/stat").c_str(), "w");
+        if (file == nullptr) {
+            return false;
+        }
+        std::fwrite(line, 1, static_cast<size_t>(length), file);
+        std::fclose(file);
+    }
+    return true;
+}
+
+static void removeFakeProcfs(const std::string& root, const std::vector<int>& pids) {
+    for (int pid : pids) {
+        std::string dir = root + "/" + std::to_string(pid);
+        unlink((dir + "/stat").c_str());
+        rmdir(dir.c_str());
+    }
+    rmdir(root.c_str());
+}
+
+static void listPids(const std::string& root, std::vector<int>& pids) {
+    DIR* dir = opendir(root.c_str());
+    if (dir == nullptr) {
+        return;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (std::isdigit(static_cast<unsigned char>(entry->d_name[0]))) {
+            pids.push_back(std::atoi(entry->d_name));
+        }
+    }
+    closedir(dir);
+    std::sort(pids.begin(), pids.end());
+}
+
+// One scan's worth of stat files, window by window; -1 marks an unreadable one
+static void scan(ProcFileBatch& batch, const std::vector<int>& pids, std::vector<std::string>& files) {
+    std::vector<int> window;
+    files.assign(pids.size(), std::string());
+    for (size_t first = 0; first < pids.size(); first += ProcFileBatch::WINDOW) {
+        size_t last = std::min(first + ProcFileBatch::WINDOW, pids.size());
+        window.assign(pids.begin() + first, pids.begin() + last);
+        batch.read(window, "stat");
+        for (size_t i = first; i < last; i++) {
+            const char* data = nullptr;
+            size_t size = 0;
+            if (batch.find(pids[i], data, size)) {
+                files[i].assign(data, size);
+            } else {
+                files[i] = "-1";
+            }
+        }
+    }
+}
+
+static void timeScans(ProcFileBatch& batch, const std::vector<int>& pids, int rounds, std::vector<std::string>& files,
+                      double& wall_ms, double& cpu_ms) {
+    scan(batch, pids, files);   // Warm the dentry cache
+    double cpu_start = cpuMilliseconds();
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        scan(batch, pids, files);
+    }
+    wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / rounds;
+    cpu_ms = (cpuMilliseconds() - cpu_start) / rounds;
+}
+
+int main(int argc, char** argv) {
+    std::string root;
+    std::vector<int> pids;
+    bool fake = argc < 2 || std::isdigit(static_cast<unsigned char>(argv[1][0]));
+    int rounds = argc > 2 ? std::atoi(argv[2]) : DEFAULT_ROUNDS;
+    if (rounds < 1) {
+        rounds = 1;
+    }
+
+    if (fake) {
+        int count = argc > 1 ? std::atoi(argv[1]) : DEFAULT_PIDS;
+        char pattern[] = "/tmp/procbatch_bench.XXXXXX";
+        if (mkdtemp(pattern) == nullptr) {
+            std::perror("procbatch_bench: mkdtemp");
+            return 1;
+        }
+        root = pattern;
+        if (!buildFakeProcfs(root, count, pids)) {
+            std::perror("procbatch_bench: building the fake procfs");
+            removeFakeProcfs(root, pids);
+            return 1;
+        }
+    } else {
+        root = argv[1];
+        listPids(root, pids);
+    }
+
+    ProcFileBatch sync_batch(root);
+    ProcFileBatch ring_batch(root);
+    sync_batch.enableRing(false);
+    bool ring = ring_batch.enableRing(true);
+
+    std::vector<std::string> sync_files;
+    std::vector<std::string> ring_files;
+    double sync_ms = 0.0;
+    double sync_cpu_ms = 0.0;
+    double ring_ms = 0.0;
+    double ring_cpu_ms = 0.0;
+    timeScans(sync_batch, pids, rounds, sync_files, sync_ms, sync_cpu_ms);
+    if (ring) {
+        timeScans(ring_batch, pids, rounds, ring_files, ring_ms, ring_cpu_ms);
+    }
+    if (fake) {
+        removeFakeProcfs(root, pids);
+    }
+
+    size_t readable = 0;
+    for (const auto& file : sync_files) {
+        if (file != "-1") {
+            readable++;
+        }
+    }
+    std::printf("%s procfs, %zu pids (%zu readable), %d rounds\n", fake ? "fake" : root.c_str(), pids.size(), readable, rounds);
+    std::printf("sync:     %.2f ms/scan, %.2f ms CPU\n", sync_ms, sync_cpu_ms);
+    if (!ring) {
+        std::printf("io_uring: unavailable here, only the sync path was timed\n");
+        return 0;
+    }
+    std::printf("io_uring: %.2f ms/scan, %.2f ms CPU%s\n", ring_ms, ring_cpu_ms,
+                ring_batch.ringEnabled() ? "" : " (fell back to sync during the run)");
+
+    // A real procfs changes between the two passes; only a fake one must match exactly
+    if (fake && ring_files != sync_files) {
+        std::fprintf(stderr, "procbatch_bench: io_uring and sync reads returned different files\n");
+        return 1;
+    }
+    return 0;
+}
+#endif
@@ -0,0 +1,173 @@
+// Snapshot stream size against JSON lines for one minute of a synthetic
+// host, with every message decoded by SnapshotDecoder and checked against
+// the tables that produced it.
+#include "../include/SnapshotEncoder.h"
+#include "../include/SnapshotDecoder.h"
+#include "../include/SnapshotFormat.h"
+#include "../include/EventSink.h"
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+static const int CYCLES = 60;             // One a second: a minute of stream
+static const int PROCESSES = 5000;
+static const int CONNECTIONS = 2000;
+static const int RESTARTS_PER_CYCLE = 25;
+static const int RECONNECTS_PER_CYCLE = 20;
+
+// What JsonLinesSink writes for a full dump of both tables
+static size_t jsonLinesSize(const std::vector<ProcessInfo>& processes, const std::vector<NetworkConnection>& connections) {
+    const size_t wrapper = std::strlen("{\"timestamp\":\"2026-01-01 00:00:00\",\"time_ns\":1700000000000000000,"
+                                       "\"type\":\"\",\"data\":}\n");
+    size_t size = 0;
+    AgentEvent event{EventType::PROCESS_STARTED};
+    for (const auto& process : processes) {
+        event.process = process;
+        size += wrapper + std::strlen(EventSink::typeName(event.type)) + EventSink::toJson(event).size();
+    }
+    event.type = EventType::NETWORK_CONNECTION;
+    for (const auto& connection : connections) {
+        event.connection = connection;
+        size += wrapper + std::strlen(EventSink::typeName(event.type)) + EventSink::toJson(event).size();
+    }
+    return size;
+}
+
+static std::string connectionKey(const NetworkConnection& connection) {
+    return connection.protocol + " " + connection.local_ip + ":" + std::to_string(connection.local_port) + " " +
+           connection.remote_ip + ":" + std::to_string(connection.remote_port);
+}
+
+// Every field the stream carries; CPU travels in hundredths of a percent
+static bool sameTables(std::vector<ProcessInfo> processes, std::vector<ProcessInfo> decoded_processes,
+                       std::vector<NetworkConnection> connections, std::vector<NetworkConnection> decoded_connections) {
+    auto byPid = [](const ProcessInfo& a, const ProcessInfo& b) { return a.pid < b.pid; };
+    std::sort(processes.begin(), processes.end(), byPid);
+    std::sort(decoded_processes.begin(), decoded_processes.end(), byPid);
+    if (processes.size() != decoded_processes.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < processes.size(); i++) {
+        const ProcessInfo& a = processes[i];
+        const ProcessInfo& b = decoded_processes[i];
+        if (a.pid != b.pid || a.start_ticks != b.start_ticks || a.parent_pid != b.parent_pid || a.name != b.name ||
+            a.command != b.command || a.state != b.state || a.memory_usage != b.memory_usage || a.uid != b.uid ||
+            std::llround(a.cpu_usage * 100) != std::llround(b.cpu_usage * 100)) {
+            return false;
+        }
+    }
+
+    auto byKey = [](const NetworkConnection& a, const NetworkConnection& b) { return connectionKey(a) < connectionKey(b); };
+    std::sort(connections.begin(), connections.end(), byKey);
+    std::sort(decoded_connections.begin(), decoded_connections.end(), byKey);
+    if (connections.size() != decoded_connections.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < connections.size(); i++) {
+        const NetworkConnection& a = connections[i];
+        const NetworkConnection& b = decoded_connections[i];
+        if (connectionKey(a) != connectionKey(b) || a.state != b.state || a.pid != b.pid || a.process_name != b.process_name) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::mt19937 random(1);
+    int next_pid = 1000;
+
+    std::vector<ProcessInfo> processes;
+    for (int i = 0; i < PROCESSES; i++) {
+        ProcessInfo process{};
+        process.pid = next_pid++;
+        process.start_ticks = 100 + i;
+        process.parent_pid = 1 + i % 50;
+        process.name = "worker" + std::to_string(i % 200);
+        process.command = "/usr/bin/" + process.name + " --config /etc/app/" + std::to_string(i % 40) + ".conf";
+        process.state = "S";
+        process.cpu_usage = (random() % 500) / 100.0;
+        process.memory_usage = 10000 + random() % 500000;
+        process.uid = 1000 + i % 10;
+        processes.push_back(process);
+    }
+    std::vector<NetworkConnection> connections;
+    for (int i = 0; i < CONNECTIONS; i++) {
+        NetworkConnection connection;
+        connection.protocol = "TCP";
+        connection.local_ip = "10.0.0.5";
+        connection.local_port = 443;
+        connection.remote_ip = "10.1." + std::to_string(i / 250) + "." + std::to_string(i % 250);
+        connection.remote_port = 30000 + i;
+        connection.state = "ESTABLISHED";
+        connection.pid = processes[i].pid;
+        connection.process_name = processes[i].name;
+        connections.push_back(connection);
+    }
+
+    SnapshotEncoder encoder;
+    SnapshotDecoder decoder;
+    std::string message;
+    size_t stream_bytes = SnapshotFormat::MAGIC_SIZE;
+    size_t keyframe_bytes = 0;
+    size_t json_bytes = 0;
+    double encode_ms = 0.0;
+
+    for (int cycle = 0; cycle < CYCLES; cycle++) {
+        // 10% of CPU and 20% of memory figures move, a few processes
+        // restart under new pids and a few connections are replaced
+        if (cycle > 0) {
+            for (auto& process : processes) {
+                if (random() % 10 == 0) {
+                    process.cpu_usage = (random() % 500) / 100.0;
+                }
+                if (random() % 5 == 0) {
+                    process.memory_usage += static_cast<long>(random() % 200) - 100;
+                }
+            }
+            for (int i = 0; i < RESTARTS_PER_CYCLE; i++) {
+                ProcessInfo& process = processes[random() % processes.size()];
+                process.pid = next_pid++;
+                process.start_ticks += 100000;
+            }
+            for (int i = 0; i < RECONNECTS_PER_CYCLE; i++) {
+                connections[random() % connections.size()].remote_port = 1024 + random() % 60000;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        encoder.encode(processes, connections, 1700000000000ULL + cycle * 1000ULL, message);
+        encode_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::string prefix;
+        SnapshotFormat::putVarint(prefix, message.size());
+        stream_bytes += prefix.size() + message.size();
+        if (cycle == 0) {
+            keyframe_bytes = message.size();
+        }
+        json_bytes += jsonLinesSize(processes, connections);
+
+        if (!decoder.decode(message) ||
+            !sameTables(processes, decoder.processes(), connections, decoder.connections())) {
+            std::fprintf(stderr, "snapshot_bench: cycle %d does not decode to the tables it was encoded from\n", cycle);
+            return 1;
+        }
+    }
+
+    // A delta is useless without its predecessor and must be refused
+    SnapshotDecoder late_decoder;
+    encoder.encode(processes, connections, 1700000000000ULL + CYCLES * 1000ULL, message);
+    if (late_decoder.decode(message)) {
+        std::fprintf(stderr, "snapshot_bench: a delta was accepted without its keyframe\n");
+        return 1;
+    }
+
+    std::printf("%d processes, %d connections, %d cycles; keyframe %zu B, encode %.2f ms/cycle\n",
+                PROCESSES, CONNECTIONS, CYCLES, keyframe_bytes, encode_ms / CYCLES);
+    std::printf("bytes per host per minute: snapshot stream %zu, JSON lines %zu (%.0fx)\n",
+                stream_bytes, json_bytes, static_cast<double>(json_bytes) / stream_bytes);
+    return 0;
+}
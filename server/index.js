@@ -5,6 +5,7 @@ import { WebSocketServer } from 'ws';
 import { fileURLToPath } from 'url';
 import { dirname, join } from 'path';
 import fs from 'fs';
+import net from 'net';
 
 const __filename = fileURLToPath(import.meta.url);
 const __dirname = dirname(__filename);
@@ -210,4 +211,46 @@ export const broadcastUpdate = (type, data) => {
   });
 };
 
+// Live events from the agent over its Unix socket: each frame is a 4-byte
+// big-endian length followed by a JSON {type, data} object
+const eventSocketPath = join(__dirname, '../data/events.sock');
+
+const connectAgentEvents = (retryDelay = 1000) => {
+  const socket = net.createConnection(eventSocketPath);
+  let buffered = Buffer.alloc(0);
+
+  socket.on('connect', () => {
+    console.log('Connected to agent event stream');
+    retryDelay = 1000;
+  });
+
+  socket.on('data', (chunk) => {
+    buffered = buffered.length ? Buffer.concat([buffered, chunk]) : chunk;
+    let offset = 0;
+    while (buffered.length - offset >= 4) {
+      const length = buffered.readUInt32BE(offset);
+      if (buffered.length - offset - 4 < length) break;
+      try {
+        const event = JSON.parse(buffered.toString('utf8', offset + 4, offset + 4 + length));
+        if (event.type === 'dropped') {
+          console.warn(`Agent dropped ${event.data.events} events for this server`);
+        }
+        broadcastUpdate(event.type, event.data);
+      } catch (error) {
+        console.error('Malformed agent event:', error.message);
+      }
+      offset += 4 + length;
+    }
+    buffered = buffered.subarray(offset);
+  });
+
+  // The agent may not be running yet or may restart; retry with backoff
+  socket.on('error', () => {});
+  socket.on('close', () => {
+    setTimeout(() => connectAgentEvents(Math.min(retryDelay * 2, 30000)), retryDelay);
+  });
+};
+
+connectAgentEvents();
+
 console.log('SentinelTrack API Server initialized');
\ No newline at end of file